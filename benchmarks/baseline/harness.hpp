@@ -0,0 +1,169 @@
+// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// shared workloads and timing for the baseline comparison:
+// the same two machines are implemented once per idiom (hfsm, switch, virtual, variant),
+// each idiom in its own executable so that code size can be compared as well
+//
+// every implementation has to leave the same trace in Context::sum,
+// the reported checksums of all idioms must match
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace hfsm {
+namespace baseline {
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Context {
+	std::uint64_t sum;
+	unsigned cycleCount;
+	bool hold;			// no transitions while set
+};
+
+struct Tick {
+	unsigned value;
+};
+
+//------------------------------------------------------------------------------
+// streetlight (basic_streetlight, looping back from Off)
+//
+// Root
+//  ├ On                   1
+//  │  ├ Red               2  -> YellowDownwards, or Off after 3 cycles
+//  │  ├ YellowDownwards   3  -> Green
+//  │  ├ YellowUpwards     4  -> Red
+//  │  └ Green             5  -> YellowUpwards
+//  └ Off                  6  -> On
+//
+// synthetic (100 states)
+//
+// Root
+//  ├ Region<0>          100
+//  │  ├ Leaf<0, 0>        1  -> Leaf<0, 1>
+//  │  ├ ..
+//  │  └ Leaf<0, 9>       10  -> Leaf<1, 0>
+//  ├ ..
+//  └ Region<8>          108
+//     ├ ..
+//     └ Leaf<8, 9>       90  -> Leaf<0, 0>
+//
+// every state adds (id << 8) on enter, leaves add id on update and value * id on react;
+// On also resets cycleCount on enter, Red increments it
+
+enum : unsigned {
+	STREETLIGHT_ON = 1,
+	STREETLIGHT_RED,
+	STREETLIGHT_YELLOW_DOWNWARDS,
+	STREETLIGHT_YELLOW_UPWARDS,
+	STREETLIGHT_GREEN,
+	STREETLIGHT_OFF,
+
+	SYNTHETIC_REGIONS = 9,
+	SYNTHETIC_LEAVES  = 10,
+	SYNTHETIC_REGION  = 100,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// keeps the optimizer from folding the measured loops
+inline void
+clobber() {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : : "memory");
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+struct Result {
+	double update;		// ns / update() without transitions
+	double react;		// ns / react()
+	double transition;	// ns / update() with a transition
+	std::size_t footprint;	// sizeof(machine), states allocated elsewhere not included
+	std::uint64_t checksum;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TMachine>
+Result
+measure(const unsigned calls) {
+	using Clock = std::chrono::steady_clock;
+
+	const auto nanoseconds = [calls](const Clock::time_point begin) {
+		return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / calls;
+	};
+
+	Context context{};
+	context.hold = true;
+
+	TMachine machine(context);
+
+	Result result{};
+	result.footprint = sizeof(TMachine);
+
+	auto begin = Clock::now();
+	for (unsigned i = 0; i < calls; ++i) {
+		machine.update();
+		clobber();
+	}
+	result.update = nanoseconds(begin);
+
+	begin = Clock::now();
+	for (unsigned i = 0; i < calls; ++i) {
+		machine.react(Tick{ i & 0xFF });
+		clobber();
+	}
+	result.react = nanoseconds(begin);
+
+	context.hold = false;
+
+	begin = Clock::now();
+	for (unsigned i = 0; i < calls; ++i) {
+		machine.update();
+		clobber();
+	}
+	result.transition = nanoseconds(begin);
+
+	result.checksum = context.sum;
+
+	return result;
+}
+
+//------------------------------------------------------------------------------
+
+// usage: baseline_<idiom> [calls]
+template <typename TStreetlight, typename TSynthetic>
+int
+run(const char* const idiom, const int argc, char** const argv) {
+	const unsigned calls = argc > 1 ? (unsigned) std::strtoul(argv[1], nullptr, 10) : 1u << 22;
+	if (calls == 0)
+		return 1;
+
+	const auto report = [idiom](const char* const workload, const Result& result) {
+		std::printf("%-8s %-12s update %7.2f ns  react %7.2f ns  transition %7.2f ns  footprint %5zu B  checksum %016llx\n",
+					idiom,
+					workload,
+					result.update,
+					result.react,
+					result.transition,
+					result.footprint,
+					(unsigned long long) result.checksum);
+	};
+
+	report("streetlight", measure<TStreetlight>(calls));
+	report("synthetic",   measure<TSynthetic>(calls));
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
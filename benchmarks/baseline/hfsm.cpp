@@ -0,0 +1,171 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// baseline comparison: HFSM
+
+#include <hfsm/machine_single.hpp>
+
+#include "harness.hpp"
+
+#include <utility>
+
+using namespace hfsm::baseline;
+
+using M = hfsm::Machine<Context>;
+
+////////////////////////////////////////////////////////////////////////////////
+// streetlight
+
+template <unsigned TID>
+struct Light
+	: M::Base
+{
+	enum : unsigned { ID = TID };
+
+	void enter(Context& context)							{ context.sum += ID << 8;				}
+	void update(Context& context)							{ context.sum += ID;					}
+	void react(const Tick& tick, Control&, Context& context)	{ context.sum += tick.value * ID;	}
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+struct Off;
+struct YellowDownwards;
+struct YellowUpwards;
+struct Green;
+
+struct On
+	: M::Base
+{
+	void enter(Context& context) {
+		context.cycleCount = 0;
+		context.sum += STREETLIGHT_ON << 8;
+	}
+};
+
+struct Red
+	: Light<STREETLIGHT_RED>
+{
+	void enter(Context& context) {
+		++context.cycleCount;
+		Light::enter(context);
+	}
+
+	void transition(Control& control, Context& context) {
+		if (context.hold)
+			return;
+
+		if (context.cycleCount > 3)
+			control.changeTo<Off>();
+		else
+			control.changeTo<YellowDownwards>();
+	}
+};
+
+struct YellowDownwards
+	: Light<STREETLIGHT_YELLOW_DOWNWARDS>
+{
+	void transition(Control& control, Context& context) {
+		if (!context.hold)
+			control.changeTo<Green>();
+	}
+};
+
+struct YellowUpwards
+	: Light<STREETLIGHT_YELLOW_UPWARDS>
+{
+	void transition(Control& control, Context& context) {
+		if (!context.hold)
+			control.changeTo<Red>();
+	}
+};
+
+struct Green
+	: Light<STREETLIGHT_GREEN>
+{
+	void transition(Control& control, Context& context) {
+		if (!context.hold)
+			control.changeTo<YellowUpwards>();
+	}
+};
+
+struct Off
+	: Light<STREETLIGHT_OFF>
+{
+	void transition(Control& control, Context& context) {
+		if (!context.hold)
+			control.changeTo<On>();
+	}
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+using Streetlight = M::PeerRoot<
+						M::Composite<On,
+							Red,
+							YellowDownwards,
+							YellowUpwards,
+							Green
+						>,
+						Off
+					>;
+
+////////////////////////////////////////////////////////////////////////////////
+// synthetic
+
+template <unsigned TR>
+struct Region
+	: M::Base
+{
+	void enter(Context& context)							{ context.sum += (SYNTHETIC_REGION + TR) << 8;	}
+};
+
+template <unsigned TR, unsigned TL>
+struct Leaf
+	: M::Base
+{
+	enum : unsigned {
+		ID	 = TR * SYNTHETIC_LEAVES + TL + 1,
+		NEXT = ID % (SYNTHETIC_REGIONS * SYNTHETIC_LEAVES),
+	};
+
+	void enter(Context& context)							{ context.sum += ID << 8;				}
+	void update(Context& context)							{ context.sum += ID;					}
+	void react(const Tick& tick, Control&, Context& context)	{ context.sum += tick.value * ID;	}
+
+	void transition(Control& control, Context& context) {
+		if (!context.hold)
+			control.changeTo<Leaf<NEXT / SYNTHETIC_LEAVES, NEXT % SYNTHETIC_LEAVES>>();
+	}
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <unsigned TR, typename = std::make_index_sequence<SYNTHETIC_LEAVES>>
+struct RegionT;
+
+template <unsigned TR, std::size_t... TLs>
+struct RegionT<TR, std::index_sequence<TLs...>> {
+	using Type = M::Composite<Region<TR>, Leaf<TR, TLs>...>;
+};
+
+template <typename = std::make_index_sequence<SYNTHETIC_REGIONS>>
+struct SyntheticT;
+
+template <std::size_t... TRs>
+struct SyntheticT<std::index_sequence<TRs...>> {
+	using Type = M::PeerRoot<typename RegionT<TRs>::Type...>;
+};
+
+using Synthetic = SyntheticT<>::Type;
+
+static_assert(Synthetic::StateCount == 100, "");
+
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+	return run<Streetlight, Synthetic>("hfsm", argc, argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
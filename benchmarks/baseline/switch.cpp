@@ -0,0 +1,248 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// baseline comparison: hand-written switch over a state enum
+
+#include "harness.hpp"
+
+using namespace hfsm::baseline;
+
+////////////////////////////////////////////////////////////////////////////////
+// streetlight
+
+class Streetlight {
+public:
+	Streetlight(Context& context)
+		: _context(context)
+	{
+		enterOn();
+		enter(STREETLIGHT_RED);
+	}
+
+	void update() {
+		switch (_state) {
+		case STREETLIGHT_RED:
+			_context.sum += STREETLIGHT_RED;
+
+			if (!_context.hold)
+				changeTo(_context.cycleCount > 3 ? STREETLIGHT_OFF : STREETLIGHT_YELLOW_DOWNWARDS);
+			break;
+
+		case STREETLIGHT_YELLOW_DOWNWARDS:
+			_context.sum += STREETLIGHT_YELLOW_DOWNWARDS;
+
+			if (!_context.hold)
+				changeTo(STREETLIGHT_GREEN);
+			break;
+
+		case STREETLIGHT_YELLOW_UPWARDS:
+			_context.sum += STREETLIGHT_YELLOW_UPWARDS;
+
+			if (!_context.hold)
+				changeTo(STREETLIGHT_RED);
+			break;
+
+		case STREETLIGHT_GREEN:
+			_context.sum += STREETLIGHT_GREEN;
+
+			if (!_context.hold)
+				changeTo(STREETLIGHT_YELLOW_UPWARDS);
+			break;
+
+		case STREETLIGHT_OFF:
+			_context.sum += STREETLIGHT_OFF;
+
+			if (!_context.hold) {
+				enterOn();
+				changeTo(STREETLIGHT_RED);
+			}
+			break;
+		}
+	}
+
+	void react(const Tick& tick) {
+		switch (_state) {
+		case STREETLIGHT_RED:
+			_context.sum += tick.value * STREETLIGHT_RED;
+			break;
+
+		case STREETLIGHT_YELLOW_DOWNWARDS:
+			_context.sum += tick.value * STREETLIGHT_YELLOW_DOWNWARDS;
+			break;
+
+		case STREETLIGHT_YELLOW_UPWARDS:
+			_context.sum += tick.value * STREETLIGHT_YELLOW_UPWARDS;
+			break;
+
+		case STREETLIGHT_GREEN:
+			_context.sum += tick.value * STREETLIGHT_GREEN;
+			break;
+
+		case STREETLIGHT_OFF:
+			_context.sum += tick.value * STREETLIGHT_OFF;
+			break;
+		}
+	}
+
+private:
+	void enterOn() {
+		_context.cycleCount = 0;
+		_context.sum += STREETLIGHT_ON << 8;
+	}
+
+	void changeTo(const unsigned state) {
+		enter(state);
+	}
+
+	void enter(const unsigned state) {
+		_state = state;
+
+		switch (state) {
+		case STREETLIGHT_RED:
+			++_context.cycleCount;
+			_context.sum += STREETLIGHT_RED << 8;
+			break;
+
+		case STREETLIGHT_YELLOW_DOWNWARDS:
+			_context.sum += STREETLIGHT_YELLOW_DOWNWARDS << 8;
+			break;
+
+		case STREETLIGHT_YELLOW_UPWARDS:
+			_context.sum += STREETLIGHT_YELLOW_UPWARDS << 8;
+			break;
+
+		case STREETLIGHT_GREEN:
+			_context.sum += STREETLIGHT_GREEN << 8;
+			break;
+
+		case STREETLIGHT_OFF:
+			_context.sum += STREETLIGHT_OFF << 8;
+			break;
+		}
+	}
+
+private:
+	Context& _context;
+	unsigned _state;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// synthetic
+//
+// 90 leaf cases per switch, spelled out by the preprocessor the way
+// a code generator would for a table this size
+
+#define SYNTHETIC_CASE(ID, CALL)		case ID: CALL(ID); break;
+
+#define SYNTHETIC_REGION_CASES(R, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  1, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  2, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  3, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  4, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  5, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  6, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  7, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  8, CALL)	\
+	SYNTHETIC_CASE(R * 10 +  9, CALL)	\
+	SYNTHETIC_CASE(R * 10 + 10, CALL)
+
+#define SYNTHETIC_CASES(CALL)			\
+	SYNTHETIC_REGION_CASES(0, CALL)		\
+	SYNTHETIC_REGION_CASES(1, CALL)		\
+	SYNTHETIC_REGION_CASES(2, CALL)		\
+	SYNTHETIC_REGION_CASES(3, CALL)		\
+	SYNTHETIC_REGION_CASES(4, CALL)		\
+	SYNTHETIC_REGION_CASES(5, CALL)		\
+	SYNTHETIC_REGION_CASES(6, CALL)		\
+	SYNTHETIC_REGION_CASES(7, CALL)		\
+	SYNTHETIC_REGION_CASES(8, CALL)
+
+#define SYNTHETIC_UPDATE(ID)			updateLeaf<ID>()
+#define SYNTHETIC_REACT(ID)				reactLeaf<ID>(tick)
+#define SYNTHETIC_ENTER(ID)				enterLeaf<ID>()
+
+static_assert(SYNTHETIC_REGIONS == 9 && SYNTHETIC_LEAVES == 10, "case tables need updating");
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+class Synthetic {
+public:
+	Synthetic(Context& context)
+		: _context(context)
+	{
+		enterRegion(0);
+		enter(1);
+	}
+
+	void update() {
+		switch (_state) {
+			SYNTHETIC_CASES(SYNTHETIC_UPDATE)
+		}
+	}
+
+	void react(const Tick& tick) {
+		switch (_state) {
+			SYNTHETIC_CASES(SYNTHETIC_REACT)
+		}
+	}
+
+private:
+	static unsigned regionOf(const unsigned state)	{ return (state - 1) / SYNTHETIC_LEAVES;	}
+
+	template <unsigned TID>
+	void updateLeaf() {
+		_context.sum += TID;
+
+		if (!_context.hold)
+			changeTo(TID % (SYNTHETIC_REGIONS * SYNTHETIC_LEAVES) + 1);
+	}
+
+	template <unsigned TID>
+	void reactLeaf(const Tick& tick) {
+		_context.sum += tick.value * TID;
+	}
+
+	template <unsigned TID>
+	void enterLeaf() {
+		_context.sum += TID << 8;
+	}
+
+	void enterRegion(const unsigned region) {
+		_context.sum += (SYNTHETIC_REGION + region) << 8;
+	}
+
+	void changeTo(const unsigned state) {
+		if (regionOf(state) != regionOf(_state))
+			enterRegion(regionOf(state));
+
+		enter(state);
+	}
+
+	void enter(const unsigned state) {
+		_state = state;
+
+		switch (state) {
+			SYNTHETIC_CASES(SYNTHETIC_ENTER)
+		}
+	}
+
+private:
+	Context& _context;
+	unsigned _state = 0;
+};
+
+#undef SYNTHETIC_CASE
+#undef SYNTHETIC_REGION_CASES
+#undef SYNTHETIC_CASES
+#undef SYNTHETIC_UPDATE
+#undef SYNTHETIC_REACT
+#undef SYNTHETIC_ENTER
+
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+	return run<Streetlight, Synthetic>("switch", argc, argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,249 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// baseline comparison: leaf states as alternatives of a std::variant, dispatched with std::visit,
+// parents tracked implicitly through the alternative index (c++17)
+
+#include "harness.hpp"
+
+#include <array>
+#include <utility>
+#include <variant>
+
+using namespace hfsm::baseline;
+
+////////////////////////////////////////////////////////////////////////////////
+
+enum : unsigned {
+	STAY = ~0u,
+};
+
+// std::visit() dispatch and emplace() by index shared by both machines
+template <typename TStates>
+class Machine {
+public:
+	Machine(Context& context)
+		: _context(context)
+	{}
+
+	void react(const Tick& tick) {
+		std::visit([this, &tick](auto& state) { state.react(tick, _context); }, _state);
+	}
+
+protected:
+	// index of the alternative to change to, STAY if none
+	unsigned updateActive() {
+		return std::visit([this](auto& state) { return state.update(_context); }, _state);
+	}
+
+	void emplace(const unsigned index) {
+		static constexpr auto table = emplaceTable(std::make_index_sequence<std::variant_size_v<TStates>>{});
+
+		table[index](*this);
+	}
+
+private:
+	template <std::size_t TI>
+	static void emplaceAt(Machine& machine) {
+		machine._state.template emplace<TI>().enter(machine._context);
+	}
+
+	template <std::size_t... TIs>
+	static constexpr auto emplaceTable(std::index_sequence<TIs...>) {
+		return std::array<void (*)(Machine&), sizeof...(TIs)>{ &emplaceAt<TIs>... };
+	}
+
+protected:
+	Context& _context;
+	TStates _state;
+};
+
+//------------------------------------------------------------------------------
+
+template <unsigned TID>
+struct Light {
+	static constexpr unsigned ID = TID;
+
+	void enter(Context& context)						{ context.sum += ID << 8;				}
+	void react(const Tick& tick, Context& context)		{ context.sum += tick.value * ID;		}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// streetlight
+
+struct Red
+	: Light<STREETLIGHT_RED>
+{
+	void enter(Context& context) {
+		++context.cycleCount;
+		Light::enter(context);
+	}
+
+	unsigned update(Context& context);
+};
+
+struct YellowDownwards
+	: Light<STREETLIGHT_YELLOW_DOWNWARDS>
+{
+	unsigned update(Context& context);
+};
+
+struct YellowUpwards
+	: Light<STREETLIGHT_YELLOW_UPWARDS>
+{
+	unsigned update(Context& context);
+};
+
+struct Green
+	: Light<STREETLIGHT_GREEN>
+{
+	unsigned update(Context& context);
+};
+
+struct Off
+	: Light<STREETLIGHT_OFF>
+{
+	unsigned update(Context& context);
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+using StreetlightStates = std::variant<Red, YellowDownwards, YellowUpwards, Green, Off>;
+
+class Streetlight
+	: public Machine<StreetlightStates>
+{
+	template <typename T, std::size_t... TIs>
+	static constexpr std::size_t find(std::index_sequence<TIs...>) {
+		return ((std::is_same_v<T, std::variant_alternative_t<TIs, StreetlightStates>> ? TIs : 0) + ...);
+	}
+
+public:
+	template <typename T>
+	static constexpr unsigned index = (unsigned) find<T>(std::make_index_sequence<std::variant_size_v<StreetlightStates>>{});
+
+	Streetlight(Context& context)
+		: Machine(context)
+	{
+		enterOn();
+		std::get<Red>(_state).enter(_context);
+	}
+
+	void update() {
+		const unsigned next = updateActive();
+		if (next == STAY)
+			return;
+
+		if (_state.index() == index<Off>)
+			enterOn();
+
+		emplace(next);
+	}
+
+private:
+	void enterOn() {
+		_context.cycleCount = 0;
+		_context.sum += STREETLIGHT_ON << 8;
+	}
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+unsigned
+Red::update(Context& context) {
+	context.sum += ID;
+
+	if (context.hold)
+		return STAY;
+
+	return context.cycleCount > 3 ? Streetlight::index<Off> : Streetlight::index<YellowDownwards>;
+}
+
+unsigned
+YellowDownwards::update(Context& context) {
+	context.sum += ID;
+
+	return context.hold ? STAY : Streetlight::index<Green>;
+}
+
+unsigned
+YellowUpwards::update(Context& context) {
+	context.sum += ID;
+
+	return context.hold ? STAY : Streetlight::index<Red>;
+}
+
+unsigned
+Green::update(Context& context) {
+	context.sum += ID;
+
+	return context.hold ? STAY : Streetlight::index<YellowUpwards>;
+}
+
+unsigned
+Off::update(Context& context) {
+	context.sum += ID;
+
+	return context.hold ? STAY : Streetlight::index<Red>;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// synthetic
+
+template <unsigned TI>
+struct Leaf
+	: Light<TI + 1>
+{
+	unsigned update(Context& context) {
+		context.sum += Light<TI + 1>::ID;
+
+		return context.hold ? STAY : (TI + 1) % (SYNTHETIC_REGIONS * SYNTHETIC_LEAVES);
+	}
+};
+
+template <typename = std::make_index_sequence<SYNTHETIC_REGIONS * SYNTHETIC_LEAVES>>
+struct LeavesT;
+
+template <std::size_t... TIs>
+struct LeavesT<std::index_sequence<TIs...>> {
+	using Type = std::variant<Leaf<TIs>...>;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+class Synthetic
+	: public Machine<LeavesT<>::Type>
+{
+public:
+	Synthetic(Context& context)
+		: Machine(context)
+	{
+		enterRegion(0);
+		std::get<0>(_state).enter(_context);
+	}
+
+	void update() {
+		const unsigned next = updateActive();
+		if (next == STAY)
+			return;
+
+		if (next / SYNTHETIC_LEAVES != _state.index() / SYNTHETIC_LEAVES)
+			enterRegion(next / SYNTHETIC_LEAVES);
+
+		emplace(next);
+	}
+
+private:
+	void enterRegion(const unsigned region) {
+		_context.sum += (SYNTHETIC_REGION + region) << 8;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+	return run<Streetlight, Synthetic>("variant", argc, argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
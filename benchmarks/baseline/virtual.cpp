@@ -0,0 +1,252 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// baseline comparison: State pattern, one object per state behind a virtual interface,
+// parents entered / left by walking the parent pointers up to the common ancestor
+
+#include "harness.hpp"
+
+using namespace hfsm::baseline;
+
+////////////////////////////////////////////////////////////////////////////////
+
+class State {
+public:
+	State(State* const parent_, const unsigned id_)
+		: parent(parent_)
+		, id(id_)
+	{}
+
+	virtual ~State() = default;
+
+	virtual void enter(Context& context)				{ context.sum += id << 8;				}
+	virtual void leave(Context&)						{}
+
+	// returns the state to change to, nullptr to stay
+	virtual State* update(Context&)						{ return nullptr;						}
+	virtual void react(const Tick&, Context&)			{}
+
+public:
+	State* const parent;
+	const unsigned id;
+};
+
+//------------------------------------------------------------------------------
+
+class Machine {
+public:
+	Machine(Context& context, State& initial)
+		: _context(context)
+	{
+		enter(&initial, nullptr);
+		_active = &initial;
+	}
+
+	void update() {
+		if (State* const next = _active->update(_context))
+			changeTo(next);
+	}
+
+	void react(const Tick& tick)						{ _active->react(tick, _context);		}
+
+private:
+	void changeTo(State* const next) {
+		State* const common = commonAncestor(_active, next);
+
+		for (State* state = _active; state != common; state = state->parent)
+			state->leave(_context);
+
+		enter(next, common);
+		_active = next;
+	}
+
+	void enter(State* const state, State* const common) {
+		if (state == common)
+			return;
+
+		enter(state->parent, common);
+		state->enter(_context);
+	}
+
+	static unsigned depth(const State* state) {
+		unsigned d = 0;
+		for (; state; state = state->parent)
+			++d;
+
+		return d;
+	}
+
+	static State* commonAncestor(State* lhs, State* rhs) {
+		unsigned lhsDepth = depth(lhs);
+		unsigned rhsDepth = depth(rhs);
+
+		for (; lhsDepth > rhsDepth; --lhsDepth)
+			lhs = lhs->parent;
+
+		for (; rhsDepth > lhsDepth; --rhsDepth)
+			rhs = rhs->parent;
+
+		// a state changing to itself is left and re-entered
+		if (lhs == rhs)
+			return lhs->parent;
+
+		while (lhs->parent != rhs->parent) {
+			lhs = lhs->parent;
+			rhs = rhs->parent;
+		}
+
+		return lhs->parent;
+	}
+
+private:
+	Context& _context;
+	State* _active = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// streetlight
+
+class Light
+	: public State
+{
+public:
+	Light(State* const parent_, const unsigned id_)
+		: State(parent_, id_)
+	{}
+
+	State* update(Context& context) override {
+		context.sum += id;
+
+		return context.hold ? nullptr : target;
+	}
+
+	void react(const Tick& tick, Context& context) override {
+		context.sum += tick.value * id;
+	}
+
+public:
+	State* target = nullptr;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+class On
+	: public State
+{
+public:
+	On()
+		: State(nullptr, STREETLIGHT_ON)
+	{}
+
+	void enter(Context& context) override {
+		context.cycleCount = 0;
+		State::enter(context);
+	}
+};
+
+class Red
+	: public Light
+{
+public:
+	Red(State* const parent_)
+		: Light(parent_, STREETLIGHT_RED)
+	{}
+
+	void enter(Context& context) override {
+		++context.cycleCount;
+		Light::enter(context);
+	}
+
+	State* update(Context& context) override {
+		context.sum += id;
+
+		if (context.hold)
+			return nullptr;
+
+		return context.cycleCount > 3 ? off : target;
+	}
+
+public:
+	State* off = nullptr;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+struct StreetlightStates {
+	StreetlightStates() {
+		red			   .target = &yellowDownwards;
+		red			   .off	   = &off;
+		yellowDownwards.target = &green;
+		green		   .target = &yellowUpwards;
+		yellowUpwards  .target = &red;
+		off			   .target = &red;
+	}
+
+	On on;
+	Red red{ &on };
+	Light yellowDownwards{ &on, STREETLIGHT_YELLOW_DOWNWARDS };
+	Light yellowUpwards	 { &on, STREETLIGHT_YELLOW_UPWARDS	 };
+	Light green			 { &on, STREETLIGHT_GREEN			 };
+	Light off			 { nullptr, STREETLIGHT_OFF			 };
+};
+
+class Streetlight
+	: StreetlightStates
+	, public Machine
+{
+public:
+	Streetlight(Context& context)
+		: Machine(context, red)
+	{}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// synthetic
+
+struct SyntheticStates {
+	enum : unsigned { LEAF_COUNT = SYNTHETIC_REGIONS * SYNTHETIC_LEAVES };
+
+	SyntheticStates() {
+		for (unsigned r = 0; r < SYNTHETIC_REGIONS; ++r)
+			regions[r] = new State(nullptr, SYNTHETIC_REGION + r);
+
+		for (unsigned i = 0; i < LEAF_COUNT; ++i)
+			leaves[i] = new Light(regions[i / SYNTHETIC_LEAVES], i + 1);
+
+		for (unsigned i = 0; i < LEAF_COUNT; ++i)
+			leaves[i]->target = leaves[(i + 1) % LEAF_COUNT];
+	}
+
+	~SyntheticStates() {
+		for (Light* leaf : leaves)
+			delete leaf;
+
+		for (State* region : regions)
+			delete region;
+	}
+
+	SyntheticStates(const SyntheticStates&) = delete;
+	SyntheticStates& operator = (const SyntheticStates&) = delete;
+
+	State* regions[SYNTHETIC_REGIONS];
+	Light* leaves[LEAF_COUNT];
+};
+
+class Synthetic
+	: SyntheticStates
+	, public Machine
+{
+public:
+	Synthetic(Context& context)
+		: Machine(context, *leaves[0])
+	{}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+	return run<Streetlight, Synthetic>("virtual", argc, argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,183 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// memory layout benchmark:
+// update a large population of large machines round-robin, so that every
+// machine comes in cold, and report ns and (on linux) cache misses / update
+
+// State structure (of each machine):
+//
+// Root (orthogonal)
+//  ├ Region<0> (composite)
+//  │  ├ Leaf<0, 0>
+//  │  ├ ..
+//  │  └ Leaf<0, 7>
+//  ├ ..
+//  └ Region<7>
+//     ├ ..
+//     └ Leaf<7, 7>
+
+#include <hfsm/machine_single.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+#ifdef __linux__
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+
+struct Context {
+	unsigned ticks;
+};
+
+using M = hfsm::Machine<Context>;
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <unsigned TRegion>
+struct Region
+	: M::Base
+{
+	void update(Context& context) {
+		++context.ticks;
+	}
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <unsigned TRegion, unsigned TLeaf>
+struct Leaf
+	: M::Base
+{
+	void update(Context& context) {
+		++context.ticks;
+	}
+
+	void transition(Control& control, Context& context) {
+		if (context.ticks % 7 == TLeaf)
+			control.changeTo<Leaf<TRegion, (TLeaf + 1) % 8>>();
+	}
+};
+
+//------------------------------------------------------------------------------
+
+template <unsigned TRegion>
+using RegionT = M::Composite<Region<TRegion>,
+							 Leaf<TRegion, 0>, Leaf<TRegion, 1>, Leaf<TRegion, 2>, Leaf<TRegion, 3>,
+							 Leaf<TRegion, 4>, Leaf<TRegion, 5>, Leaf<TRegion, 6>, Leaf<TRegion, 7>>;
+
+using Machine = M::OrthogonalPeerRoot<RegionT<0>, RegionT<1>, RegionT<2>, RegionT<3>,
+									  RegionT<4>, RegionT<5>, RegionT<6>, RegionT<7>>;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// hardware cache miss counter, reads 0 where unavailable
+class CacheMisses {
+public:
+	CacheMisses() {
+	#ifdef __linux__
+		perf_event_attr attr{};
+		attr.type			= PERF_TYPE_HARDWARE;
+		attr.size			= sizeof(attr);
+		attr.config			= PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled		= 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv		= 1;
+
+		_fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	#endif
+	}
+
+	~CacheMisses() {
+	#ifdef __linux__
+		if (_fd != -1)
+			close(_fd);
+	#endif
+	}
+
+	bool available() const								{ return _fd != -1;	}
+
+	void start() {
+	#ifdef __linux__
+		if (_fd != -1) {
+			ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	#endif
+	}
+
+	unsigned long long stop() {
+		unsigned long long count = 0;
+
+	#ifdef __linux__
+		if (_fd != -1) {
+			ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+
+			if (read(_fd, &count, sizeof(count)) != sizeof(count))
+				count = 0;
+		}
+	#endif
+
+		return count;
+	}
+
+private:
+	int _fd = -1;
+};
+
+//------------------------------------------------------------------------------
+
+int
+main() {
+	enum : unsigned {
+		MACHINES = 4 * 1024,
+		ROUNDS	 = 64,
+		UPDATES	 = MACHINES * ROUNDS,
+	};
+
+	std::unique_ptr<Context[]> contexts(new Context[MACHINES]());
+
+	// placement into raw storage, machines are neither copyable nor movable
+	// (aligned by hand, over-aligned 'new' needs c++17)
+	std::unique_ptr<char[]> storage(new char[sizeof(Machine) * MACHINES + alignof(Machine)]);
+	const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+	Machine* const machines = reinterpret_cast<Machine*>((address + alignof(Machine) - 1) / alignof(Machine) * alignof(Machine));
+
+	for (unsigned i = 0; i < MACHINES; ++i)
+		new (machines + i) Machine(contexts[i]);
+
+	CacheMisses cacheMisses;
+
+	const auto begin = std::chrono::high_resolution_clock::now();
+	cacheMisses.start();
+
+	for (unsigned r = 0; r < ROUNDS; ++r)
+		for (unsigned i = 0; i < MACHINES; ++i)
+			machines[i].update();
+
+	const auto misses = cacheMisses.stop();
+	const auto end = std::chrono::high_resolution_clock::now();
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+
+	std::printf("sizeof(Machine) %u, alignof(Machine) %u\n", (unsigned) sizeof(Machine), (unsigned) alignof(Machine));
+	std::printf("%6.2f ns / update\n", (double) ns / UPDATES);
+
+	if (cacheMisses.available())
+		std::printf("%6.2f cache misses / update\n", (double) misses / UPDATES);
+	else
+		std::printf("cache miss counter unavailable\n");
+
+	for (unsigned i = 0; i < MACHINES; ++i)
+		machines[i].~Machine();
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
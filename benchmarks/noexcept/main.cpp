@@ -0,0 +1,151 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// noexcept propagation benchmark:
+// cycle a streetlight-like machine, report ns / update
+//
+// build with and without HFSM_ENABLE_NOEXCEPT (and -fno-exceptions, then -fno-rtti on top),
+// then compare the printed timings and the binary sizes
+
+// State structure:
+//
+// Root
+//  ├ On
+//  │  ├ Red
+//  │  ├ Yellow
+//  │  └ Green
+//  └ Off
+
+#include <hfsm/machine_single.hpp>
+
+#include <chrono>
+#include <cstdio>
+
+//------------------------------------------------------------------------------
+
+struct Context {
+	unsigned ticks;
+	unsigned cycles;
+};
+
+using M = hfsm::Machine<Context>;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Off;
+
+struct On
+	: M::Base
+{
+	void enter(Context& context) noexcept {
+		++context.cycles;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	struct Yellow;
+
+	struct Red
+		: M::Base
+	{
+		void update(Context& context) noexcept {
+			++context.ticks;
+		}
+
+		void transition(Control& control, Context& context) noexcept {
+			if (context.ticks % 3 == 0)
+				control.changeTo<Yellow>();
+		}
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	struct Green;
+
+	struct Yellow
+		: M::Base
+	{
+		void update(Context& context) noexcept {
+			++context.ticks;
+		}
+
+		void transition(Control& control, Context&) noexcept {
+			control.changeTo<Green>();
+		}
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	struct Green
+		: M::Base
+	{
+		void update(Context& context) noexcept {
+			++context.ticks;
+		}
+
+		void transition(Control& control, Context& context) noexcept {
+			if (context.ticks % 5 == 0)
+				control.changeTo<Off>();
+		}
+	};
+};
+
+//------------------------------------------------------------------------------
+
+struct Off
+	: M::Base
+{
+	void transition(Control& control, Context&) noexcept {
+		control.changeTo<On>();
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+using Machine = M::PeerRoot<
+					M::Composite<On,
+						On::Red,
+						On::Yellow,
+						On::Green
+					>,
+					Off
+				>;
+
+#ifdef HFSM_ENABLE_NOEXCEPT
+static_assert(noexcept(std::declval<Machine&>().update()), "noexcept callbacks should propagate up to update()");
+#endif
+
+//------------------------------------------------------------------------------
+
+int
+main() {
+	enum : unsigned { UPDATES = 10 * 1000 * 1000 };
+
+	Context context{0, 0};
+	Machine machine(context);
+
+	const auto begin = std::chrono::high_resolution_clock::now();
+
+	for (unsigned i = 0; i < UPDATES; ++i)
+		machine.update();
+
+	const auto end = std::chrono::high_resolution_clock::now();
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+
+	std::printf("%-32s %6.2f ns / update (%u cycles)\n",
+#if defined HFSM_ENABLE_NOEXCEPT && !(defined __cpp_exceptions || defined __EXCEPTIONS || defined _CPPUNWIND) && !(defined __GXX_RTTI || defined _CPPRTTI)
+				"noexcept, no exceptions, no RTTI",
+#elif defined HFSM_ENABLE_NOEXCEPT && !(defined __cpp_exceptions || defined __EXCEPTIONS || defined _CPPUNWIND)
+				"noexcept, no exceptions",
+#elif defined HFSM_ENABLE_NOEXCEPT
+				"noexcept",
+#else
+				"baseline",
+#endif
+				(double) ns / UPDATES,
+				context.cycles);
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,208 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// event log replay benchmark:
+// record a synthetic log for a fleet of machines, replay it through the fleet
+// single- and multi-threaded, and report events / s
+//
+// usage: replay [log path [records]]
+
+// State structure (of each machine):
+//
+// Root
+//  ├ Idle
+//  ├ Moving
+//  └ Faulted
+
+#include <hfsm/machine_single.hpp>
+
+#include "replay.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+//------------------------------------------------------------------------------
+
+struct Context {
+	float speed;
+	unsigned faults;
+};
+
+using M = hfsm::Machine<Context>;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+struct Speed {
+	float value;
+};
+
+struct Fault {
+	std::uint32_t code;
+};
+
+struct Reset {};
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Moving;
+struct Faulted;
+
+struct Idle
+	: M::Base
+{
+	void react(const Speed& event, Control& control, Context& context) {
+		context.speed = event.value;
+
+		if (event.value > 0.0f)
+			control.changeTo<Moving>();
+	}
+
+	void react(const Fault&, Control& control, Context& context) {
+		++context.faults;
+		control.changeTo<Faulted>();
+	}
+
+	using M::Base::react;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+struct Moving
+	: M::Base
+{
+	void react(const Speed& event, Control& control, Context& context) {
+		context.speed = event.value;
+
+		if (event.value == 0.0f)
+			control.changeTo<Idle>();
+	}
+
+	void react(const Fault&, Control& control, Context& context) {
+		++context.faults;
+		control.changeTo<Faulted>();
+	}
+
+	using M::Base::react;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+struct Faulted
+	: M::Base
+{
+	void react(const Reset&, Control& control, Context&) {
+		control.changeTo<Idle>();
+	}
+
+	using M::Base::react;
+};
+
+//------------------------------------------------------------------------------
+
+using Machine = M::PeerRoot<Idle, Moving, Faulted>;
+
+using Codec = hfsm::replay::Codec<Machine, Speed, Fault, Reset>;
+using Driver = hfsm::replay::Driver<Machine, Codec>;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void
+record(const char* const path, const unsigned machines, const unsigned records) {
+	hfsm::replay::Writer writer(path);
+
+	unsigned random = 1;
+	for (unsigned i = 0; i < records; ++i) {
+		random = random * 1103515245u + 12345u;
+
+		const unsigned machine = (random >> 8) % machines;
+
+		switch (random >> 28) {
+		case 0:
+			writer.event(machine, Codec::id<Fault>(), Fault{ random & 0xFF });
+			break;
+
+		case 1:
+		case 2:
+			writer.event(machine, Codec::id<Reset>(), Reset{});
+			break;
+
+		case 3:
+		case 4:
+		case 5:
+			writer.update(machine);
+			break;
+
+		default:
+			writer.event(machine, Codec::id<Speed>(), Speed{ (float) (random >> 29) });
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+
+void
+report(const char* const label, const hfsm::replay::Stats& stats) {
+	std::printf("%-12s %10llu events %10llu updates %6llu skipped %8.3f s %12.0f / s\n",
+				label,
+				(unsigned long long) stats.events,
+				(unsigned long long) stats.updates,
+				(unsigned long long) stats.skipped,
+				stats.seconds,
+				stats.perSecond());
+}
+
+//------------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[]) {
+	enum : unsigned {
+		MACHINES = 1024,
+	};
+
+	const char* const path = argc > 1 ? argv[1] : "replay.log";
+	const unsigned records = argc > 2 ? (unsigned) std::atoi(argv[2]) : 4 * 1024 * 1024;
+
+	record(path, MACHINES, records);
+
+	const hfsm::replay::EventLog log(path);
+	if (!log.valid()) {
+		std::printf("can't open '%s'\n", path);
+		return 1;
+	}
+
+	const unsigned threads = std::thread::hardware_concurrency() > 1 ?
+		std::thread::hardware_concurrency() : 2;
+
+	const Codec codec;
+
+	for (unsigned pass = 0; pass < 2; ++pass) {
+		std::unique_ptr<Context[]> contexts(new Context[MACHINES]());
+
+		// placement into raw storage, machines are neither copyable nor movable
+		std::unique_ptr<char[]> storage(new char[sizeof(Machine) * MACHINES + alignof(Machine)]);
+		const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+		Machine* const machines = reinterpret_cast<Machine*>((address + alignof(Machine) - 1) / alignof(Machine) * alignof(Machine));
+
+		for (unsigned i = 0; i < MACHINES; ++i)
+			new (machines + i) Machine(contexts[i]);
+
+		const Driver driver(machines, MACHINES, codec);
+
+		if (pass == 0)
+			report("1 thread", driver.run(log));
+		else {
+			char label[16];
+			std::snprintf(label, sizeof(label), "%u threads", threads);
+			report(label, driver.run(log, threads));
+		}
+
+		for (unsigned i = 0; i < MACHINES; ++i)
+			machines[i].~Machine();
+	}
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,432 @@
+// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// offline replay of recorded event logs through a fleet of machines
+//
+// log format: a flat sequence of 8-byte aligned records,
+// each a Record header followed by 'size' bytes of event payload
+// (padded up to the next record); event id 0 stands for an update() tick
+//
+// payloads are handed to the machines in place, straight out of the mapping:
+// event types need to be trivially copyable, with an alignment of 8 or less
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#define HFSM_REPLAY_MMAP
+
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace hfsm {
+namespace replay {
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Record {
+	std::uint32_t machine;
+	std::uint16_t event;
+	std::uint16_t size;
+};
+static_assert(sizeof(Record) == 8, "");
+
+enum : std::uint16_t {
+	UPDATE = 0,
+};
+
+//------------------------------------------------------------------------------
+
+inline std::uint32_t
+padded(const std::uint32_t size) {
+	return (size + 7) & ~7u;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// appends records, for producing test logs
+class Writer {
+public:
+	Writer(const char* const path)
+		: _file(std::fopen(path, "wb"))
+	{}
+
+	~Writer()											{ if (_file) std::fclose(_file);	}
+
+	bool valid() const									{ return _file != nullptr;			}
+
+	void update(const std::uint32_t machine)			{ write(machine, UPDATE, nullptr, 0);	}
+
+	template <typename TEvent>
+	void event(const std::uint32_t machine, const std::uint16_t id, const TEvent& event) {
+		static_assert(std::is_trivially_copyable<TEvent>::value && alignof(TEvent) <= 8, "");
+
+		write(machine, id, &event, sizeof(TEvent));
+	}
+
+private:
+	void write(const std::uint32_t machine, const std::uint16_t event, const void* const payload, const std::uint16_t size) {
+		static const char zeroes[8] = {};
+
+		const Record record{ machine, event, size };
+		std::fwrite(&record, sizeof(record), 1, _file);
+		if (size)
+			std::fwrite(payload, 1, size, _file);
+		std::fwrite(zeroes, 1, padded(size) - size, _file);
+	}
+
+private:
+	std::FILE* const _file;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// read-only view of a whole log, mapped where mmap() is available, read in otherwise
+class EventLog {
+public:
+	EventLog(const char* const path) {
+	#ifdef HFSM_REPLAY_MMAP
+		const int fd = open(path, O_RDONLY);
+		if (fd == -1)
+			return;
+
+		struct stat info;
+		if (fstat(fd, &info) == 0 && info.st_size > 0) {
+			void* const mapping = mmap(nullptr, (std::size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (mapping != MAP_FAILED) {
+				_begin = static_cast<const char*>(mapping);
+				_end   = _begin + info.st_size;
+				_page  = (std::size_t) sysconf(_SC_PAGESIZE);
+			}
+		}
+
+		close(fd);
+	#else
+		if (std::FILE* const file = std::fopen(path, "rb")) {
+			std::fseek(file, 0, SEEK_END);
+			_buffer.resize((std::size_t) std::ftell(file) / 8);
+			std::fseek(file, 0, SEEK_SET);
+
+			if (std::fread(_buffer.data(), 8, _buffer.size(), file) == _buffer.size()) {
+				_begin = reinterpret_cast<const char*>(_buffer.data());
+				_end   = _begin + _buffer.size() * 8;
+			}
+
+			std::fclose(file);
+		}
+	#endif
+	}
+
+	~EventLog() {
+	#ifdef HFSM_REPLAY_MMAP
+		if (_begin)
+			munmap(const_cast<char*>(_begin), (std::size_t) (_end - _begin));
+	#endif
+	}
+
+	EventLog(const EventLog&) = delete;
+	EventLog& operator = (const EventLog&) = delete;
+
+	bool valid() const									{ return _begin != nullptr;		}
+
+	enum class Access {
+		Sequential,		// one pass front to back, pages dropped behind
+		Windowed,		// several passes over the same stretch, paged in and released explicitly
+	};
+
+	// readahead hints, no-ops without mmap()
+	// (none of them page in the whole log, which may well be larger than memory)
+
+	void advise(const Access access) const {
+	#ifdef HFSM_REPLAY_MMAP
+		if (_begin)
+			madvise(const_cast<char*>(_begin), (std::size_t) (_end - _begin),
+					access == Access::Sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+	#else
+		(void) access;
+	#endif
+	}
+
+	// start reading 'size' bytes from 'begin' on in ahead of use, up to the end of the log
+	void prefetch(const char* const begin, const std::size_t size) const {
+	#ifdef HFSM_REPLAY_MMAP
+		const std::size_t from = pageDown(begin);
+		const std::size_t to   = (std::size_t) (_end - begin) > size ?
+			(std::size_t) (begin - _begin) + size : (std::size_t) (_end - _begin);
+
+		if (_begin && from < to)
+			madvise(const_cast<char*>(_begin) + from, to - from, MADV_WILLNEED);
+	#else
+		(void) begin;
+		(void) size;
+	#endif
+	}
+
+	// [begin, end) won't be read again, only whole pages are let go
+	void release(const char* const begin, const char* const end) const {
+	#ifdef HFSM_REPLAY_MMAP
+		const std::size_t from = pageDown(begin + _page - 1);
+		const std::size_t to   = pageDown(end);
+
+		if (_begin && from < to)
+			madvise(const_cast<char*>(_begin) + from, to - from, MADV_DONTNEED);
+	#else
+		(void) begin;
+		(void) end;
+	#endif
+	}
+
+	const char* begin() const							{ return _begin;				}
+	const char* end() const								{ return _end;					}
+
+private:
+#ifdef HFSM_REPLAY_MMAP
+	std::size_t pageDown(const char* const at) const {
+		return at > _begin ? (std::size_t) (at - _begin) & ~(_page - 1) : 0;
+	}
+#endif
+
+private:
+	const char* _begin = nullptr;
+	const char* _end   = nullptr;
+
+#ifdef HFSM_REPLAY_MMAP
+	std::size_t _page = 4096;
+#else
+	std::vector<std::uint64_t> _buffer;
+#endif
+};
+
+//------------------------------------------------------------------------------
+
+// holds 'count' threads until all of them arrive,
+// the last one to do so runs 'complete' before letting the others go
+class Barrier {
+public:
+	Barrier(const unsigned count)
+		: _count(count)
+	{}
+
+	template <typename TFunction>
+	void arrive(TFunction&& complete) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		const std::uint64_t generation = _generation;
+
+		if (++_arrived == _count) {
+			complete();
+
+			_arrived = 0;
+			++_generation;
+			_released.notify_all();
+		}
+		else
+			_released.wait(lock, [this, generation] { return _generation != generation; });
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _released;
+	const unsigned _count;
+	unsigned _arrived = 0;
+	std::uint64_t _generation = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// maps event ids 1, 2, .. onto TEvents, in order
+template <typename TMachine, typename... TEvents>
+class Codec {
+	using Handler = void (*)(TMachine&, const void*);
+
+	template <typename TEvent>
+	static void react(TMachine& machine, const void* const payload) {
+		machine.react(*static_cast<const TEvent*>(payload));
+	}
+
+public:
+	enum : std::uint16_t {
+		EVENT_COUNT = sizeof...(TEvents),
+	};
+
+	// EVENT_COUNT + 1 for types not listed
+	template <typename TEvent>
+	static constexpr std::uint16_t id()					{ return find<TEvent, TEvents...>();	}
+
+	// false for unknown ids and truncated payloads
+	bool dispatch(TMachine& machine, const Record& record, const void* const payload) const {
+		if (record.event == UPDATE)
+			machine.update();
+		else if (record.event <= EVENT_COUNT && record.size == _sizes[record.event - 1])
+			_handlers[record.event - 1](machine, payload);
+		else
+			return false;
+
+		return true;
+	}
+
+private:
+	template <typename TEvent>
+	static constexpr std::uint16_t find()				{ return 1;								}
+
+	template <typename TEvent, typename TFirst, typename... TRest>
+	static constexpr std::uint16_t find() {
+		return std::is_same<TEvent, TFirst>::value ? 1 : 1 + find<TEvent, TRest...>();
+	}
+
+private:
+	const Handler _handlers[EVENT_COUNT] = { &react<TEvents>... };
+	const std::uint16_t _sizes[EVENT_COUNT] = { (std::uint16_t) sizeof(TEvents)... };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Stats {
+	std::uint64_t events;		// react() calls
+	std::uint64_t updates;		// update() calls
+	std::uint64_t skipped;		// records with unknown ids or for missing machines
+	double seconds;
+
+	double perSecond() const							{ return seconds > 0.0 ? (events + updates) / seconds : 0.0;	}
+};
+
+//------------------------------------------------------------------------------
+
+// feeds the log into 'machineCount' machines, selected by the record's machine id
+template <typename TMachine, typename TCodec>
+class Driver {
+public:
+	// stretch of the log the threads go through together
+	enum : std::size_t {
+		WINDOW = 4 * 1024 * 1024,
+	};
+
+	Driver(TMachine* const machines,
+		   const std::uint32_t machineCount,
+		   const TCodec& codec)
+		: _machines(machines)
+		, _machineCount(machineCount)
+		, _codec(codec)
+	{}
+
+	// single-threaded, in log order
+	Stats run(const EventLog& log) const {
+		const auto begin = std::chrono::steady_clock::now();
+
+		log.advise(EventLog::Access::Sequential);
+
+		Stats stats{};
+		walk(log.begin(), log.end(), log.end(), [this, &stats](const Record& record) { replay(record, stats); });
+
+		stats.seconds = seconds(begin);
+		return stats;
+	}
+
+	// every thread scans the same window of the log, replays the records of its own machines only
+	// (machine id % threads), and waits for the others before moving on to the next window:
+	// the order of records is kept per machine, and only a couple of windows need to be paged in at a time
+	Stats run(const EventLog& log, const unsigned threads) const {
+		const auto begin = std::chrono::steady_clock::now();
+
+		log.advise(EventLog::Access::Windowed);
+		log.prefetch(log.begin(), 2 * WINDOW);
+
+		Barrier barrier(threads);
+
+		std::vector<Stats> partial(threads, Stats{});
+		std::vector<std::thread> workers;
+
+		for (unsigned t = 0; t < threads; ++t)
+			workers.emplace_back([this, &log, &barrier, &partial, threads, t] {
+				for (const char* window = log.begin(); window < log.end(); ) {
+					const char* const limit = (std::size_t) (log.end() - window) > WINDOW ?
+						window + WINDOW : log.end();
+
+					// every thread stops at the same record
+					const char* const next = walk(window, limit, log.end(), [this, &partial, threads, t](const Record& record) {
+						if (record.machine % threads == t)
+							replay(record, partial[t]);
+					});
+
+					barrier.arrive([&log, window, next] {
+						log.release(window, next);
+						log.prefetch(next, 2 * WINDOW);
+					});
+
+					window = next;
+				}
+			});
+
+		Stats stats{};
+		for (unsigned t = 0; t < threads; ++t) {
+			workers[t].join();
+
+			stats.events  += partial[t].events;
+			stats.updates += partial[t].updates;
+			stats.skipped += partial[t].skipped;
+		}
+
+		stats.seconds = seconds(begin);
+		return stats;
+	}
+
+private:
+	// records starting in [cursor, limit), complete ones only: a truncated tail is dropped
+	// returns where the next record starts, or 'end' past the last one
+	template <typename TFunction>
+	static const char* walk(const char* cursor, const char* const limit, const char* const end, TFunction&& function) {
+		while (cursor < limit && cursor + sizeof(Record) <= end) {
+			const Record& record = *reinterpret_cast<const Record*>(cursor);
+			cursor += sizeof(Record) + padded(record.size);
+
+			if (cursor > end)
+				return end;
+
+			function(record);
+		}
+
+		return cursor < limit ? end : cursor;
+	}
+
+	void replay(const Record& record, Stats& stats) const {
+		const void* const payload = &record + 1;
+
+		if (record.machine < _machineCount &&
+			_codec.dispatch(_machines[record.machine], record, payload))
+		{
+			if (record.event == UPDATE)
+				++stats.updates;
+			else
+				++stats.events;
+		}
+		else
+			++stats.skipped;
+	}
+
+	static double seconds(const std::chrono::steady_clock::time_point begin) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+private:
+	TMachine* const _machines;
+	const std::uint32_t _machineCount;
+	const TCodec& _codec;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#undef HFSM_REPLAY_MMAP
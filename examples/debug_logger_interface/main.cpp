@@ -28,6 +28,13 @@
 //	-- detach: --
 //
 //
+//	-- sample: --
+//
+//	Top::update()
+//	Top::transition()
+//	Top::To::update()
+//	Top::To::transition()
+//
 //	--- dtor: ---
 //
 //	Top::To::leave()
@@ -55,7 +62,7 @@ struct Logger
 	: hfsm::LoggerInterface
 {
 	// hfsm::LoggerInterface
-	void record(const std::type_index& /*state*/,
+	void record(const StateType& /*state*/,
 				const char* const stateName,
 				const Method /*method*/,
 				const char* const methodName) override
@@ -132,6 +139,9 @@ int main() {
 		// logger
 		Logger logger;
 
+		// sampling policy, can be shared between multiple machines
+		M::LogSampling sampling(M::LogSampling::Policy::Ticks, 2);
+
 		std::cout << "--- ctor: ---\n\n";
 
 		// state machine instance - all initial states are activated
@@ -171,10 +181,24 @@ int main() {
 
 		// no output, since logger is detached
 
-		std::cout << "\n--- dtor: ---\n\n";
+		std::cout << "\n-- sample: --\n\n";
 
-		// re-attach logger for destruction log
+		// re-attach logger, but only log every other update() / react()
 		machine.attachLogger(&logger);
+		machine.attachSampling(&sampling);
+
+		machine.update();
+		machine.update();
+
+		// output, for the first update only:
+		//	Top::update()
+		//	Top::transition()
+		//	Top::To::update()
+		//	Top::To::transition()
+
+		std::cout << "\n--- dtor: ---\n\n";
+
+		// construction and destruction are logged regardless of sampling
 
 		// state machine instance gets destroyed
 	}
@@ -0,0 +1,289 @@
+﻿// HFSM (hierarchical state machine for games and interactive applications)
+// Created by Andrew Gresyk
+//
+// Load test:
+// drive a fleet of synthetic machines with a seeded mix of update() / react() calls,
+// time every call into log-linear histograms and report the tail latencies
+//
+// usage: load_test [machines=256] [calls=262144] [react=50] [jump=25] [rate=100] [seed=1]
+//	react	% of the calls that are react(), the rest are update()
+//	jump	% of the react() calls that send Jump, the rest send Ping
+//	rate	chance of a leaf transitioning on update() / Jump, in 1/1000
+//
+// the same arguments replay the same sequence of calls and transitions
+
+// State structure (of each machine):
+//
+// Root (orthogonal)
+//  ├ Region<0> (composite)
+//  │  ├ Leaf<0, 0>
+//  │  ├ ..
+//  │  └ Leaf<0, 3>
+//  ├ ..
+//  └ Region<3>
+//     ├ ..
+//     └ Leaf<3, 3>
+
+#include <hfsm/machine_single.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+//------------------------------------------------------------------------------
+
+// xorshift32, seeded per machine so that runs repeat
+struct Random {
+	// zero is the one state xorshift never leaves
+	Random(const unsigned seed = 1)
+		: state(seed ? seed : 0x9E3779B9u)
+	{}
+
+	unsigned state;
+
+	unsigned next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		return state;
+	}
+
+	bool chance(const unsigned perMille) {
+		return next() % 1000 < perMille;
+	}
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+struct Context {
+	Random random;
+	unsigned rate;
+	bool transitioned;
+};
+
+using M = hfsm::Machine<Context>;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+struct Ping {};
+struct Jump {};
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <unsigned TRegion>
+struct Region
+	: M::Base
+{};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <unsigned TRegion, unsigned TLeaf>
+struct Leaf
+	: M::Base
+{
+	using Next = Leaf<TRegion, (TLeaf + 1) % 4>;
+
+	void enter(Context& context) {
+		context.transitioned = true;
+	}
+
+	void transition(Control& control, Context& context) {
+		if (context.random.chance(context.rate))
+			control.changeTo<Next>();
+	}
+
+	void react(const Ping&, Control&, Context& context) {
+		context.random.next();
+	}
+
+	void react(const Jump&, Control& control, Context& context) {
+		if (context.random.chance(context.rate))
+			control.changeTo<Next>();
+	}
+
+	using M::Base::react;
+};
+
+//------------------------------------------------------------------------------
+
+template <unsigned TRegion>
+using RegionT = M::Composite<Region<TRegion>,
+							 Leaf<TRegion, 0>, Leaf<TRegion, 1>, Leaf<TRegion, 2>, Leaf<TRegion, 3>>;
+
+using Machine = M::OrthogonalPeerRoot<RegionT<0>, RegionT<1>, RegionT<2>, RegionT<3>>;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// HDR-style: 16 linear sub-buckets per power of two of nanoseconds,
+// so every bucket is within 1/16 (~6%) of the values it holds
+class Histogram {
+	enum : unsigned {
+		SUB_BITS	= 4,
+		SUB_COUNT	= 1 << SUB_BITS,
+		BUCKETS		= (64 - SUB_BITS + 1) * SUB_COUNT,
+	};
+
+public:
+	void record(const unsigned long long ns) {
+		++_buckets[bucket(ns)];
+		++_count;
+
+		if (_max < ns)
+			_max = ns;
+	}
+
+	unsigned long long count() const					{ return _count;	}
+	unsigned long long max() const						{ return _max;		}
+
+	// upper bound of the bucket holding the given quantile
+	unsigned long long percentile(const double quantile) const {
+		const unsigned long long rank = (unsigned long long) (quantile * _count);
+
+		unsigned long long seen = 0;
+		for (unsigned i = 0; i < BUCKETS; ++i) {
+			seen += _buckets[i];
+
+			if (seen > rank)
+				return upperBound(i) < _max ? upperBound(i) : _max;
+		}
+
+		return _max;
+	}
+
+private:
+	static unsigned bucket(const unsigned long long ns) {
+		if (ns < SUB_COUNT)
+			return (unsigned) ns;
+
+		unsigned magnitude = 0;
+		while (ns >> (magnitude + SUB_BITS + 1))
+			++magnitude;
+
+		// values [SUB_COUNT << magnitude, SUB_COUNT << (magnitude + 1)) share the top SUB_BITS + 1 bits
+		return (magnitude + 1) * SUB_COUNT + (unsigned) ((ns >> magnitude) - SUB_COUNT);
+	}
+
+	static unsigned long long upperBound(const unsigned i) {
+		if (i < SUB_COUNT)
+			return i;
+
+		const unsigned magnitude = i / SUB_COUNT - 1;
+
+		return ((unsigned long long) (SUB_COUNT + i % SUB_COUNT + 1) << magnitude) - 1;
+	}
+
+private:
+	unsigned long long _buckets[BUCKETS] = {};
+	unsigned long long _count = 0;
+	unsigned long long _max = 0;
+};
+
+//------------------------------------------------------------------------------
+
+void
+report(const char* const label, const Histogram& histogram) {
+	if (histogram.count())
+		std::printf("%-12s %9llu calls   p50 %6llu   p99 %6llu   p99.9 %6llu   max %8llu ns\n",
+					label,
+					histogram.count(),
+					histogram.percentile(0.5),
+					histogram.percentile(0.99),
+					histogram.percentile(0.999),
+					histogram.max());
+	else
+		std::printf("%-12s %9llu calls\n", label, 0ull);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+unsigned
+argument(int argc, char* argv[], const char* const name, const unsigned fallback) {
+	const size_t length = std::strlen(name);
+
+	for (int i = 1; i < argc; ++i)
+		if (std::strncmp(argv[i], name, length) == 0 && argv[i][length] == '=')
+			return (unsigned) std::strtoul(argv[i] + length + 1, nullptr, 10);
+
+	return fallback;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+	using Clock = std::chrono::steady_clock;
+
+	const unsigned machineCount = argument(argc, argv, "machines", 256);
+	const unsigned calls		= argument(argc, argv, "calls", 256 * 1024);
+	const unsigned reactShare	= argument(argc, argv, "react", 50);
+	const unsigned jumpShare	= argument(argc, argv, "jump", 25);
+	const unsigned rate			= argument(argc, argv, "rate", 100);
+	const unsigned seed			= argument(argc, argv, "seed", 1);
+
+	if (machineCount == 0)
+		return 1;
+
+	std::unique_ptr<Context[]> contexts(new Context[machineCount]());
+	for (unsigned i = 0; i < machineCount; ++i)
+		contexts[i] = Context{ Random{ seed * 2654435761u + i + 1 }, rate, false };
+
+	// placement into raw storage, machines are neither copyable nor movable
+	std::unique_ptr<char[]> storage(new char[sizeof(Machine) * machineCount + alignof(Machine)]);
+	const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+	Machine* const machines = reinterpret_cast<Machine*>((address + alignof(Machine) - 1) / alignof(Machine) * alignof(Machine));
+
+	for (unsigned i = 0; i < machineCount; ++i)
+		new (machines + i) Machine(contexts[i]);
+
+	Histogram updates;
+	Histogram reacts;
+	Histogram transitions;		// update() / react() calls that ended up transitioning
+
+	Random driver{ seed };
+
+	for (unsigned c = 0; c < calls; ++c) {
+		const unsigned i = driver.next() % machineCount;
+		Machine& machine = machines[i];
+		Context& context = contexts[i];
+
+		const bool react = driver.next() % 100 < reactShare;
+		const bool jump  = driver.next() % 100 < jumpShare;
+
+		context.transitioned = false;
+
+		const auto begin = Clock::now();
+
+		if (!react)
+			machine.update();
+		else if (jump)
+			machine.react(Jump{});
+		else
+			machine.react(Ping{});
+
+		const auto end = Clock::now();
+		const auto ns = (unsigned long long) std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+
+		(react ? reacts : updates).record(ns);
+
+		if (context.transitioned)
+			transitions.record(ns);
+	}
+
+	std::printf("%u machines, %u calls, react %u%%, jump %u%%, rate %u/1000, seed %u\n",
+				machineCount, calls, reactShare, jumpShare, rate, seed);
+
+	report("update()", updates);
+	report("react()", reacts);
+	report("transitions", transitions);
+
+	for (unsigned i = 0; i < machineCount; ++i)
+		machines[i].~Machine();
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
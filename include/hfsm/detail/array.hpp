@@ -8,8 +8,6 @@ namespace detail {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#pragma pack(push, 4)
-
 template <typename T, unsigned TCapacity>
 class StaticArray {
 public:
@@ -24,8 +22,8 @@ public:
 public:
 	inline StaticArray() = default;
 
-	inline		 Item& operator[] (const unsigned i);
-	inline const Item& operator[] (const unsigned i) const;
+	inline		 Item& operator[] (const unsigned i) HFSM_NOEXCEPT(true);
+	inline const Item& operator[] (const unsigned i) const HFSM_NOEXCEPT(true);
 
 	inline const unsigned count() const						{ return CAPACITY; }
 
@@ -73,8 +71,6 @@ private:
 	Item _storage[CAPACITY];
 };
 
-#pragma pack(pop)
-
 ////////////////////////////////////////////////////////////////////////////////
 
 }
@@ -5,7 +5,7 @@ namespace detail {
 
 template <typename T, unsigned TCapacity>
 T&
-StaticArray<T, TCapacity>::operator[] (const unsigned i) {
+StaticArray<T, TCapacity>::operator[] (const unsigned i) HFSM_NOEXCEPT(true) {
 	assert(0 <= i && i < CAPACITY);
 
 	return _items[i];
@@ -15,7 +15,7 @@ StaticArray<T, TCapacity>::operator[] (const unsigned i) {
 
 template <typename T, unsigned TCapacity>
 const T&
-StaticArray<T, TCapacity>::operator[] (const unsigned i) const {
+StaticArray<T, TCapacity>::operator[] (const unsigned i) const HFSM_NOEXCEPT(true) {
 	assert(0 <= i && i < CAPACITY);
 
 	return _items[i];
@@ -1,14 +1,16 @@
 #pragma once
 
+#include "utility.hpp"
+
 namespace hfsm {
 namespace detail {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#pragma pack(push, 4)
-
+// the items are owned by the derived Array, and stored right after the view;
+// the view is aligned (and so padded) for the items, so they start at 'this + 1' whatever their alignment
 template <typename T>
-class ArrayView {
+class alignas(alignof(T) > alignof(unsigned) ? alignof(T) : alignof(unsigned)) ArrayView {
 public:
 	using Item = T;
 
@@ -19,19 +21,22 @@ protected:
 	ArrayView(const unsigned capacity);
 	~ArrayView();
 
+	ArrayView(const ArrayView&) = delete;
+	ArrayView& operator = (const ArrayView&) = delete;
+
 public:
-	inline void clear()										{ _count = 0;				}
+	inline void clear()								HFSM_NOEXCEPT(true)	{ _count = 0;				}
 
-	inline unsigned resize(const unsigned count);
+	inline unsigned resize(const unsigned count) HFSM_NOEXCEPT(std::is_nothrow_default_constructible<Item>::value);
 
 	template <typename TValue>
-	inline unsigned operator << (TValue&& value);
+	inline unsigned operator << (TValue&& value) HFSM_NOEXCEPT(std::is_nothrow_constructible<Item, TValue&&>::value);
 
-	inline		 Item& operator[] (const unsigned i)		{ return get(i);			}
-	inline const Item& operator[] (const unsigned i) const	{ return get(i);			}
+	inline		 Item& operator[] (const unsigned i)		HFSM_NOEXCEPT(true)	{ return get(i);			}
+	inline const Item& operator[] (const unsigned i) const	HFSM_NOEXCEPT(true)	{ return get(i);			}
 
-	inline unsigned capacity() const						{ return _capacity;			}
-	inline unsigned count() const							{ return _count;			}
+	inline unsigned capacity() const				HFSM_NOEXCEPT(true)	{ return _capacity;			}
+	inline unsigned count() const					HFSM_NOEXCEPT(true)	{ return _count;			}
 
 protected:
 	inline unsigned first() const							{ return 0;					}
@@ -40,21 +45,19 @@ protected:
 	inline unsigned prev(const unsigned i) const			{ return i - 1;				}
 	inline unsigned next(const unsigned i) const			{ return i + 1;				}
 
-	inline		 Item& get(const unsigned i);
-	inline const Item& get(const unsigned i) const;
+	inline		 Item& get(const unsigned i) HFSM_NOEXCEPT(true);
+	inline const Item& get(const unsigned i) const HFSM_NOEXCEPT(true);
 
 private:
-	// hacks
-	inline		 Item* data()		{ return reinterpret_cast<		Item*>(&_count + 1);	}
-	inline const Item* data() const	{ return reinterpret_cast<const Item*>(&_count + 1);	}
+	// through an integer, as the items lie past the view object itself
+	inline		 Item* data()		HFSM_NOEXCEPT(true)	{ return reinterpret_cast<	   Item*>(reinterpret_cast<std::uintptr_t>(this) + sizeof(ArrayView));	}
+	inline const Item* data() const	HFSM_NOEXCEPT(true)	{ return reinterpret_cast<const Item*>(reinterpret_cast<std::uintptr_t>(this) + sizeof(ArrayView));	}
 
 protected:
 	const unsigned _capacity;
 	unsigned _count = 0;
 };
 
-#pragma pack(pop)
-
 ////////////////////////////////////////////////////////////////////////////////
 
 }
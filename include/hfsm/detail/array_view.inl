@@ -21,7 +21,7 @@ ArrayView<T>::~ArrayView() {
 
 template <typename T>
 unsigned
-ArrayView<T>::resize(const unsigned count) {
+ArrayView<T>::resize(const unsigned count) HFSM_NOEXCEPT(std::is_nothrow_default_constructible<Item>::value) {
 	const unsigned clampedCount = count < _capacity ?
 		count : _capacity;
 
@@ -30,8 +30,8 @@ ArrayView<T>::resize(const unsigned count) {
 			get(i) = Item();
 	}
 	else if (clampedCount < _count) {
-		for (unsigned i = _count - 1; i >= clampedCount; --i)
-			get(i).~Item();
+		for (unsigned i = _count; i > clampedCount; --i)
+			get(i - 1).~Item();
 	}
 
 	return _count = clampedCount;
@@ -42,7 +42,7 @@ ArrayView<T>::resize(const unsigned count) {
 template <typename T>
 template <typename TValue>
 unsigned
-ArrayView<T>::operator << (TValue&& value) {
+ArrayView<T>::operator << (TValue&& value) HFSM_NOEXCEPT(std::is_nothrow_constructible<Item, TValue&&>::value) {
 	assert(_count < _capacity);
 
 	new (&get(_count)) Item(std::move(value));
@@ -54,7 +54,7 @@ ArrayView<T>::operator << (TValue&& value) {
 
 template <typename T>
 T&
-ArrayView<T>::get(const unsigned i) {
+ArrayView<T>::get(const unsigned i) HFSM_NOEXCEPT(true) {
 	assert(0 <= i && i < _capacity);
 
 	return data()[i];
@@ -64,7 +64,7 @@ ArrayView<T>::get(const unsigned i) {
 
 template <typename T>
 const T&
-ArrayView<T>::get(const unsigned i) const {
+ArrayView<T>::get(const unsigned i) const HFSM_NOEXCEPT(true) {
 	assert(0 <= i && i < _capacity);
 
 	return data()[i];
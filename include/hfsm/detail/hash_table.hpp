@@ -81,13 +81,16 @@ public:
 
 	bool insert(const Key key, const Value value);
 
-		  Value* find(const Key key);
-	const Value* find(const Key key) const;
+		  Value* find(const Key key) HFSM_NOEXCEPT(true);
+	const Value* find(const Key key) const HFSM_NOEXCEPT(true);
+
+	// reverse lookup, linear
+	const Key* findKey(const Value& value) const;
 
 	inline unsigned count() const						{ return _count;						}
 
 private:
-	unsigned locate(const Key key) const;
+	unsigned locate(const Key key) const HFSM_NOEXCEPT(true);
 
 	inline unsigned probeCount(const unsigned i) const;
 
@@ -79,7 +79,7 @@ HashTable<TK, TV, TC, TH>::insert(const Key key, const Value value) {
 
 template <typename TK, typename TV, unsigned TC, typename TH>
 typename HashTable<TK, TV, TC, TH>::Value*
-HashTable<TK, TV, TC, TH>::find(const Key key) {
+HashTable<TK, TV, TC, TH>::find(const Key key) HFSM_NOEXCEPT(true) {
 	const unsigned index = locate(key);
 
 	return index != INVALID ?
@@ -90,18 +90,30 @@ HashTable<TK, TV, TC, TH>::find(const Key key) {
 
 template <typename TK, typename TV, unsigned TC, typename TH>
 const typename HashTable<TK, TV, TC, TH>::Value*
-HashTable<TK, TV, TC, TH>::find(const Key key) const {
+HashTable<TK, TV, TC, TH>::find(const Key key) const HFSM_NOEXCEPT(true) {
 	const unsigned index = locate(key);
 
 	return index != INVALID ?
 		_items[index].value() : nullptr;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TK, typename TV, unsigned TC, typename TH>
+const typename HashTable<TK, TV, TC, TH>::Key*
+HashTable<TK, TV, TC, TH>::findKey(const Value& value) const {
+	for (unsigned i = 0; i < CAPACITY; ++i)
+		if (_items[i].occupied() && *_items[i].value() == value)
+			return &_items[i].key();
+
+	return nullptr;
+}
+
 //------------------------------------------------------------------------------
 
 template <typename TK, typename TV, unsigned TC, typename TH>
 unsigned
-HashTable<TK, TV, TC, TH>::locate(const Key key) const {
+HashTable<TK, TV, TC, TH>::locate(const Key key) const HFSM_NOEXCEPT(true) {
 	const Item item(hash(key), key);
 
 	for (unsigned i = index(item.hash()), distance = 0;
@@ -4,19 +4,19 @@
 
 #pragma region Utility
 
-template <typename TC, unsigned TMS>
-M<TC, TMS>::Fork::Fork(const Index index,
-					   const TypeInfo HSFM_IF_DEBUG(type_))
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::Fork::Fork(const Index index,
+							const TypeInfo HSFM_IF_DEBUG_TYPES(type_))
 	: self(index)
-	HSFM_IF_DEBUG(, type(type_))
+	HSFM_IF_DEBUG_TYPES(, type(type_))
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <unsigned TCapacity>
 unsigned
-M<TC, TMS>::StateRegistryT<TCapacity>::add(const TypeInfo stateType) {
+M<TC, TMS, TLF>::StateRegistryT<TCapacity>::add(const TypeInfo stateType) {
 	const unsigned index = _typeToIndex.count();
 
 	HSFM_CHECKED(_typeToIndex.insert(*stateType, index));
@@ -24,58 +24,97 @@ M<TC, TMS>::StateRegistryT<TCapacity>::add(const TypeInfo stateType) {
 	return index;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TCapacity>
+typename M<TC, TMS, TLF>::TypeInfo
+M<TC, TMS, TLF>::StateRegistryT<TCapacity>::type(const unsigned index) const {
+	TypeInfo stateType;
+	stateType.clear();
+
+	if (const auto* const native = _typeToIndex.findKey(index))
+		stateType = *native;
+
+	return stateType;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TFC>
+bool
+M<TC, TMS, TLF>::SubstitutionHistoryT<TFC>::record() HFSM_NOEXCEPT(true) {
+	assert(_count < MaxSubstitutions);
+
+	const Index* const pending = _configurations[_count];
+
+	// FNV-1a
+	unsigned hash = 2166136261u;
+	for (unsigned f = 0; f < TFC; ++f)
+		hash = (hash ^ pending[f]) * 16777619u;
+
+	for (unsigned r = 0; r < _count; ++r)
+		if (_hashes[r] == hash && memcmp(_configurations[r], pending, TFC) == 0)
+			return false;
+
+	_hashes[_count++] = hash;
+
+	return true;
+}
+
 #pragma endregion
 
 ////////////////////////////////////////////////////////////////////////////////
 
 #pragma region Injections
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI, typename... TR>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreSubstitute(Context& context) {
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreSubstitute(Context& context) HFSM_NOEXCEPT(NoexceptPreSubstitute) {
 	TI::preSubstitute(context);
 	_B<TR...>::widePreSubstitute(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI, typename... TR>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreEnter(Context& context) {
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreEnter(Context& context) HFSM_NOEXCEPT(NoexceptPreEnter) {
 	TI::preEnter(context);
 	_B<TR...>::widePreEnter(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI, typename... TR>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreUpdate(Context& context) {
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreUpdate(Context& context) HFSM_NOEXCEPT(NoexceptPreUpdate) {
 	TI::preUpdate(context);
 	_B<TR...>::widePreUpdate(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI, typename... TR>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreTransition(Context& context) {
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreTransition(Context& context) HFSM_NOEXCEPT(NoexceptPreTransition) {
 	TI::preTransition(context);
 	_B<TR...>::widePreTransition(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI, typename... TR>
 template <typename TEvent>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreReact(const TEvent& event,
-										Context& context)
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreReact(const TEvent& event,
+											 Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value)
 {
 	TI::preReact(event, context);
 	_B<TR...>::widePreReact(event, context);
@@ -83,68 +122,68 @@ M<TC, TMS>::_B<TI, TR...>::widePreReact(const TEvent& event,
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI, typename... TR>
 void
-M<TC, TMS>::_B<TI, TR...>::widePostLeave(Context& context) {
+M<TC, TMS, TLF>::_B<TI, TR...>::widePostLeave(Context& context) HFSM_NOEXCEPT(NoexceptPostLeave) {
 	TI::postLeave(context);
 	_B<TR...>::widePostLeave(context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI>
 void
-M<TC, TMS>::_B<TI>::widePreSubstitute(Context& context) {
+M<TC, TMS, TLF>::_B<TI>::widePreSubstitute(Context& context) HFSM_NOEXCEPT(NoexceptPreSubstitute) {
 	TI::preSubstitute(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI>
 void
-M<TC, TMS>::_B<TI>::widePreEnter(Context& context) {
+M<TC, TMS, TLF>::_B<TI>::widePreEnter(Context& context) HFSM_NOEXCEPT(NoexceptPreEnter) {
 	TI::preEnter(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI>
 void
-M<TC, TMS>::_B<TI>::widePreUpdate(Context& context) {
+M<TC, TMS, TLF>::_B<TI>::widePreUpdate(Context& context) HFSM_NOEXCEPT(NoexceptPreUpdate) {
 	TI::preUpdate(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI>
 void
-M<TC, TMS>::_B<TI>::widePreTransition(Context& context) {
+M<TC, TMS, TLF>::_B<TI>::widePreTransition(Context& context) HFSM_NOEXCEPT(NoexceptPreTransition) {
 	TI::preTransition(context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI>
 template <typename TEvent>
 void
-M<TC, TMS>::_B<TI>::widePreReact(const TEvent& event,
-								 Context& context)
+M<TC, TMS, TLF>::_B<TI>::widePreReact(const TEvent& event,
+									  Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value)
 {
 	TI::preReact(event, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TI>
 void
-M<TC, TMS>::_B<TI>::widePostLeave(Context& context) {
+M<TC, TMS, TLF>::_B<TI>::widePostLeave(Context& context) HFSM_NOEXCEPT(NoexceptPostLeave) {
 	TI::postLeave(context);
 }
 
@@ -152,39 +191,524 @@ M<TC, TMS>::_B<TI>::widePostLeave(Context& context) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#pragma region Logging
+
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::LogSampling::LogSampling(const Policy policy,
+										  const unsigned rate)
+	: _policy(policy)
+	, _rate(rate)
+{
+	assert(rate > 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+bool
+M<TC, TMS, TLF>::LogSampling::sample(const unsigned machine,
+									 const unsigned tick) const HFSM_NOEXCEPT(true)
+{
+	switch (_policy) {
+	case Policy::All:
+		return true;
+
+	case Policy::Ticks:
+		return tick % _rate == 0;
+
+	case Policy::Machines:
+		return machine % _rate == 0;
+
+	case Policy::Never:
+		return false;
+
+	default:
+		assert(false);
+		return true;
+	}
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TRC>
+M<TC, TMS, TLF>::LogSamplingT<TRC>::LogSamplingT(const Policy policy,
+												 const unsigned rate,
+												 const unsigned seed)
+	: LogSampling(policy, rate)
+	, _random(seed ? seed : 1)
+{}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// reservoir sampling, 'Algorithm R'
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TRC>
+void
+M<TC, TMS, TLF>::LogSamplingT<TRC>::offer(const Transition& transition) HFSM_NOEXCEPT(true) {
+	++_offered;
+
+	if (_reservoir.count() < Capacity)
+		_reservoir << transition;
+	else {
+		const unsigned slot = random() % _offered;
+
+		if (slot < Capacity)
+			_reservoir[slot] = transition;
+	}
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// xorshift32
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TRC>
+unsigned
+M<TC, TMS, TLF>::LogSamplingT<TRC>::random() HFSM_NOEXCEPT(true) {
+	_random ^= _random << 13;
+	_random ^= _random >> 17;
+	_random ^= _random << 5;
+
+	return _random;
+}
+
+#endif
+
+#pragma endregion
+
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma region Watchdog
+
+#ifdef HFSM_ENABLE_WATCHDOG
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::Watchdog::Watchdog(StateWatches& states,
+									Incidents& incidents)
+	: _states(states)
+	, _incidents(incidents)
+{}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::check(const unsigned state,
+								 const Callback callback,
+								 const TimePoint begin) HFSM_NOEXCEPT(true)
+{
+	const TimePoint end = Clock::now();
+	const Duration duration = end - begin;
+
+	const Duration threshold = _states[state].threshold != Duration::zero() ?
+		_states[state].threshold : _threshold;
+
+	if (duration > threshold)
+		report(Incident { Incident::Type::SlowCallback, state, callback, duration, _tick, end });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::entered(const unsigned state) HFSM_NOEXCEPT(true) {
+	auto& watch = _states[state];
+
+	if (_tick - watch.windowStart >= _oscillationWindow) {
+		watch.windowStart = _tick;
+		watch.enters = 0;
+	}
+
+	// once per window
+	if (++watch.enters == _oscillationLimit + 1)
+		report(Incident { Incident::Type::Oscillation, state, Callback::Enter, Duration::zero(), _tick, Clock::now() });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::exhausted(const unsigned state) HFSM_NOEXCEPT(true) {
+	report(Incident { Incident::Type::SubstitutionLimit, state, Callback::Substitute, Duration::zero(), _tick, Clock::now() });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::cycled(const unsigned state) HFSM_NOEXCEPT(true) {
+	report(Incident { Incident::Type::SubstitutionCycle, state, Callback::Substitute, Duration::zero(), _tick, Clock::now() });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::overBudget(const unsigned state,
+									  const Duration duration) HFSM_NOEXCEPT(true)
+{
+	report(Incident { Incident::Type::SubstitutionBudget, state, Callback::Substitute, duration, _tick, Clock::now() });
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::report(const Incident& incident) HFSM_NOEXCEPT(true) {
+	if (_incidents.count() < _incidents.capacity())
+		_incidents << incident;
+	else
+		_incidents[_reported % _incidents.capacity()] = incident;
+
+	++_reported;
+}
+
+#endif
+
+#pragma endregion
+
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma region Event Stats
+
+#ifdef HFSM_ENABLE_EVENT_STATS
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::EventStats::EventStats(Entries& entries)
+	: _entries(entries)
+{}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::EventStats::merge(const EventStats& other) {
+	for (unsigned i = 0; i < other._entries.count(); ++i) {
+		const Entry& from = other._entries[i];
+
+		if (Entry* const to = insert(from.event)) {
+			to->dispatched	+= from.dispatched;
+			to->visited		+= from.visited;
+			to->handled		+= from.handled;
+			to->transitions	+= from.transitions;
+		} else
+			_dropped += from.dispatched;
+	}
+
+	_dropped += other._dropped;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+const typename M<TC, TMS, TLF>::EventStats::Entry*
+M<TC, TMS, TLF>::EventStats::find(const TypeInfo event) const HFSM_NOEXCEPT(true) {
+	// a handful of event types per machine, linear search beats hashing
+	for (unsigned i = 0; i < _entries.count(); ++i)
+		if (_entries[i].event == event)
+			return &_entries[i];
+
+	return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+typename M<TC, TMS, TLF>::EventStats::Entry*
+M<TC, TMS, TLF>::EventStats::insert(const TypeInfo event) HFSM_NOEXCEPT(true) {
+	if (const Entry* const entry = find(event))
+		return const_cast<Entry*>(entry);
+	else if (_entries.count() < _entries.capacity())
+		return &_entries[_entries << Entry { event, 0, 0, 0, 0 }];
+	else
+		return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+typename M<TC, TMS, TLF>::EventStats::Entry*
+M<TC, TMS, TLF>::EventStats::dispatched(const TypeInfo event) HFSM_NOEXCEPT(true) {
+	Entry* const entry = insert(event);
+
+	if (entry)
+		++entry->dispatched;
+	else
+		++_dropped;
+
+	return entry;
+}
+
+#endif
+
+#pragma endregion
+
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma region Coverage
+
+#ifdef HFSM_ENABLE_COVERAGE
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::Coverage::Coverage(const unsigned capacity,
+									Words& states,
+									Words& transitions)
+	: _capacity(capacity)
+	, _states(states)
+	, _transitions(transitions)
+{}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+bool
+M<TC, TMS, TLF>::Coverage::merge(const Coverage& other) {
+	if (_capacity != other._capacity)
+		return false;
+
+	for (unsigned i = 0; i < _states.count(); ++i) {
+		_states[i]		|= other._states[i];
+		_transitions[i]	|= other._transitions[i];
+	}
+
+	return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+unsigned
+M<TC, TMS, TLF>::Coverage::exportStates(unsigned* const states,
+										const unsigned capacity) const
+{
+	unsigned count = 0;
+
+	for (unsigned state = 0; state < _capacity && count < capacity; ++state)
+		if (entered(state))
+			states[count++] = state;
+
+	return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Coverage::clear() {
+	for (unsigned i = 0; i < _states.count(); ++i) {
+		_states[i]		= 0;
+		_transitions[i]	= 0;
+	}
+}
+
+#endif
+
+#pragma endregion
+
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma region Substitution Stats
+
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::SubstitutionStats::record(const unsigned rounds) HFSM_NOEXCEPT(true) {
+	assert(rounds <= MaxSubstitutions);
+
+	++_calls;
+	++_rounds[rounds];
+
+	if (_peak < rounds)
+		_peak = rounds;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::SubstitutionStats::clear() {
+	const Duration budget = _budget;
+
+	*this = SubstitutionStats{};
+	_budget = budget;
+}
+
+#endif
+
+#pragma endregion
+
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma region Scratch
+
+#ifdef HFSM_ENABLE_SCRATCH
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::ScratchBlock::ScratchBlock(char* const memory,
+											const unsigned capacity,
+											HighWaters& highWaters,
+											FreeLists& freeLists)
+	: _memory(memory)
+	, _capacity(capacity)
+	, _highWaters(highWaters)
+	, _freeLists(freeLists)
+{}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::ScratchBlock::clearHighWaters() {
+	for (unsigned i = 0; i < _highWaters.count(); ++i)
+		_highWaters[i] = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+char*
+M<TC, TMS, TLF>::ScratchBlock::carve(const unsigned state,
+									 const unsigned size) HFSM_NOEXCEPT(true)
+{
+	// one left behind by a destroyed machine, of the same state and size
+	if (char* const arena = _freeLists[state]) {
+		memcpy(&_freeLists[state], arena, sizeof(char*));
+
+		return arena;
+	}
+
+	// keep every arena aligned for any type, and large enough to hold the free list link
+	const unsigned padded = (size + alignof(std::max_align_t) - 1) & ~(unsigned) (alignof(std::max_align_t) - 1);
+
+	if (_capacity - _carved < padded)
+		return nullptr;
+
+	char* const arena = _memory + _carved;
+	_carved += padded;
+
+	return arena;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::ScratchBlock::release(const unsigned state,
+									   char* const arena) HFSM_NOEXCEPT(true)
+{
+	memcpy(arena, &_freeLists[state], sizeof(char*));
+	_freeLists[state] = arena;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void*
+M<TC, TMS, TLF>::Scratch::allocate(const unsigned size,
+								   const unsigned alignment) HFSM_NOEXCEPT(true)
+{
+	assert(alignment && (alignment & (alignment - 1)) == 0 && alignment <= alignof(std::max_align_t));
+
+	const unsigned begin = (_used + alignment - 1) & ~(alignment - 1);
+
+	if (!_memory || begin > _capacity || _capacity - begin < size)
+		return nullptr;
+
+	_used = begin + size;
+	_block->record(_state, _used);
+
+	return _memory + begin;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename T, typename... TArgs>
+T*
+M<TC, TMS, TLF>::Scratch::create(TArgs&&... args) {
+	static_assert(std::is_trivially_destructible<T>::value, "Scratch arenas are released without calling destructors");
+
+	void* const memory = allocate(sizeof(T), alignof(T));
+
+	return memory ? new (memory) T(std::forward<TArgs>(args)...) : nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Control::scratchEnter(const unsigned state,
+									   Scratch& scratch) HFSM_NOEXCEPT(true)
+{
+	if (scratch._memory || !_scratch)
+		return;
+
+	scratch._memory = _scratch->carve(state, scratch._capacity);
+
+	if (scratch._memory) {
+		scratch._block = _scratch;
+		scratch._state = state;
+	} else if (!scratch._missed) {
+		// retried on every entry, in case another machine returns one
+		scratch._missed = true;
+		++_scratch->_missed;
+	}
+}
+
+#endif
+
+#pragma endregion
+
+////////////////////////////////////////////////////////////////////////////////
+
 #pragma region Root
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
-M<TC, TMS>::_R<TA>::_R(Context& context
-					   HFSM_IF_LOGGER(, LoggerInterface* const logger))
+M<TC, TMS, TLF>::_R<TA>::_R(Context& context
+							HFSM_IF_LOGGER(, LoggerInterface* const logger)
+							HFSM_IF_COVERAGE(, Coverage* const coverage)
+							HFSM_IF_SCRATCH(, ScratchBlock* const scratch))
 	: _context(context)
 	, _apex(_stateRegistry, Parent(), _stateParents, _forkParents, _forkPointers)
 	HFSM_IF_LOGGER(, _logger(logger))
+	HFSM_IF_COVERAGE(, _coverage(coverage && coverage->capacity() >= StateCount ? coverage : &_coverageSink))
+	HFSM_IF_SCRATCH(, _scratch(scratch))
 {
-	HFSM_IF_STRUCTURE(getStateNames());
+	HFSM_IF_COVERAGE(assert(!coverage || _coverage == coverage));
+	HFSM_IF_STRUCTURE(_activities.resize(StateCount));
 
-	_apex.deepEnterInitial(_context, HFSM_LOGGER_OR(_logger, nullptr));
+	auto control = this->control();
+	_apex.deepEnterInitial(control, _context);
 
-	HFSM_IF_STRUCTURE(udpateActivity());
+	HFSM_IF_STRUCTURE(++_activityTick);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
-M<TC, TMS>::_R<TA>::~_R() {
-	_apex.deepLeave(_context, HFSM_LOGGER_OR(_logger, nullptr));
+M<TC, TMS, TLF>::_R<TA>::~_R() {
+	HFSM_IF_LOGGER(_sampled = true);
+
+	auto control = this->control();
+	_apex.deepLeave(control, _context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::update() {
-	Control control(_requests);
-	_apex.deepUpdateAndTransition(control, _context, HFSM_LOGGER_OR(_logger, nullptr));
+M<TC, TMS, TLF>::_R<TA>::update() HFSM_NOEXCEPT(NoexceptUpdate) {
+	HFSM_IF_LOGGER(sampleLogging());
+	HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->tick());
+
+	auto control = this->control();
+	_apex.deepUpdateAndTransition(control, _context);
 
 	if (_requests.count())
 		processTransitions();
@@ -192,25 +716,244 @@ M<TC, TMS>::_R<TA>::update() {
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename TEvent, typename... TArgs>
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::emplace(TArgs&&... args) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value &&
+																std::is_nothrow_constructible<TEvent, TArgs&&...>::value)
+{
+	TEvent event(std::forward<TArgs>(args)...);
+
+	return dispatch(event);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 template <typename TEvent>
-void
-M<TC, TMS>::_R<TA>::react(const TEvent& event) {
-	Control control(_requests);
-	_apex.deepReact(event, control, _context, HFSM_LOGGER_OR(_logger, nullptr));
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::dispatch(TEvent& event) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value) {
+	HFSM_IF_LOGGER(sampleLogging());
+	HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->tick());
+
+	auto control = this->control();
+	control._propagation = _propagation;
+	HFSM_IF_EVENT_STATS(if (_eventStats) control._eventEntry = _eventStats->dispatched(TypeInfo::get<typename std::remove_const<TEvent>::type>()));
+
+	_apex.deepReact(event, control, _context);
+	HFSM_IF_EVENT_STATS(if (control._eventEntry) control._eventEntry->transitions += _requests.count());
 
 	if (_requests.count())
 		processTransitions();
+
+	Reaction reaction;
+	reaction.consumer = control._consumer;
+
+	return reaction;
+}
+
+//------------------------------------------------------------------------------
+
+#ifdef HFSM_VARIANT_EVENTS
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename TVariant, std::size_t... TIndices>
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::reactVariant(TVariant& events,
+									  std::index_sequence<TIndices...>)
+{
+	using Alternative = Reaction (*)(_R&, TVariant&);
+
+	// indexed by alternative, instead of std::visit()-ing into react()
+	static constexpr Alternative alternatives[] = { &_R::template reactAlternative<TVariant, TIndices>... };
+
+	return events.valueless_by_exception() ?
+		Reaction{} : alternatives[events.index()](*this, events);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename TVariant, std::size_t TIndex>
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::reactAlternative(_R& machine,
+										  TVariant& events)
+{
+	auto& event = *std::get_if<TIndex>(&events);
+
+	if constexpr (std::is_same<std::decay_t<decltype(event)>, std::monostate>::value)
+		return Reaction{};
+	else
+		return machine.dispatch(event);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+template <typename TEvent, typename... TArgs>
+bool
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::emplaceIn(const unsigned lane,
+																	   TArgs&&... args)
+{
+	static_assert(alignof(TEvent) <= alignof(std::max_align_t), "Over-aligned events can't be queued");
+	assert(lane < LaneCount);
+
+	Lane& target = _lanes[lane];
+
+	const unsigned event = align(target.tail + sizeof(Entry), alignof(TEvent));
+
+	if (event + sizeof(TEvent) > TCapacity) {
+		++target.counters.dropped;
+
+		return false;
+	}
+
+	new (target.buffer + event) TEvent(std::forward<TArgs>(args)...);
+
+	// keep the next entry aligned, too
+	const unsigned next = align(event + sizeof(TEvent), alignof(Entry));
+	new (target.buffer + target.tail) Entry{ &react<TEvent>, &destroy<TEvent>, event, next };
+
+	target.tail = next;
+	++target.count;
+	++target.counters.emplaced;
+
+	return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+void
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::dispatch(_R& machine) {
+	// destroyed / reset even if react() throws
+	struct Guard {
+		~Guard()											{ entry.destroy(event);		}
+
+		const Entry& entry;
+		void* const event;
+	};
+
+	struct Dispatching {
+		~Dispatching()										{ flag = false;				}
+
+		bool& flag;
+	};
+
+	assert(!_dispatching);
+	_dispatching = true;
+	const Dispatching dispatching{ _dispatching };
+
+	// the highest pending lane is looked up again after every event,
+	// picking up the ones emplaced by the reactions
+	for (unsigned lane = LaneCount; lane > 0; ) {
+		Lane& source = _lanes[lane - 1];
+
+		if (source.count == 0) {
+			// buffers are reused once their lane is drained
+			source.head = source.tail = 0;
+			--lane;
+
+			continue;
+		}
+
+		for (unsigned lower = 0; lower < lane - 1; ++lower)
+			if (_lanes[lower].count) {
+				++source.counters.preempting;
+				break;
+			}
+
+		const Entry& entry = *reinterpret_cast<const Entry*>(source.buffer + source.head);
+		source.head = entry.next;
+		--source.count;
+		++source.counters.dispatched;
+
+		const Guard guard{ entry, source.buffer + entry.event };
+		entry.react(machine, guard.event);
+
+		lane = LaneCount;
+	}
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+unsigned
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::count() const {
+	unsigned total = 0;
+
+	for (const Lane& lane : _lanes)
+		total += lane.count;
+
+	return total;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+void
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::clearCounters() {
+	for (Lane& lane : _lanes)
+		lane.counters = Counters{};
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+void
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::clear() {
+	for (unsigned lane = 0; lane < LaneCount; ++lane)
+		clear(lane);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+void
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::clear(const unsigned lane) {
+	assert(lane < LaneCount);
+
+	Lane& target = _lanes[lane];
+
+	while (target.head < target.tail) {
+		const Entry& entry = *reinterpret_cast<const Entry*>(target.buffer + target.head);
+		target.head = entry.next;
+
+		entry.destroy(target.buffer + entry.event);
+	}
+
+	target.count = 0;
+
+	// the event being reacted to may still live in the buffer
+	if (!_dispatching)
+		target.head = target.tail = 0;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 template <typename T>
 bool
-M<TC, TMS>::_R<TA>::isActive() {
+M<TC, TMS, TLF>::_R<TA>::isActive() {
 	using Type = T;
 
 	const auto stateType = TypeInfo::get<Type>();
@@ -228,11 +971,11 @@ M<TC, TMS>::_R<TA>::isActive() {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 template <typename T>
 bool
-M<TC, TMS>::_R<TA>::isResumable() {
+M<TC, TMS, TLF>::_R<TA>::isResumable() {
 	using Type = T;
 
 	const auto stateType = TypeInfo::get<Type>();
@@ -250,20 +993,60 @@ M<TC, TMS>::_R<TA>::isResumable() {
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename T>
+constexpr unsigned
+M<TC, TMS, TLF>::_R<TA>::stateIndex() {
+	constexpr unsigned state = Apex::template deepFind<T>();
+	static_assert(state != INVALID_STATE, "T is not a state of the machine");
+
+	return state;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// one walk down the types, from the apex to the state
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename T>
+constexpr typename M<TC, TMS, TLF>::template _R<TA>::Location
+M<TC, TMS, TLF>::_R<TA>::locate() {
+	Location location{};
+	location.state	= stateIndex<T>();
+	location.parent	= INVALID_STATE;
+
+	Apex::deepLocate(0, location);
+
+	return location;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::processTransitions() {
+M<TC, TMS, TLF>::_R<TA>::processTransitions() HFSM_NOEXCEPT(NoexceptTransitions) {
 	HFSM_IF_STRUCTURE(_lastTransitions.clear());
 
-	for (unsigned i = 0;
-		i < MaxSubstitutions && _requests.count();
-		++i)
-	{
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+	using Clock = typename SubstitutionStats::Clock;
+
+	const bool budgeted = _substitutionStats && _substitutionStats->_budget != SubstitutionStats::Duration::zero();
+	const auto begin = budgeted ? Clock::now() : typename Clock::time_point{};
+#endif
+
+	SubstitutionHistory history;
+	unsigned round = 0;
+
+	while (round < MaxSubstitutions && _requests.count()) {
+		++round;
+
 		unsigned changeCount = 0;
 
 		for (const auto& request : _requests) {
 			HFSM_IF_STRUCTURE(_lastTransitions << DebugTransitionInfo(request, DebugTransitionInfo::Update));
+			HFSM_IF_LOGGER(if (_sampling) _sampling->offer(request));
 
 			switch (request.type) {
 			case Transition::Restart:
@@ -284,33 +1067,64 @@ M<TC, TMS>::_R<TA>::processTransitions() {
 		_requests.clear();
 
 		if (changeCount > 0) {
-			Control substitutionControl(_requests);
-			_apex.deepForwardSubstitute(substitutionControl, _context, HFSM_LOGGER_OR(_logger, nullptr));
+			auto substitutionControl = control();
+			_apex.deepForwardSubstitute(substitutionControl, _context);
 
 		#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 			for (const auto& request : _requests)
 				_lastTransitions << DebugTransitionInfo(request, DebugTransitionInfo::Substitute);
 		#endif
+
+			if (_requests.count()) {
+				Index* const requested = history.pending();
+				for (unsigned f = 0; f < ForkCount; ++f)
+					requested[f] = _forkPointers[f]->requested;
+
+				// configuration requested in an earlier round already, keep it and drop the requests going round again
+				if (!history.record()) {
+					HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->cycled(id(_requests[0])));
+					HFSM_IF_SUBSTITUTION_STATS(if (_substitutionStats) ++_substitutionStats->_cycles);
+
+					_requests.clear();
+				}
+			#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+				else if (budgeted && round < MaxSubstitutions && Clock::now() - begin > _substitutionStats->_budget) {
+					HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->overBudget(id(_requests[0]), Clock::now() - begin));
+					++_substitutionStats->_overBudget;
+
+					break;
+				}
+			#endif
+			}
 		}
 	}
 
-	_apex.deepChangeToRequested(_context, HFSM_LOGGER_OR(_logger, nullptr));
+	if (_requests.count()) {
+		// still substituting after TMaxSubstitutions rounds
+		HFSM_IF_WATCHDOG(if (_watchdog && round == MaxSubstitutions) _watchdog->exhausted(id(_requests[0])));
+		HFSM_IF_SUBSTITUTION_STATS(if (_substitutionStats && round == MaxSubstitutions) ++_substitutionStats->_exhausted);
+	}
+
+	HFSM_IF_SUBSTITUTION_STATS(if (_substitutionStats) _substitutionStats->record(round));
+
+	auto control = this->control();
+	_apex.deepChangeToRequested(control, _context);
 
-	HFSM_IF_STRUCTURE(udpateActivity());
+	HFSM_IF_STRUCTURE(++_activityTick);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::requestImmediate(const Transition request) {
+M<TC, TMS, TLF>::_R<TA>::requestImmediate(const Transition request) HFSM_NOEXCEPT(true) {
 	const unsigned state = id(request);
 
 	for (auto parent = _stateParents[state]; parent; parent = _forkParents[parent.fork]) {
 		auto& fork = *_forkPointers[parent.fork];
 
-		HSFM_IF_DEBUG(fork.requestedType = parent.prongType);
+		HSFM_IF_DEBUG_TYPES(fork.requestedType = parent.prongType);
 		fork.requested = parent.prong;
 	}
 
@@ -319,38 +1133,120 @@ M<TC, TMS>::_R<TA>::requestImmediate(const Transition request) {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::requestScheduled(const Transition request) {
+M<TC, TMS, TLF>::_R<TA>::requestScheduled(const Transition request) HFSM_NOEXCEPT(true) {
 	const unsigned state = id(request);
 
 	const auto parent = _stateParents[state];
 	auto& fork = *_forkPointers[parent.fork];
 
-	HSFM_IF_ASSERT(const auto forksParent = _stateParents[fork.self]);
-	HSFM_IF_ASSERT(const auto& forksFork = *_forkPointers[forksParent.fork]);
-	assert(forksFork.active == INVALID_INDEX);
+	// only into inactive regions (fork.self is a fork id, its parent is in _forkParents)
+	HSFM_IF_ASSERT(const auto forksParent = _forkParents[fork.self]);
+	assert(!forksParent || _forkPointers[forksParent.fork]->active != forksParent.prong);
 
-	HSFM_IF_DEBUG(fork.resumableType = parent.prongType);
+	HSFM_IF_DEBUG_TYPES(fork.resumableType = parent.prongType);
 	fork.resumable = parent.prong;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+typename M<TC, TMS, TLF>::Control
+M<TC, TMS, TLF>::_R<TA>::control() HFSM_NOEXCEPT(true) {
+	return Control(_requests,
+				   &_stateRegistry
+				   HFSM_IF_LOGGER(, _sampled ? _logger : nullptr)
+				   HFSM_IF_STRUCTURE(, _activities)
+				   HFSM_IF_STRUCTURE(, _activityTick)
+				   HFSM_IF_WATCHDOG(, _watchdog)
+				   HFSM_IF_COVERAGE(, _coverage)
+				   HFSM_IF_SCRATCH(, _scratch));
+}
+
 //------------------------------------------------------------------------------
 
-#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+#ifdef HFSM_ENABLE_COVERAGE
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+unsigned
+M<TC, TMS, TLF>::_R<TA>::exportTransitions(typename Coverage::Prong* const prongs,
+										   const unsigned capacity) const
+{
+	unsigned count = 0;
+
+	if (_coverage != &_coverageSink)
+		for (unsigned state = 0; state < StateCount && count < capacity; ++state)
+			if (_coverage->switchedTo(state))
+				prongs[count++] = typename Coverage::Prong { _stateParents[state].fork, _stateParents[state].prong };
+
+	return count;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+typename M<TC, TMS, TLF>::TypeInfo
+M<TC, TMS, TLF>::_R<TA>::prongType(const unsigned fork,
+								   const unsigned prong) const
+{
+	for (unsigned s = 0; s < StateCount; ++s)
+		if (_stateParents[s].fork == fork && _stateParents[s].prong == prong)
+			return stateType(s);
+
+	TypeInfo none;
+	none.clear();
+
+	return none;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+void
+M<TC, TMS, TLF>::_R<TA>::attachSampling(LogSampling* const sampling) {
+	_sampling	   = sampling;
+	_samplingIndex = sampling ? sampling->enroll() : 0;
+	_samplingTick  = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::getStateNames() {
-	_stateInfos.clear();
-	_apex.deepGetNames((unsigned) -1, StateInfo::Composite, 0, _stateInfos);
+M<TC, TMS, TLF>::_R<TA>::sampleLogging() HFSM_NOEXCEPT(true) {
+	_sampled = !_sampling || _sampling->sample(_samplingIndex, _samplingTick++);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+M<TC, TMS, TLF>::_R<TA>::StaticStructure::StaticStructure() {
+	Apex::deepGetNames((unsigned) -1, StateInfo::Composite, 0, stateInfos);
 
 	unsigned margin = (unsigned) -1;
-	for (unsigned s = 0; s < _stateInfos.count(); ++s) {
-		const auto& state = _stateInfos[s];
-		auto& prefix      = _prefixes[s];
+	for (unsigned s = 0; s < stateInfos.count(); ++s) {
+		const auto& state = stateInfos[s];
+		auto& prefix      = prefixes[s];
 
 		if (margin > state.depth && state.name[0] != '\0')
 			margin = state.depth;
@@ -368,7 +1264,7 @@ M<TC, TMS>::_R<TA>::getStateNames() {
 				prefix[d - 1] = L' ';
 
 			for (unsigned r = s; r > state.parent; --r) {
-				auto& prefixAbove = _prefixes[r - 1];
+				auto& prefixAbove = prefixes[r - 1];
 
 				switch (prefixAbove[mark]) {
 				case L' ':
@@ -387,17 +1283,15 @@ M<TC, TMS>::_R<TA>::getStateNames() {
 	if (margin > 0)
 		margin -= 1;
 
-	_structure.clear();
-	for (unsigned s = 0; s < _stateInfos.count(); ++s) {
-		const auto& state = _stateInfos[s];
-		auto& prefix = _prefixes[s];
+	for (unsigned s = 0; s < stateInfos.count(); ++s) {
+		const auto& state = stateInfos[s];
+		auto& prefix = prefixes[s];
 		const auto space = state.depth * 2;
 
 		if (state.name[0] != L'\0') {
-			_structure << StructureEntry { false, &prefix[margin * 2], state.name };
-			_activityHistory << (char) 0;
-		} else if (s + 1 < _stateInfos.count()) {
-			auto& nextPrefix = _prefixes[s + 1];
+			structure << StructureEntry { &prefix[margin * 2], state.name, state.footprint };
+		} else if (s + 1 < stateInfos.count()) {
+			auto& nextPrefix = prefixes[s + 1];
 
 			if (s > 0)
 				for (unsigned c = 0; c <= space; ++c)
@@ -419,31 +1313,37 @@ M<TC, TMS>::_R<TA>::getStateNames() {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
-void
-M<TC, TMS>::_R<TA>::udpateActivity() {
-	for (auto& item : _structure)
-		item.isActive = false;
+const typename M<TC, TMS, TLF>::template _R<TA>::StaticStructure&
+M<TC, TMS, TLF>::_R<TA>::staticStructure() {
+	static const StaticStructure instance;
 
-	unsigned index = 0;
-	_apex.deepIsActive(true, index, _structure);
+	return instance;
+}
 
-	for (unsigned i = 0; i < _structure.count(); ++i) {
-		auto& activity = _activityHistory[i];
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-		if (_structure[i].isActive) {
-			if (activity > 0)
-				activity = activity < std::numeric_limits<char>::max() ? activity + 1 : activity;
-			else
-				activity = +1;
-		} else {
-			if (activity > 0)
-				activity = -1;
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+const MachineActivity&
+M<TC, TMS, TLF>::_R<TA>::activity() {
+	const auto& stateInfos = staticStructure().stateInfos;
+
+	_activityHistory.clear();
+
+	for (unsigned s = 0; s < stateInfos.count(); ++s)
+		if (stateInfos[s].name[0] != '\0') {
+			const auto& state = _activities[s];
+			const int age = (int) (_activityTick - state.since);
+
+			if (state.isActive)
+				_activityHistory << (char) (age < +std::numeric_limits<char>::max() ? +age : std::numeric_limits<char>::max());
 			else
-				activity = activity > std::numeric_limits<char>::min() ? activity - 1 : activity;
+				_activityHistory << (char) (age < -std::numeric_limits<char>::min() ? -age : std::numeric_limits<char>::min());
 		}
-	}
+
+	return _activityHistory;
 }
 
 #endif
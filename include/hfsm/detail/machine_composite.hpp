@@ -2,24 +2,28 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContext, unsigned TMaxSubstitutions>
-template <typename TH, typename... TS>
-struct M<TContext, TMaxSubstitutions>::_C final {
+template <typename TContext, unsigned TMaxSubstitutions, typename TLogFilter>
+template <unsigned TStateID, bool TLogScope, typename TH, typename... TS>
+struct M<TContext, TMaxSubstitutions, TLogFilter>::_C final {
 	using Head	= TH;
 	using Fork	= ForkT<Head>;
-	using State	= _S<Head>;
+	using State	= _S<TStateID, TLogScope, Head>;
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename...>
+	template <unsigned TInitialID, unsigned TN, typename...>
 	struct Sub;
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename TI, typename... TR>
-	struct Sub<TN, TI, TR...> {
-		using Initial = typename WrapState<TI>::Type;
-		using Remaining = Sub<TN + 1, TR...>;
+	// the prongs held as bases, where the empty ones take no room
+	template <unsigned TInitialID, unsigned TN, typename TI, typename... TR>
+	struct HFSM_EMPTY_BASES Sub<TInitialID, TN, TI, TR...>
+		: detail::Compact<typename WrapState<TInitialID, TLogScope, TI>::Type>
+		, detail::Compact<Sub<TInitialID + WrapState<TInitialID, TLogScope, TI>::Type::StateCount, TN + 1, TR...>>
+	{
+		using Initial = typename WrapState<TInitialID, TLogScope, TI>::Type;
+		using Remaining = Sub<TInitialID + Initial::StateCount, TN + 1, TR...>;
 
 		enum : unsigned {
 			ProngIndex	 = TN,
@@ -30,56 +34,102 @@ struct M<TContext, TMaxSubstitutions>::_C final {
 			ProngCount	 = Initial::ProngCount + Remaining::ProngCount,
 		};
 
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptSubstitute			 = Initial::NoexceptSubstitute && Remaining::NoexceptSubstitute,
+			NoexceptEnter				 = Initial::NoexceptEnter && Remaining::NoexceptEnter,
+			NoexceptUpdate				 = Initial::NoexceptUpdate && Remaining::NoexceptUpdate,
+			NoexceptUpdateAndTransition	 = Initial::NoexceptUpdateAndTransition && Remaining::NoexceptUpdateAndTransition,
+			NoexceptLeave				 = Initial::NoexceptLeave && Remaining::NoexceptLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Initial::template NoexceptReact<TEvent>::Value &&
+						Remaining::template NoexceptReact<TEvent>::Value
+			};
+		};
+	#endif
+
 		Sub(StateRegistry& stateRegistry,
 			const Index fork,
 			Parents& stateParents,
 			Parents& forkParents,
 			ForkPointers& forkPointers);
 
-		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideEnterInitial		(										 Context& context, LoggerInterface* const logger);
-		inline void wideEnter				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline void wideEnterInitial		(					   Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+		inline void wideEnter				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideUpdate				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+		inline void wideUpdate				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 		template <typename TEvent>
 		inline void wideReact				(const unsigned prong,
-											 const TEvent& event,  Control& control, Context& context, LoggerInterface* const logger);
-
-		inline void wideLeave				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
-
-		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition);
-		inline void wideRequestRemain();
-		inline void wideRequestRestart();
-		inline void wideRequestResume(const unsigned prong);
-		inline void wideChangeToRequested	(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+											 TEvent& event,  Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+		inline void wideLeave				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+		inline void wideRequestRemain() HFSM_NOEXCEPT(true);
+		inline void wideRequestRestart() HFSM_NOEXCEPT(true);
+		inline void wideRequestResume(const unsigned prong) HFSM_NOEXCEPT(true);
+		inline void wideChangeToRequested	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+		template <typename T>
+		static constexpr unsigned wideFind() {
+			return Initial::template deepFind<T>() != INVALID_STATE ?
+				   Initial::template deepFind<T>() : Remaining::template wideFind<T>();
+		}
+
+		template <typename T>
+		static constexpr unsigned wideFootprint() {
+			return Initial::template deepFind<T>() != INVALID_STATE ?
+				   Initial::template deepFootprint<T>() : Remaining::template wideFootprint<T>();
+		}
+
+		// forks: the id the next fork down the hierarchy gets
+		template <typename TLocation>
+		static constexpr void wideLocate(const unsigned fork, const unsigned forks, TLocation& location) {
+			if (location.state < TInitialID + Initial::StateCount) {
+				location.path.steps[location.path.count].fork  = fork;
+				location.path.steps[location.path.count].prong = ProngIndex;
+				++location.path.count;
+
+				Initial::deepLocate(forks, location);
+			} else
+				Remaining::wideLocate(fork, forks + Initial::ForkCount, location);
+		}
+
+	#ifdef HFSM_ENABLE_COVERAGE
+		// the state heading the prong
+		static constexpr unsigned prongState(const unsigned prong)	{ return prong == ProngIndex ? TInitialID : Remaining::prongState(prong);	}
+	#endif
 
 	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 		enum : unsigned {
 			NameCount	 = Initial::NameCount  + Remaining::NameCount,
 		};
 
-		void wideGetNames(const unsigned parent,
-						  const unsigned depth,
-						  StateInfos& stateInfos) const;
-
-		void wideIsActive(const unsigned prong,
-						  unsigned& index,
-						  MachineStructure& structure) const;
+		static void wideGetNames(const unsigned parent,
+								 const unsigned depth,
+								 StateInfos& stateInfos);
 	#endif
 
-		Initial initial;
-		Remaining remaining;
+		inline Initial&	  initial()		HFSM_NOEXCEPT(true)	{ return detail::Compact<Initial  >::get();	}
+		inline Remaining& remaining()	HFSM_NOEXCEPT(true)	{ return detail::Compact<Remaining>::get();	}
 	};
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename TI>
-	struct Sub<TN, TI> {
-		using Initial = typename WrapState<TI>::Type;
+	template <unsigned TInitialID, unsigned TN, typename TI>
+	struct Sub<TInitialID, TN, TI>
+		: detail::Compact<typename WrapState<TInitialID, TLogScope, TI>::Type>
+	{
+		using Initial = typename WrapState<TInitialID, TLogScope, TI>::Type;
 
 		enum : unsigned {
 			ProngIndex	 = TN,
@@ -90,55 +140,89 @@ struct M<TContext, TMaxSubstitutions>::_C final {
 			ProngCount	 = Initial::ProngCount,
 		};
 
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptSubstitute			 = Initial::NoexceptSubstitute,
+			NoexceptEnter				 = Initial::NoexceptEnter,
+			NoexceptUpdate				 = Initial::NoexceptUpdate,
+			NoexceptUpdateAndTransition	 = Initial::NoexceptUpdateAndTransition,
+			NoexceptLeave				 = Initial::NoexceptLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Initial::template NoexceptReact<TEvent>::Value
+			};
+		};
+	#endif
+
 		Sub(StateRegistry& stateRegistry,
 			const Index fork,
 			Parents& stateParents,
 			Parents& forkParents,
 			ForkPointers& forkPointers);
 
-		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideEnterInitial		(										 Context& context, LoggerInterface* const logger);
-		inline void wideEnter				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline void wideEnterInitial		(					   Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+		inline void wideEnter				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideUpdate				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+		inline void wideUpdate				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 		template <typename TEvent>
-		inline void wideReact				(const unsigned prong, const TEvent& event,
-																   Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideReact				(const unsigned prong, TEvent& event,
+																   Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+		inline void wideLeave				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+		inline void wideRequestRemain() HFSM_NOEXCEPT(true);
+		inline void wideRequestRestart() HFSM_NOEXCEPT(true);
+		inline void wideRequestResume(const unsigned prong) HFSM_NOEXCEPT(true);
+		inline void wideChangeToRequested	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+		template <typename T>
+		static constexpr unsigned wideFind()								{ return Initial::template deepFind<T>();	}
+
+		template <typename T>
+		static constexpr unsigned wideFootprint()							{ return Initial::template deepFootprint<T>();	}
 
-		inline void wideLeave				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		template <typename TLocation>
+		static constexpr void wideLocate(const unsigned fork, const unsigned forks, TLocation& location) {
+			location.path.steps[location.path.count].fork  = fork;
+			location.path.steps[location.path.count].prong = ProngIndex;
+			++location.path.count;
 
-		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition);
-		inline void wideRequestRemain();
-		inline void wideRequestRestart();
-		inline void wideRequestResume(const unsigned prong);
-		inline void wideChangeToRequested	(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+			Initial::deepLocate(forks, location);
+		}
+
+	#ifdef HFSM_ENABLE_COVERAGE
+		static constexpr unsigned prongState(const unsigned)			{ return TInitialID;	}
+	#endif
 
 	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 		enum : unsigned {
 			NameCount	 = Initial::NameCount,
 		};
 
-		void wideGetNames(const unsigned parent,
-						  const unsigned depth,
-						  StateInfos& stateInfos) const;
-
-		void wideIsActive(const unsigned prong,
-						  unsigned& index,
-						  MachineStructure& structure) const;
+		static void wideGetNames(const unsigned parent,
+								 const unsigned depth,
+								 StateInfos& stateInfos);
 	#endif
 
-		Initial initial;
+		inline Initial&	  initial()		HFSM_NOEXCEPT(true)	{ return detail::Compact<Initial>::get();	}
 	};
 
-	using SubStates = Sub<0, TS...>;
+	using SubStates = Sub<TStateID + 1, 0, TS...>;
 
 	//----------------------------------------------------------------------
 
 	enum : unsigned {
+		StateID		 = TStateID,
+
 		ReverseDepth = SubStates::ReverseDepth + 1,
 		DeepWidth	 = SubStates::DeepWidth,
 		StateCount	 = State::StateCount + SubStates::StateCount,
@@ -147,52 +231,116 @@ struct M<TContext, TMaxSubstitutions>::_C final {
 		Width		 = sizeof...(TS),
 	};
 
+	enum : bool {
+		RecordsHistory = historyOf<Head>(nullptr) != History::None,
+		DeepHistory	   = historyOf<Head>(nullptr) == History::Deep,
+	};
+
+#ifdef HFSM_ENABLE_NOEXCEPT
+	enum : bool {
+		NoexceptSubstitute			 = State::NoexceptSubstitute && SubStates::NoexceptSubstitute,
+		NoexceptEnter				 = State::NoexceptEnter && SubStates::NoexceptEnter,
+		NoexceptUpdate				 = State::NoexceptUpdate && SubStates::NoexceptUpdate,
+		NoexceptUpdateAndTransition	 = State::NoexceptUpdateAndTransition && SubStates::NoexceptUpdateAndTransition,
+		NoexceptLeave				 = State::NoexceptLeave && SubStates::NoexceptLeave,
+	};
+
+	template <typename TEvent>
+	struct NoexceptReact {
+		enum : bool {
+			Value = State::template NoexceptReact<TEvent>::Value &&
+					SubStates::template NoexceptReact<TEvent>::Value
+		};
+	};
+#endif
+
 	_C(StateRegistry& stateRegistry,
 	   const Parent parent,
 	   Parents& stateParents,
 	   Parents& forkParents,
 	   ForkPointers& forkPointers);
 
-	inline void deepForwardSubstitute	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepSubstitute			(Control& control, Context& context, LoggerInterface* const logger);
+	inline void deepForwardSubstitute	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+	inline void deepSubstitute			(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-	inline void deepEnterInitial		(				   Context& context, LoggerInterface* const logger);
-	inline void deepEnter				(				   Context& context, LoggerInterface* const logger);
+	inline void deepEnterInitial		(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+	inline void deepEnter				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-	inline bool deepUpdateAndTransition	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepUpdate				(				   Context& context, LoggerInterface* const logger);
+	inline bool deepUpdateAndTransition	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+	inline void deepUpdate				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 	template <typename TEvent>
-	inline void deepReact				(const TEvent& event,
-										 Control& control, Context& context, LoggerInterface* const logger);
-
-	inline void deepLeave				(				   Context& context, LoggerInterface* const logger);
-
-	inline void deepForwardRequest(const enum Transition::Type transition);
-	inline void deepRequestRemain();
-	inline void deepRequestRestart();
-	inline void deepRequestResume();
-	inline void deepChangeToRequested	(				   Context& context, LoggerInterface* const logger);
+	inline void deepReact				(TEvent& event,
+										 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+	inline void deepLeave				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+	inline void deepForwardRequest(const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+	inline void deepRequestRemain() HFSM_NOEXCEPT(true);
+	inline void deepRequestRestart() HFSM_NOEXCEPT(true);
+	inline void deepRequestResume() HFSM_NOEXCEPT(true);
+	inline void deepChangeToRequested	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+	// compile-time topology, see _R::locate()
+	template <typename T>
+	static constexpr unsigned deepFind() {
+		return std::is_same<T, Head>::value ? (unsigned) StateID : SubStates::template wideFind<T>();
+	}
+
+	// bytes taken in each machine instance, by the fork and the stored states of the subtree
+	static constexpr unsigned footprint()	{ return sizeof(_C);	}
+
+	template <typename T>
+	static constexpr unsigned deepFootprint() {
+		return std::is_same<T, Head>::value ? footprint() : SubStates::template wideFootprint<T>();
+	}
+
+	// fork: the id the region's own fork gets, in pre-order
+	template <typename TLocation>
+	static constexpr void deepLocate(const unsigned fork, TLocation& location) {
+		if (location.state == StateID)
+			location.end = StateID + StateCount;
+		else {
+			location.parent = StateID;
+			SubStates::wideLocate(fork, fork + 1, location);
+		}
+	}
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 	enum : unsigned {
 		NameCount	 = State::NameCount  + SubStates::NameCount,
 	};
 
-	void deepGetNames(const unsigned parent,
-					  const enum StateInfo::RegionType region,
-					  const unsigned depth,
-					  StateInfos& stateInfos) const;
-
-	void deepIsActive(const bool isActive,
-					  unsigned& index,
-					  MachineStructure& structure) const;
+	static void deepGetNames(const unsigned parent,
+							 const enum StateInfo::RegionType region,
+							 const unsigned depth,
+							 StateInfos& stateInfos);
 #endif
-	Fork _fork;
-	State _state;
-	SubStates _subStates;
+	// the fork first, constructed (and so registered) ahead of the sub-states' own;
+	// the state and the sub-states held as bases, where the empty ones take no room
+	struct HFSM_EMPTY_BASES Nodes
+		: Fork
+		, detail::Compact<State>
+		, detail::Compact<SubStates>
+	{
+		Nodes(StateRegistry& stateRegistry,
+			  const Parent parent,
+			  Parents& stateParents,
+			  Parents& forkParents,
+			  ForkPointers& forkPointers)
+			: Fork(parent, forkParents, forkPointers)
+			, detail::Compact<State>(stateRegistry, parent, stateParents, forkParents, forkPointers)
+			, detail::Compact<SubStates>(stateRegistry, Fork::self, stateParents, forkParents, forkPointers)
+		{}
+	};
+
+	inline Fork&	  fork()		HFSM_NOEXCEPT(true)	{ return _nodes;												}
+	inline State&	  state()		HFSM_NOEXCEPT(true)	{ return static_cast<detail::Compact<State>&>(_nodes).get();		}
+	inline SubStates& subStates()	HFSM_NOEXCEPT(true)	{ return static_cast<detail::Compact<SubStates>&>(_nodes).get();	}
+
+	Nodes _nodes;
 
-	HSFM_IF_DEBUG(const TypeInfo _type = TypeInfo::get<Head>());
+	HSFM_IF_DEBUG_TYPES(const TypeInfo _type = TypeInfo::get<Head>());
 };
 
 ////////////////////////////////////////////////////////////////////////////////
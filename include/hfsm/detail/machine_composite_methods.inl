@@ -2,169 +2,178 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-M<TC, TMS>::_C<TH, TS...>::_C(StateRegistry& stateRegistry,
-							  const Parent parent,
-							  Parents& stateParents,
-							  Parents& forkParents,
-							  ForkPointers& forkPointers)
-	: _fork(static_cast<Index>(forkPointers << &_fork), parent, forkParents)
-	, _state(stateRegistry, parent, stateParents, forkParents, forkPointers)
-	, _subStates(stateRegistry, _fork.self, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::_C(StateRegistry& stateRegistry,
+											 const Parent parent,
+											 Parents& stateParents,
+											 Parents& forkParents,
+											 ForkPointers& forkPointers)
+	: _nodes(stateRegistry, parent, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepForwardSubstitute(Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepForwardSubstitute(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.requested != INVALID_INDEX);
+	assert(fork().requested != INVALID_INDEX);
 
-	if (_fork.requested == _fork.active)
-		_subStates.wideForwardSubstitute(_fork.requested, control, context, logger);
+	if (fork().requested == fork().active)
+		subStates().wideForwardSubstitute(fork().requested, control, context);
 	else
-		_subStates.wideSubstitute		(_fork.requested, control, context, logger);
+		subStates().wideSubstitute		 (fork().requested, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepSubstitute(Control& control,
-										  Context& context,
-										  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepSubstitute(Control& control,
+														 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.requested != INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().requested != INVALID_INDEX);
 
-	if (!_state	  .deepSubstitute(				   control, context, logger))
-		_subStates.wideSubstitute(_fork.requested, control, context, logger);
+	if (!state()   .deepSubstitute(				   control, context))
+		subStates().wideSubstitute(fork().requested, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepEnterInitial(Context& context,
-											LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepEnterInitial(Control& control,
+														   Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX &&
-		   _fork.requested == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX &&
+		   fork().requested == INVALID_INDEX);
 
-	HSFM_IF_DEBUG(_fork.activeType = TypeInfo::get<typename SubStates::Initial::Head>());
-	_fork.active = 0;
+	HSFM_IF_DEBUG_TYPES(fork().activeType = TypeInfo::get<typename SubStates::Initial::Head>());
+	fork().active = 0;
 
-	_state	  .deepEnter	   (context, logger);
-	_subStates.wideEnterInitial(context, logger);
+	state()	   .deepEnter	   (control, context);
+	subStates().wideEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepEnter(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepEnter(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active	   == INVALID_INDEX &&
-		   _fork.requested != INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().requested != INVALID_INDEX);
 
-	HSFM_IF_DEBUG(_fork.activeType = _fork.requestedType);
-	_fork.active = _fork.requested;
+	HSFM_IF_DEBUG_TYPES(fork().activeType = fork().requestedType);
+	fork().active = fork().requested;
 
-	HSFM_IF_DEBUG(_fork.requestedType.clear());
-	_fork.requested = INVALID_INDEX;
+	HSFM_IF_DEBUG_TYPES(fork().requestedType.clear());
+	fork().requested = INVALID_INDEX;
 
-	_state	  .deepEnter(			   context, logger);
-	_subStates.wideEnter(_fork.active, context, logger);
+	state()	   .deepEnter(			   control, context);
+	subStates().wideEnter(fork().active, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 bool
-M<TC, TMS>::_C<TH, TS...>::deepUpdateAndTransition(Control& control,
-												   Context& context,
-												   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepUpdateAndTransition(Control& control,
+																  Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
 
-	if (_state.deepUpdateAndTransition(control, context, logger)) {
-		_subStates.wideUpdate(_fork.active, context, logger);
+	const unsigned requestCountBefore = control.requestCount();
+
+	if (state().deepUpdateAndTransition(control, context)) {
+		if (!skipsObsoleteUpdates<Head>(nullptr) ||
+			!control.leaves(requestCountBefore, StateRange{StateID, StateID + StateCount}))
+			subStates().wideUpdate(fork().active, control, context);
 
 		return true;
 	} else
-		return _subStates.wideUpdateAndTransition(_fork.active, control, context, logger);
+		return subStates().wideUpdateAndTransition(fork().active, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepUpdate(Context& context,
-									  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepUpdate(Control& control,
+													 Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
 
-	_state	  .deepUpdate(				context, logger);
-	_subStates.wideUpdate(_fork.active, context, logger);
+	state()	   .deepUpdate(				control, context);
+	subStates().wideUpdate(fork().active, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 template <typename TEvent>
 void
-M<TC, TMS>::_C<TH, TS...>::deepReact(const TEvent& event,
-									 Control& control,
-									 Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepReact(TEvent& event,
+													Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
+
+	if (control.leafFirst()) {
+		subStates().wideReact(fork().active, event, control, context);
+
+		if (!control._consumed)
+			state().deepReact(event, control, context);
+	} else {
+		state().deepReact(event, control, context);
 
-	_state	  .deepReact(			   event, control, context, logger);
-	_subStates.wideReact(_fork.active, event, control, context, logger);
+		if (!control._consumed)
+			subStates().wideReact(fork().active, event, control, context);
+	}
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepLeave(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepLeave(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
 
-	_subStates.wideLeave(_fork.active, context, logger);
-	_state	  .deepLeave(			   context, logger);
+	subStates().wideLeave(fork().active, control, context);
+	state()	   .deepLeave(			   control, context);
 
-	HSFM_IF_DEBUG(_fork.resumableType = _fork.activeType);
-	_fork.resumable = _fork.active;
+	if (RecordsHistory) {
+		HSFM_IF_DEBUG_TYPES(fork().resumableType = fork().activeType);
+		fork().resumable = fork().active;
+	}
 
-	HSFM_IF_DEBUG(_fork.activeType.clear());
-	_fork.active = INVALID_INDEX;
+	HSFM_IF_DEBUG_TYPES(fork().activeType.clear());
+	fork().active = INVALID_INDEX;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepForwardRequest(const enum Transition::Type transition) {
-	if (_fork.requested != INVALID_INDEX)
-		_subStates.wideForwardRequest(_fork.requested, transition);
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepForwardRequest(const enum Transition::Type transition) HFSM_NOEXCEPT(true) {
+	if (fork().requested != INVALID_INDEX)
+		subStates().wideForwardRequest(fork().requested, transition);
 	else
 		switch (transition) {
 		case Transition::Remain:
@@ -186,72 +195,85 @@ M<TC, TMS>::_C<TH, TS...>::deepForwardRequest(const enum Transition::Type transi
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepRequestRemain() {
-	if (_fork.active == INVALID_INDEX) {
-		HSFM_IF_DEBUG(_fork.requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
-		_fork.requested = 0;
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepRequestRemain() HFSM_NOEXCEPT(true) {
+	if (fork().active == INVALID_INDEX) {
+		HSFM_IF_DEBUG_TYPES(fork().requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
+		fork().requested = 0;
 	}
 
-	_subStates.wideRequestRemain();
+	subStates().wideRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepRequestRestart() {
-	HSFM_IF_DEBUG(_fork.requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
-	_fork.requested = 0;
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepRequestRestart() HFSM_NOEXCEPT(true) {
+	HSFM_IF_DEBUG_TYPES(fork().requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
+	fork().requested = 0;
 
-	_subStates.wideRequestRestart();
+	subStates().wideRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepRequestResume() {
-	if (_fork.resumable != INVALID_INDEX) {
-		HSFM_IF_DEBUG(_fork.requestedType = _fork.resumableType);
-		_fork.requested = _fork.resumable;
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepRequestResume() HFSM_NOEXCEPT(true) {
+	if (fork().resumable != INVALID_INDEX) {
+		HSFM_IF_DEBUG_TYPES(fork().requestedType = fork().resumableType);
+		fork().requested = fork().resumable;
+
+		// without history, a schedule()-d prong is good for a single resume()
+		if (!RecordsHistory) {
+			HSFM_IF_DEBUG_TYPES(fork().resumableType = TypeInfo());
+			fork().resumable = INVALID_INDEX;
+		}
 	} else {
-		HSFM_IF_DEBUG(_fork.requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
-		_fork.requested = 0;
+		HSFM_IF_DEBUG_TYPES(fork().requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
+		fork().requested = 0;
 	}
 
-	_subStates.wideRequestResume(_fork.requested);
+	if (DeepHistory)
+		subStates().wideRequestResume(fork().requested);
+	else
+		subStates().wideForwardRequest(fork().requested, Transition::Restart);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepChangeToRequested(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepChangeToRequested(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
 
-	if (_fork.requested == _fork.active)
-		_subStates.wideChangeToRequested(_fork.requested, context, logger);
-	else if (_fork.requested != INVALID_INDEX) {
-		_subStates.wideLeave(_fork.active, context, logger);
+	if (fork().requested == fork().active)
+		subStates().wideChangeToRequested(fork().requested, control, context);
+	else if (fork().requested != INVALID_INDEX) {
+		subStates().wideLeave(fork().active, control, context);
 
-		HSFM_IF_DEBUG(_fork.resumableType = _fork.activeType);
-		_fork.resumable = _fork.active;
+		if (RecordsHistory) {
+			HSFM_IF_DEBUG_TYPES(fork().resumableType = fork().activeType);
+			fork().resumable = fork().active;
+		}
+
+		HSFM_IF_DEBUG_TYPES(fork().activeType = fork().requestedType);
+		fork().active = fork().requested;
 
-		HSFM_IF_DEBUG(_fork.activeType = _fork.requestedType);
-		_fork.active = _fork.requested;
+		HSFM_IF_DEBUG_TYPES(fork().requestedType.clear());
+		fork().requested = INVALID_INDEX;
 
-		HSFM_IF_DEBUG(_fork.requestedType.clear());
-		_fork.requested = INVALID_INDEX;
+		HFSM_IF_COVERAGE(control.coverSwitch(SubStates::prongState(fork().active)));
 
-		_subStates.wideEnter(_fork.active, context, logger);
+		subStates().wideEnter(fork().active, control, context);
 	}
 }
 
@@ -259,31 +281,21 @@ M<TC, TMS>::_C<TH, TS...>::deepChangeToRequested(Context& context,
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepGetNames(const unsigned parent,
-										const enum StateInfo::RegionType region,
-										const unsigned depth,
-										StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepGetNames(const unsigned parent,
+													   const enum StateInfo::RegionType region,
+													   const unsigned depth,
+													   StateInfos& _stateInfos)
 {
-	_state.deepGetNames(parent, region, depth, _stateInfos);
-	_subStates.wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	State::deepGetNames(parent, region, depth, _stateInfos);
+	_stateInfos[_stateInfos.count() - 1].footprint = footprint();
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-void
-M<TC, TMS>::_C<TH, TS...>::deepIsActive(const bool isActive,
-										unsigned& index,
-										MachineStructure& structure) const
-{
-	_state.deepIsActive(isActive, index, structure);
-	_subStates.wideIsActive(isActive ? _fork.active : INVALID_INDEX, index, structure);
+	SubStates::wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
 }
 
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
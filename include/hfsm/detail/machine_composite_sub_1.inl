@@ -2,247 +2,230 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
-												  const Index fork,
-												  Parents& stateParents,
-												  Parents& forkParents,
-												  ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
-	, remaining(stateRegistry, fork, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
+																	   const Index fork,
+																	   Parents& stateParents,
+																	   Parents& forkParents,
+																	   ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
+	, detail::Compact<Remaining>(stateRegistry, fork, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
-																	Control& control,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
+																						 Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	if (prong == ProngIndex)
-		initial  .deepForwardSubstitute(	   control, context, logger);
+		initial()  .deepForwardSubstitute(	   control, context);
 	else
-		remaining.wideForwardSubstitute(prong, control, context, logger);
+		remaining().wideForwardSubstitute(prong, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideSubstitute(const unsigned prong,
-															 Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideSubstitute(const unsigned prong,
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	if (prong == ProngIndex)
-		initial  .deepSubstitute(		control, context, logger);
+		initial()  .deepSubstitute(		control, context);
 	else
-		remaining.wideSubstitute(prong, control, context, logger);
+		remaining().wideSubstitute(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideEnterInitial(Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnterInitial(Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnterInitial(context, logger);
+	initial().deepEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideEnter(const unsigned prong,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnter(const unsigned prong,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
 	if (prong == ProngIndex)
-		initial  .deepEnter(	   context, logger);
+		initial()  .deepEnter(	   control, context);
 	else
-		remaining.wideEnter(prong, context, logger);
+		remaining().wideEnter(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 bool
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideUpdateAndTransition(const unsigned prong,
-																	  Control& control,
-																	  Context& context,
-																	  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdateAndTransition(const unsigned prong,
+																						   Control& control,
+																						   Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
 	return prong == ProngIndex ?
-		initial  .deepUpdateAndTransition(		 control, context, logger) :
-		remaining.wideUpdateAndTransition(prong, control, context, logger);
+		initial()  .deepUpdateAndTransition(		 control, context) :
+		remaining().wideUpdateAndTransition(prong, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideUpdate(const unsigned prong,
-														 Context& context,
-														 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdate(const unsigned prong,
+																			  Control& control,
+																			  Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
 	if (prong == ProngIndex)
-		initial  .deepUpdate(		context, logger);
+		initial()  .deepUpdate(		control, context);
 	else
-		remaining.wideUpdate(prong, context, logger);
+		remaining().wideUpdate(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 template <typename TEvent>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideReact(const unsigned prong,
-														const TEvent& event,
-														Control& control,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideReact(const unsigned prong,
+																			 TEvent& event,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
 	if (prong == ProngIndex)
-		initial  .deepReact(	   event, control, context, logger);
+		initial()  .deepReact(	   event, control, context);
 	else
-		remaining.wideReact(prong, event, control, context, logger);
+		remaining().wideReact(prong, event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideLeave(const unsigned prong,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideLeave(const unsigned prong,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
 	if (prong == ProngIndex)
-		initial  .deepLeave(	   context, logger);
+		initial()  .deepLeave(	   control, context);
 	else
-		remaining.wideLeave(prong, context, logger);
+		remaining().wideLeave(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideForwardRequest(const unsigned prong,
-																 const enum Transition::Type transition)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardRequest(const unsigned prong,
+																					  const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	if (prong == ProngIndex)
-		initial	 .deepForwardRequest(		transition);
+		initial()  .deepForwardRequest(		transition);
 	else
-		remaining.wideForwardRequest(prong, transition);
+		remaining().wideForwardRequest(prong, transition);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideRequestRemain() {
-	initial.deepRequestRemain();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideRequestRestart() {
-	initial.deepRequestRestart();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideRequestResume(const unsigned prong) {
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestResume(const unsigned prong) HFSM_NOEXCEPT(true) {
 	if (prong == ProngIndex)
-		initial.deepRequestResume();
+		initial().deepRequestResume();
 	else
-		remaining.wideRequestResume(prong);
+		remaining().wideRequestResume(prong);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideChangeToRequested(const unsigned prong,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideChangeToRequested(const unsigned prong,
+																						 Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
 	if (prong == ProngIndex)
-		initial	 .deepChangeToRequested(	   context, logger);
+		initial()  .deepChangeToRequested(	   control, context);
 	else
-		remaining.wideChangeToRequested(prong, context, logger);
+		remaining().wideChangeToRequested(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideGetNames(const unsigned parent,
-														   const unsigned depth,
-														   StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideGetNames(const unsigned parent,
+																				const unsigned depth,
+																				StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
-	remaining.wideGetNames(parent, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
+	Remaining::wideGetNames(parent, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideIsActive(const unsigned prong,
-														   unsigned& index,
-														   MachineStructure& structure) const
-{
-	initial.deepIsActive(prong == ProngIndex, index, structure);
-	remaining.wideIsActive(prong, index, structure);
-}
 
 #endif
 
@@ -2,235 +2,219 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::Sub(StateRegistry& stateRegistry,
-										   const Index fork,
-										   Parents& stateParents,
-										   Parents& forkParents,
-										   ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::Sub(StateRegistry& stateRegistry,
+																const Index fork,
+																Parents& stateParents,
+																Parents& forkParents,
+																ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
-															 Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepForwardSubstitute(control, context, logger);
+	initial().deepForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideSubstitute(const unsigned HSFM_IF_ASSERT(prong),
-													  Control& control,
-													  Context& context,
-													  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideSubstitute(const unsigned HSFM_IF_ASSERT(prong),
+																		   Control& control,
+																		   Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepSubstitute(control, context, logger);
+	initial().deepSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideEnterInitial(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnterInitial(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnterInitial(context, logger);
+	initial().deepEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideEnter(const unsigned HSFM_IF_ASSERT(prong),
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnter(const unsigned HSFM_IF_ASSERT(prong),
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepEnter(context, logger);
+	initial().deepEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 bool
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideUpdateAndTransition(const unsigned HSFM_IF_ASSERT(prong),
-															   Control& control,
-															   Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdateAndTransition(const unsigned HSFM_IF_ASSERT(prong),
+																					Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
 	assert(prong == ProngIndex);
 
-	return initial.deepUpdateAndTransition(control, context, logger);
+	return initial().deepUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideUpdate(const unsigned HSFM_IF_ASSERT(prong),
-												  Context& context,
-												  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdate(const unsigned HSFM_IF_ASSERT(prong),
+																	   Control& control,
+																	   Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepUpdate(context, logger);
+	initial().deepUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 template <typename TEvent>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideReact(const unsigned HSFM_IF_ASSERT(prong),
-												 const TEvent& event,
-												 Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideReact(const unsigned HSFM_IF_ASSERT(prong),
+																	  TEvent& event,
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepReact(event, control, context, logger);
+	initial().deepReact(event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideLeave(const unsigned HSFM_IF_ASSERT(prong),
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideLeave(const unsigned HSFM_IF_ASSERT(prong),
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepLeave(context, logger);
+	initial().deepLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideForwardRequest(const unsigned HSFM_IF_ASSERT(prong),
-														  const enum Transition::Type transition)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardRequest(const unsigned HSFM_IF_ASSERT(prong),
+																			   const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepForwardRequest(transition);
+	initial().deepForwardRequest(transition);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideRequestRemain() {
-	initial.deepRequestRemain();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideRequestRestart() {
-	initial.deepRequestRestart();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideRequestResume(const unsigned HSFM_IF_ASSERT(prong)) {
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestResume(const unsigned HSFM_IF_ASSERT(prong)) HFSM_NOEXCEPT(true) {
 	assert(prong == ProngIndex);
 
-	initial.deepRequestResume();
+	initial().deepRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideChangeToRequested(const unsigned HSFM_IF_ASSERT(prong),
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideChangeToRequested(const unsigned HSFM_IF_ASSERT(prong),
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepChangeToRequested(context, logger);
+	initial().deepChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideGetNames(const unsigned parent,
-													const unsigned depth,
-													StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideGetNames(const unsigned parent,
+																		 const unsigned depth,
+																		 StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideIsActive(const unsigned prong,
-													unsigned& index,
-													MachineStructure& structure) const
-{
-	initial.deepIsActive(prong == ProngIndex, index, structure);
-}
 
 #endif
 
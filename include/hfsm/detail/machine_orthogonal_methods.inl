@@ -2,162 +2,169 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-M<TC, TMS>::_O<TH, TS...>::_O(StateRegistry& stateRegistry,
-							  const Parent parent,
-							  Parents& stateParents,
-							  Parents& forkParents,
-							  ForkPointers& forkPointers)
-	: _fork(static_cast<Index>(forkPointers << &_fork), parent, forkParents)
-	, _state(stateRegistry, parent, stateParents, forkParents, forkPointers)
-	, _subStates(stateRegistry, _fork.self, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::_O(StateRegistry& stateRegistry,
+											 const Parent parent,
+											 Parents& stateParents,
+											 Parents& forkParents,
+											 ForkPointers& forkPointers)
+	: _nodes(stateRegistry, parent, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepForwardSubstitute(Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepForwardSubstitute(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	if (_fork.requested != INVALID_INDEX)
-		_subStates.wideForwardSubstitute(_fork.requested, control, context, logger);
+	if (fork().requested != INVALID_INDEX)
+		subStates().wideForwardSubstitute(fork().requested, control, context);
 	else
-		_subStates.wideForwardSubstitute(				  control, context, logger);
+		subStates().wideForwardSubstitute(				  control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepSubstitute(Control& control,
-										  Context& context,
-										  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepSubstitute(Control& control,
+														 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	if (!_state	  .deepSubstitute(control, context, logger))
-		_subStates.wideSubstitute(control, context, logger);
+	if (!state()   .deepSubstitute(control, context))
+		subStates().wideSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepEnterInitial(Context& context,
-											LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepEnterInitial(Control& control,
+														   Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX &&
-		   _fork.requested == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX &&
+		   fork().requested == INVALID_INDEX);
 
-	_state	  .deepEnter	   (context, logger);
-	_subStates.wideEnterInitial(context, logger);
+	state()	   .deepEnter	   (control, context);
+	subStates().wideEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepEnter(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepEnter(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_state	  .deepEnter(context, logger);
-	_subStates.wideEnter(context, logger);
+	state()	   .deepEnter(control, context);
+	subStates().wideEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 bool
-M<TC, TMS>::_O<TH, TS...>::deepUpdateAndTransition(Control& control,
-												   Context& context,
-												   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepUpdateAndTransition(Control& control,
+																  Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	if (_state.deepUpdateAndTransition(control, context, logger)) {
-		_subStates.wideUpdate(context, logger);
+	const unsigned requestCountBefore = control.requestCount();
+
+	if (state().deepUpdateAndTransition(control, context)) {
+		if (!skipsObsoleteUpdates<Head>(nullptr) ||
+			!control.leaves(requestCountBefore, StateRange{StateID, StateID + StateCount}))
+			subStates().wideUpdate(control, context);
 
 		return true;
 	} else
-		return _subStates.wideUpdateAndTransition(control, context, logger);
+		return subStates().wideUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepUpdate(Context& context,
-									  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepUpdate(Control& control,
+													 Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_state	  .deepUpdate(context, logger);
-	_subStates.wideUpdate(context, logger);
+	state()	   .deepUpdate(control, context);
+	subStates().wideUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 template <typename TEvent>
 void
-M<TC, TMS>::_O<TH, TS...>::deepReact(const TEvent& event,
-									 Control& control,
-									 Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepReact(TEvent& event,
+													Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
+
+	if (control.leafFirst()) {
+		subStates().wideReact(event, control, context);
+
+		if (!control._consumed)
+			state().deepReact(event, control, context);
+	} else {
+		state().deepReact(event, control, context);
 
-	_state	  .deepReact(event, control, context, logger);
-	_subStates.wideReact(event, control, context, logger);
+		if (!control._consumed)
+			subStates().wideReact(event, control, context);
+	}
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepLeave(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepLeave(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideLeave(context, logger);
-	_state	  .deepLeave(context, logger);
+	subStates().wideLeave(control, context);
+	state()	   .deepLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepForwardRequest(const enum Transition::Type transition) {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepForwardRequest(const enum Transition::Type transition) HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	if (_fork.requested != INVALID_INDEX)
-		_subStates.wideForwardRequest(_fork.requested, transition);
+	if (fork().requested != INVALID_INDEX)
+		subStates().wideForwardRequest(fork().requested, transition);
 	else
 		switch (transition) {
 		case Transition::Remain:
@@ -179,83 +186,73 @@ M<TC, TMS>::_O<TH, TS...>::deepForwardRequest(const enum Transition::Type transi
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepRequestRemain() {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepRequestRemain() HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideRequestRemain();
+	subStates().wideRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepRequestRestart() {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepRequestRestart() HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideRequestRestart();
+	subStates().wideRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepRequestResume() {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepRequestResume() HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideRequestResume();
+	subStates().wideRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepChangeToRequested(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepChangeToRequested(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideChangeToRequested(context, logger);
+	subStates().wideChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepGetNames(const unsigned parent,
-										const enum StateInfo::RegionType region,
-										const unsigned depth,
-										StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepGetNames(const unsigned parent,
+													   const enum StateInfo::RegionType region,
+													   const unsigned depth,
+													   StateInfos& _stateInfos)
 {
-	_state.deepGetNames(parent, region, depth, _stateInfos);
-	_subStates.wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
-}
+	State::deepGetNames(parent, region, depth, _stateInfos);
+	_stateInfos[_stateInfos.count() - 1].footprint = footprint();
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-void
-M<TC, TMS>::_O<TH, TS...>::deepIsActive(const bool isActive,
-										unsigned& index,
-										MachineStructure& structure) const
-{
-	_state.deepIsActive(isActive, index, structure);
-	_subStates.wideIsActive(isActive, index, structure);
+	SubStates::wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
 }
 
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2,245 +2,230 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
-											  const Index fork,
-											  Parents& stateParents,
-											  Parents& forkParents,
-											  ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
-	, remaining(stateRegistry, fork, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
+																	   const Index fork,
+																	   Parents& stateParents,
+																	   Parents& forkParents,
+																	   ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
+	, detail::Compact<Remaining>(stateRegistry, fork, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
-																	Control& control,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
+																						 Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	if (prong == ProngIndex)
-		initial  .deepForwardSubstitute(	   control, context, logger);
+		initial()  .deepForwardSubstitute(	   control, context);
 	else
-		remaining.wideForwardSubstitute(prong, control, context, logger);
+		remaining().wideForwardSubstitute(prong, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideForwardSubstitute(Control& control,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardSubstitute(Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial	 .deepForwardSubstitute(control, context, logger);
-	remaining.wideForwardSubstitute(control, context, logger);
+	initial()  .deepForwardSubstitute(control, context);
+	remaining().wideForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideSubstitute(Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideSubstitute(Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial	 .deepSubstitute(control, context, logger);
-	remaining.wideSubstitute(control, context, logger);
+	initial()  .deepSubstitute(control, context);
+	remaining().wideSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideEnterInitial(Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnterInitial(Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial  .deepEnterInitial(context, logger);
-	remaining.wideEnterInitial(context, logger);
+	initial()  .deepEnterInitial(control, context);
+	remaining().wideEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideEnter(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnter(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial  .deepEnter(context, logger);
-	remaining.wideEnter(context, logger);
+	initial()  .deepEnter(control, context);
+	remaining().wideEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 bool
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideUpdateAndTransition(Control& control,
-																	  Context& context,
-																	  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdateAndTransition(Control& control,
+																						   Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	return initial  .deepUpdateAndTransition(control, context, logger)
-		|| remaining.wideUpdateAndTransition(control, context, logger);
+	return initial()  .deepUpdateAndTransition(control, context)
+		|| remaining().wideUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideUpdate(Context& context,
-														 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdate(Control& control,
+																			  Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	initial  .deepUpdate(context, logger);
-	remaining.wideUpdate(context, logger);
+	initial()  .deepUpdate(control, context);
+	remaining().wideUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 template <typename TEvent>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideReact(const TEvent& event,
-														Control& control,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideReact(TEvent& event,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	initial  .deepReact(event, control, context, logger);
-	remaining.wideReact(event, control, context, logger);
+	initial().deepReact(event, control, context);
+
+	// the regions past the consumer are skipped
+	if (!control._consumed)
+		remaining().wideReact(event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideLeave(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideLeave(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	initial	 .deepLeave(context, logger);
-	remaining.wideLeave(context, logger);
+	initial()  .deepLeave(control, context);
+	remaining().wideLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideForwardRequest(const unsigned prong,
-																 const enum Transition::Type transition)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardRequest(const unsigned prong,
+																					  const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	if (prong == ProngIndex) {
-		initial.deepForwardRequest(transition);
-		remaining.wideForwardRequest(prong, Transition::Remain);
+		initial().deepForwardRequest(transition);
+		remaining().wideForwardRequest(prong, Transition::Remain);
 	} else {
-		initial.deepForwardRequest(Transition::Remain);
-		remaining.wideForwardRequest(prong, transition);
+		initial().deepForwardRequest(Transition::Remain);
+		remaining().wideForwardRequest(prong, transition);
 	}
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideRequestRemain() {
-	initial.deepRequestRemain();
-	remaining.wideRequestRemain();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
+	remaining().wideRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideRequestRestart() {
-	initial.deepRequestRestart();
-	remaining.wideRequestRestart();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
+	remaining().wideRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideRequestResume() {
-	initial.deepRequestResume();
-	remaining.wideRequestResume();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestResume() HFSM_NOEXCEPT(true) {
+	initial().deepRequestResume();
+	remaining().wideRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideChangeToRequested(Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideChangeToRequested(Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	initial	 .deepChangeToRequested(context, logger);
-	remaining.wideChangeToRequested(context, logger);
+	initial()  .deepChangeToRequested(control, context);
+	remaining().wideChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideGetNames(const unsigned parent,
-														   const unsigned depth,
-														   StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideGetNames(const unsigned parent,
+																				const unsigned depth,
+																				StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
-	remaining.wideGetNames(parent, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
+	Remaining::wideGetNames(parent, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideIsActive(const bool isActive,
-														   unsigned& index,
-														   MachineStructure& structure) const
-{
-	initial.deepIsActive(isActive, index, structure);
-	remaining.wideIsActive(isActive, index, structure);
-}
 
 #endif
 
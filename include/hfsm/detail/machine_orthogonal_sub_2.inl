@@ -2,228 +2,211 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::Sub(StateRegistry& stateRegistry,
-										   const Index fork,
-										   Parents& stateParents,
-										   Parents& forkParents,
-										   ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::Sub(StateRegistry& stateRegistry,
+																const Index fork,
+																Parents& stateParents,
+																Parents& forkParents,
+																ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
-															 Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepForwardSubstitute(control, context, logger);
+	initial().deepForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideForwardSubstitute(Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardSubstitute(Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial.deepForwardSubstitute(control, context, logger);
+	initial().deepForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideSubstitute(Control& control,
-													  Context& context,
-													  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideSubstitute(Control& control,
+																		   Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial.deepSubstitute(control, context, logger);
+	initial().deepSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideEnterInitial(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnterInitial(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnterInitial(context, logger);
+	initial().deepEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideEnter(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnter(Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnter(context, logger);
+	initial().deepEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 bool
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideUpdateAndTransition(Control& control,
-															   Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdateAndTransition(Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	return initial.deepUpdateAndTransition(control, context, logger);
+	return initial().deepUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideUpdate(Context& context,
-												  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdate(Control& control,
+																	   Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	initial.deepUpdate(context, logger);
+	initial().deepUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 template <typename TEvent>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideReact(const TEvent& event,
-												 Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideReact(TEvent& event,
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	initial.deepReact(event, control, context, logger);
+	initial().deepReact(event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideLeave(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideLeave(Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	initial.deepLeave(context, logger);
+	initial().deepLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideForwardRequest(const unsigned prong,
-														  const enum Transition::Type transition)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardRequest(const unsigned prong,
+																			   const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	assert(prong <= ProngIndex);
 
 	if (prong == ProngIndex)
-		initial.deepForwardRequest(transition);
+		initial().deepForwardRequest(transition);
 	else
-		initial.deepForwardRequest(Transition::Remain);
+		initial().deepForwardRequest(Transition::Remain);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideRequestRemain() {
-	initial.deepRequestRemain();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideRequestRestart() {
-	initial.deepRequestRestart();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideRequestResume() {
-	initial.deepRequestResume();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestResume() HFSM_NOEXCEPT(true) {
+	initial().deepRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideChangeToRequested(Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideChangeToRequested(Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	initial.deepChangeToRequested(context, logger);
+	initial().deepChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideGetNames(const unsigned parent,
-													const unsigned depth,
-													StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideGetNames(const unsigned parent,
+																		 const unsigned depth,
+																		 StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideIsActive(const bool isActive,
-													unsigned& index,
-													MachineStructure& structure) const
-{
-	initial.deepIsActive(isActive, index, structure);
-}
 
 #endif
 
@@ -2,12 +2,17 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContext, unsigned TMaxSubstitutions>
-template <typename TH>
-struct M<TContext, TMaxSubstitutions>::_S {
+template <typename TContext, unsigned TMaxSubstitutions, typename TLogFilter>
+template <unsigned TStateID, bool TLogScope, typename TH>
+struct M<TContext, TMaxSubstitutions, TLogFilter>::_S
+	: HeadT<TStateID, TH>
+{
 	using Head = TH;
+	using HeadT<TStateID, TH>::head;
 
 	enum : unsigned {
+		StateID		 = TStateID,
+
 		ReverseDepth = 1,
 		DeepWidth	 = 0,
 		StateCount	 = 1,
@@ -16,32 +21,106 @@ struct M<TContext, TMaxSubstitutions>::_S {
 		Width		 = 1,
 	};
 
+#ifdef HFSM_ENABLE_NOEXCEPT
+	// user callbacks, together with the injections' pre- / post- calls
+	enum : bool {
+	#ifdef HFSM_ENABLE_LOG_INTERFACE
+		NoexceptLog					 = noexcept(std::declval<LoggerInterface&>().record(std::declval<const LoggerInterface::StateType&>(),
+																						nullptr,
+																						LoggerInterface::Method::Enter,
+																						nullptr)),
+	#else
+		NoexceptLog					 = true,
+	#endif
+
+		NoexceptSubstitute			 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().widePreSubstitute(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().substitute(std::declval<Control&>(), std::declval<Context&>())),
+
+		NoexceptEnter				 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().widePreEnter(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().enter(std::declval<Context&>())),
+
+		NoexceptUpdate				 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().widePreUpdate(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().update(std::declval<Context&>())),
+
+		NoexceptUpdateAndTransition	 = NoexceptUpdate &&
+									   noexcept(std::declval<Head&>().widePreTransition(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().transition(std::declval<Control&>(), std::declval<Context&>())),
+
+		NoexceptLeave				 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().leave(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().widePostLeave(std::declval<Context&>())),
+	};
+
+	// TEvent is const, unless the event was passed to react() as an rvalue
+	template <typename TEvent>
+	struct NoexceptReact {
+		enum : bool {
+			Value = NoexceptLog &&
+					noexcept(std::declval<Head&>().widePreReact(std::declval<const TEvent&>(), std::declval<Context&>())) &&
+					noexcept(std::declval<Head&>().react(std::declval<PassedEvent<Head, TEvent>>(), std::declval<Control&>(), std::declval<Context&>()))
+		};
+	};
+#endif
+
 	_S(StateRegistry& stateRegistry,
 	   const Parent parent,
 	   Parents& stateParents,
 	   Parents& forkParents,
 	   ForkPointers& forkPointers);
 
-	inline void deepForwardSubstitute	(Control&,		   Context&,		 LoggerInterface* const)		{}
-	inline bool deepSubstitute			(Control& control, Context& context, LoggerInterface* const logger);
+	inline void deepForwardSubstitute	(Control&,		   Context&) HFSM_NOEXCEPT(true)	{}
+	inline bool deepSubstitute			(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+
+	inline void deepEnterInitial		(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+	inline void deepEnter				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-	inline void deepEnterInitial		(				   Context& context, LoggerInterface* const logger);
-	inline void deepEnter				(				   Context& context, LoggerInterface* const logger);
+	inline bool deepUpdateAndTransition	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+	inline void deepUpdate				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
-	inline bool deepUpdateAndTransition	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepUpdate				(				   Context& context, LoggerInterface* const logger);
+	template <typename TEvent>
+	inline void deepReact				(TEvent& event,
+										 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+	inline void deepLeave				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+	inline void deepForwardRequest(const enum Transition::Type) HFSM_NOEXCEPT(true)			{}
+	inline void deepRequestRemain() HFSM_NOEXCEPT(true)										{}
+	inline void deepRequestRestart() HFSM_NOEXCEPT(true)									{}
+	inline void deepRequestResume() HFSM_NOEXCEPT(true)										{}
+	inline void deepChangeToRequested	(Control&,		   Context&) HFSM_NOEXCEPT(true)	{}
+
+#ifdef HFSM_ENABLE_SCRATCH
+	// opted in with a ScratchT<> injection
+	using UsesScratch = std::is_base_of<Scratch, Head>;
+
+	inline void scratchEnter(Control& control, std::true_type)	HFSM_NOEXCEPT(true)	{ control.scratchEnter(StateID, head());	}
+	inline void scratchEnter(Control&,		   std::false_type)	HFSM_NOEXCEPT(true)	{}
+
+	inline void scratchLeave(Control& control, std::true_type)	HFSM_NOEXCEPT(true)	{ control.scratchLeave(head());			}
+	inline void scratchLeave(Control&,		   std::false_type)	HFSM_NOEXCEPT(true)	{}
+#endif
 
+#if defined HFSM_ENABLE_EVENT_STATS || defined HFSM_ENABLE_LOG_INTERFACE
+	// the default Base::react() returns Unhandled, overrides are picked ahead of it
 	template <typename TEvent>
-	inline void deepReact				(const TEvent& event,
-										 Control& control, Context& context, LoggerInterface* const logger);
+	struct Handles {
+		enum : bool {
+			Value = !std::is_same<decltype(std::declval<Head&>().react(std::declval<PassedEvent<Head, TEvent>>(),
+																		std::declval<Control&>(),
+																		std::declval<Context&>())),
+								  Unhandled>::value
+		};
+	};
+#endif
 
-	inline void deepLeave				(				   Context& context, LoggerInterface* const logger);
+	template <typename T>
+	static constexpr unsigned deepFind()							{ return std::is_same<T, Head>::value ? (unsigned) StateID : (unsigned) INVALID_STATE;	}
 
-	inline void deepForwardRequest(const enum Transition::Type)												{}
-	inline void deepRequestRemain()																			{}
-	inline void deepRequestRestart()																		{}
-	inline void deepRequestResume()																			{}
-	inline void deepChangeToRequested	(				   Context&,		 LoggerInterface* const)		{}
+	template <typename TLocation>
+	static constexpr void deepLocate(const unsigned, TLocation& location)	{ location.end = StateID + 1;	}
 
 #if defined HFSM_ENABLE_STRUCTURE_REPORT || defined HFSM_ENABLE_LOG_INTERFACE
 	static constexpr bool isBare()		{ return std::is_same<Head, Base>::value; }
@@ -51,21 +130,23 @@ struct M<TContext, TMaxSubstitutions>::_S {
 	};
 #endif
 
-#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-	static const char* name();
+	// bytes taken in each machine instance, 0 for the states that aren't stored
+	static constexpr unsigned footprint()	{ return std::is_empty<_S>::value ? 0 : sizeof(_S);				}
+
+	template <typename T>
+	static constexpr unsigned deepFootprint()						{ return std::is_same<T, Head>::value ? footprint() : 0;	}
 
-	void deepGetNames(const unsigned parent,
-					  const enum StateInfo::RegionType region,
-					  const unsigned depth,
-					  StateInfos& stateInfos) const;
+#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+	static constexpr const char* name()		{ return isBare() ? "" : detail::TypeName<Head>::unqualified();	}
 
-	void deepIsActive(const bool isActive,
-					  unsigned& index,
-					  MachineStructure& structure) const;
+	static void deepGetNames(const unsigned parent,
+							 const enum StateInfo::RegionType region,
+							 const unsigned depth,
+							 StateInfos& stateInfos);
 #endif
 
 #ifdef HFSM_ENABLE_LOG_INTERFACE
-	static const char* fullName();
+	static constexpr const char* fullName()	{ return isBare() ? "" : detail::TypeName<Head>::qualified();	}
 
 	template <typename>
 	struct MemberTraits;
@@ -75,20 +156,41 @@ struct M<TContext, TMaxSubstitutions>::_S {
 		using State = TState;
 	};
 
-	template <typename TMethodType, LoggerInterface::Method>
-	typename std::enable_if< std::is_same<typename MemberTraits<TMethodType>::State, Base>::value>::type
+#ifdef __cpp_noexcept_function_type
+	template <typename TReturn, typename TState, typename... TArgs>
+	struct MemberTraits<TReturn(TState::*)(TArgs...) noexcept> {
+		using State = TState;
+	};
+#endif
+
+	// not inherited from Base
+	template <typename TMethodType>
+	struct Overridden {
+		enum : bool {
+			Value = !std::is_same<typename MemberTraits<TMethodType>::State, Base>::value
+		};
+	};
+
+	// overridden by the state, and selected by the log filter
+	template <bool TOverridden, LoggerInterface::Method TMethodId>
+	struct Logged {
+		enum : bool {
+			Value = TOverridden && TLogScope && TLogFilter::logs((unsigned) TMethodId)
+		};
+	};
+
+	template <bool TOverridden, LoggerInterface::Method TMethodId>
+	typename std::enable_if<!Logged<TOverridden, TMethodId>::Value>::type
 	log(LoggerInterface&) const {}
 
-	template <typename TMethodType, LoggerInterface::Method TMethodId>
-	typename std::enable_if<!std::is_same<typename MemberTraits<TMethodType>::State, Base>::value>::type
+	template <bool TOverridden, LoggerInterface::Method TMethodId>
+	typename std::enable_if< Logged<TOverridden, TMethodId>::Value>::type
 	log(LoggerInterface& logger) const {
-		logger.record(typeid(Head), fullName(), TMethodId, methodName(TMethodId));
+		logger.record(*TypeInfo::get<Head>(), fullName(), TMethodId, methodName(TMethodId));
 	}
 #endif
 
-	Head _head;
-
-	HSFM_IF_DEBUG(const TypeInfo _type = TypeInfo::get<Head>());
+	HSFM_IF_DEBUG_TYPES(const TypeInfo _type = TypeInfo::get<Head>());
 };
 
 ////////////////////////////////////////////////////////////////////////////////
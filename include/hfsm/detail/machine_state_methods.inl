@@ -2,228 +2,177 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename TH>
-M<TC, TMS>::_S<TH>::_S(StateRegistry& stateRegistry,
-					   const Parent parent,
-					   Parents& stateParents,
-					   Parents& /*forkParents*/,
-					   ForkPointers& /*forkPointers*/)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::_S(StateRegistry& stateRegistry,
+									  const Parent parent,
+									  Parents& stateParents,
+									  Parents& /*forkParents*/,
+									  ForkPointers& /*forkPointers*/)
 {
 	const auto id = stateRegistry.add(TypeInfo::get<Head>());
+	assert(id == StateID);
+
 	stateParents[id] = parent;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 bool
-M<TC, TMS>::_S<TH>::deepSubstitute(Control& control,
-								   Context& context,
-								   LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepSubstitute(Control& control,
+												  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::substitute), LoggerInterface::Method::Substitute>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::substitute)>::Value, LoggerInterface::Method::Substitute>(*control._logger));
 
 	const unsigned requestCountBefore = control.requestCount();
 
-	_head.widePreSubstitute(context);
-	_head.substitute(control, context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreSubstitute(context);
+	head().substitute(control, context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Substitute, watch));
 
 	return requestCountBefore < control.requestCount();
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepEnterInitial(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepEnterInitial(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	deepEnter(context, logger);
+	deepEnter(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepEnter(Context& context,
-							  LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepEnter(Control& control,
+											 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::enter), LoggerInterface::Method::Enter>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::enter)>::Value, LoggerInterface::Method::Enter>(*control._logger));
+
+	HFSM_IF_STRUCTURE(control.notifyEnter(StateID));
+	HFSM_IF_WATCHDOG(control.watchEnter(StateID));
+	HFSM_IF_COVERAGE(control.coverEnter(StateID));
+	HFSM_IF_SCRATCH(scratchEnter(control, UsesScratch{}));
 
-	_head.widePreEnter(context);
-	_head.enter(context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreEnter(context);
+	head().enter(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Enter, watch));
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 bool
-M<TC, TMS>::_S<TH>::deepUpdateAndTransition(Control& control,
-											Context& context,
-											LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepUpdateAndTransition(Control& control,
+														   Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::update), LoggerInterface::Method::Update>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::update)>::Value, LoggerInterface::Method::Update>(*control._logger));
 
-	_head.widePreUpdate(context);
-	_head.update(context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreUpdate(context);
+	head().update(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Update, watch));
 
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::transition), LoggerInterface::Method::Transition>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::transition)>::Value, LoggerInterface::Method::Transition>(*control._logger));
 
 	const unsigned requestCountBefore = control.requestCount();
 
-	_head.widePreTransition(context);
-	_head.transition(control, context);
+	HFSM_IF_WATCHDOG(const auto transitionWatch = control.watchBegin());
+	head().widePreTransition(context);
+	head().transition(control, context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Transition, transitionWatch));
 
 	return requestCountBefore < control.requestCount();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepUpdate(Context& context,
-							   LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepUpdate(Control& control,
+											  Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::update), LoggerInterface::Method::Update>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::update)>::Value, LoggerInterface::Method::Update>(*control._logger));
 
-	_head.widePreUpdate(context);
-	_head.update(context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreUpdate(context);
+	head().update(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Update, watch));
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 template <typename TEvent>
 void
-M<TC, TMS>::_S<TH>::deepReact(const TEvent& event,
-							  Control& control,
-							  Context& context,
-							  LoggerInterface* const HFSM_IF_LOGGER(logger))
-{
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::template react<TEvent>), LoggerInterface::Method::React>(*logger));
-
-	_head.widePreReact(event, context);
-	_head.react(event, control, context);
-}
-
-//------------------------------------------------------------------------------
-
-template <typename TC, unsigned TMS>
-template <typename TH>
-void
-M<TC, TMS>::_S<TH>::deepLeave(Context& context,
-							  LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepReact(TEvent& event,
+											 Control& control,
+											 Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::leave), LoggerInterface::Method::Leave>(*logger));
-
-	_head.leave(context);
-	_head.widePostLeave(context);
-}
-
-//------------------------------------------------------------------------------
-
-#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-
-template <typename TC, unsigned TMS>
-template <typename TH>
-const char*
-M<TC, TMS>::_S<TH>::name() {
-	if (isBare())
-		return "";
-	else {
-		const char* const raw = TypeInfo::get<Head>()->name();
-
-	#if defined(_MSC_VER)
-
-		unsigned first =
-			raw[0] == 's' ? 7 : // Struct
-			raw[0] == 'c' ? 6 : // Class
-							0;
-
-		for (auto c = first; raw[c]; ++c)
-			if (raw[c] == ':')
-				first = c + 1;
+	HFSM_IF_LOGGER(if (control._logger) log<Handles<TEvent>::Value, LoggerInterface::Method::React>(*control._logger));
 
-		return raw + first;
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreReact(event, context);
 
-	#elif defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
+	// an rvalue for the react(TEvent&&) overloads, which take the event over
+	head().react(static_cast<PassedEvent<Head, TEvent>>(event), control, context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::React, watch));
 
-		return raw;
+	if (takesOver<Head, TEvent>(nullptr))
+		control.consume();
 
-	#else
+	if (control._consumed && control._consumer == Reaction::NONE)
+		control._consumer = StateID;
 
-		return raw;
-
-	#endif
-	}
+	HFSM_IF_EVENT_STATS(control.countReact(Handles<TEvent>::Value));
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepGetNames(const unsigned parent,
-								 const enum StateInfo::RegionType region,
-								 const unsigned depth,
-								 StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepLeave(Control& control,
+											 Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	_stateInfos << StateInfo { parent, region, depth, name() };
-}
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::leave)>::Value, LoggerInterface::Method::Leave>(*control._logger));
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().leave(context);
+	head().widePostLeave(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Leave, watch));
 
-template <typename TC, unsigned TMS>
-template <typename TH>
-void
-M<TC, TMS>::_S<TH>::deepIsActive(const bool isActive,
-								 unsigned& index,
-								 MachineStructure& structure) const
-{
-	if (!isBare())
-		structure[index++].isActive = isActive;
-}
+	// released in bulk, after the state is done with it
+	HFSM_IF_SCRATCH(scratchLeave(control, UsesScratch{}));
 
-#endif
+	HFSM_IF_STRUCTURE(control.notifyLeave(StateID));
+}
 
 //------------------------------------------------------------------------------
 
-#ifdef HFSM_ENABLE_LOG_INTERFACE
-
-template <typename TC, unsigned TMS>
-template <typename TH>
-const char*
-M<TC, TMS>::_S<TH>::fullName() {
-	if (isBare())
-		return "";
-	else {
-		const char* const raw = TypeInfo::get<Head>()->name();
-
-	#if defined(_MSC_VER)
-
-		unsigned first =
-			raw[0] == 's' ? 7 : // Struct
-			raw[0] == 'c' ? 6 : // Class
-							0;
-		return raw + first;
-
-	#elif defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
-
-		return raw;
-
-	#else
-
-		return raw;
+#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-	#endif
-	}
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
+void
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepGetNames(const unsigned parent,
+												const enum StateInfo::RegionType region,
+												const unsigned depth,
+												StateInfos& _stateInfos)
+{
+	_stateInfos << StateInfo { parent, region, depth, name(), footprint() };
 }
 
 #endif
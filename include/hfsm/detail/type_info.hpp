@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "wrap.hpp"
 
 namespace hfsm {
@@ -7,23 +9,52 @@ namespace detail {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#if !defined(__GXX_RTTI) && !defined(_CPPRTTI)
+
+// without rtti, the address of a per-type tag stands in for std::type_index
+template <typename T>
+struct TypeTag {
+	static char tag;
+};
+
+template <typename T>
+char TypeTag<T>::tag;
+
+#endif
+
+//------------------------------------------------------------------------------
+
 class TypeInfo
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
 	: public Wrap<std::type_index>
 {
 	using Base = Wrap<std::type_index>;
 
 public:
 	typedef std::type_index Native;
+#else
+	: public Wrap<const void*>
+{
+	using Base = Wrap<const void*>;
+
+public:
+	typedef const void* Native;
+#endif
 
 public:
 	inline TypeInfo() = default;
 
-	inline TypeInfo(const std::type_index type)
+	inline TypeInfo(const Native type)
 		: Base(type)
 	{}
 
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
 	template <typename T>
 	static inline TypeInfo get() { return TypeInfo(typeid(T)); }
+#else
+	template <typename T>
+	static inline TypeInfo get() { return TypeInfo(&TypeTag<T>::tag); }
+#endif
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <utility>
+
+namespace hfsm {
+namespace detail {
+
+// compile-time type names, cut out of the compiler-generated function signature
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+	#define HFSM_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+	#define HFSM_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+constexpr const char*
+signature() {
+	return HFSM_FUNCTION_SIGNATURE;
+}
+
+#undef HFSM_FUNCTION_SIGNATURE
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+constexpr unsigned
+length(const char* const s) {
+	unsigned l = 0;
+	while (s[l])
+		++l;
+
+	return l;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+constexpr bool
+startsWith(const char* const s, const char* const prefix) {
+	for (unsigned i = 0; prefix[i]; ++i)
+		if (s[i] != prefix[i])
+			return false;
+
+	return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+constexpr unsigned
+find(const char* const s, const char* const pattern) {
+	for (unsigned i = 0; s[i]; ++i)
+		if (startsWith(s + i, pattern))
+			return i;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+// the signature of a known type tells where a type name starts and how much trails it
+struct SignatureLayout {
+	enum : unsigned {
+		Prefix = find(signature<double>(), "double"),
+		Suffix = length(signature<double>()) - Prefix - 6,
+	};
+};
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+struct TypeName {
+	// 'struct ' / 'class ' on msvc
+	static constexpr unsigned qualifiedBegin() {
+		return SignatureLayout::Prefix +
+			   (startsWith(signature<T>() + SignatureLayout::Prefix, "struct ") ? 7 :
+				startsWith(signature<T>() + SignatureLayout::Prefix, "class ")  ? 6 : 0);
+	}
+
+	static constexpr unsigned end() {
+		return length(signature<T>()) - SignatureLayout::Suffix;
+	}
+
+	// past the last '::' outside of template arguments
+	static constexpr unsigned unqualifiedBegin() {
+		unsigned begin = qualifiedBegin();
+
+		int depth = 0;
+		for (unsigned i = begin; i + 1 < end(); ++i) {
+			const char c = signature<T>()[i];
+
+			if (c == '<')
+				++depth;
+			else if (c == '>')
+				--depth;
+			else if (depth == 0 && c == ':' && signature<T>()[i + 1] == ':')
+				begin = i + 2;
+		}
+
+		return begin;
+	}
+
+	template <unsigned TBegin, typename>
+	struct Storage;
+
+	template <unsigned TBegin, std::size_t... TI>
+	struct Storage<TBegin, std::index_sequence<TI...>> {
+		static constexpr char value[] = { signature<T>()[TBegin + TI]..., '\0' };
+	};
+
+	using Qualified	  = Storage<qualifiedBegin(),	std::make_index_sequence<end() - qualifiedBegin()>>;
+	using Unqualified = Storage<unqualifiedBegin(), std::make_index_sequence<end() - unqualifiedBegin()>>;
+
+	static constexpr const char* qualified()	{ return Qualified::value;	}
+	static constexpr const char* unqualified()	{ return Unqualified::value;	}
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+template <unsigned TBegin, std::size_t... TI>
+constexpr char TypeName<T>::Storage<TBegin, std::index_sequence<TI...>>::value[];
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
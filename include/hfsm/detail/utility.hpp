@@ -14,10 +14,13 @@
 	#define HSFM_CHECKED(x)			x
 #endif
 
-#ifdef _DEBUG
-	#define HSFM_IF_DEBUG(...)		__VA_ARGS__
+// type info copies in forks, parents and nodes, kept up to date on every transition;
+// the fast debug profile drops them (and keeps the asserts),
+// the debugger can still get them from indices via M::_R::stateType() / prongType()
+#if defined _DEBUG && !defined HFSM_ENABLE_FAST_DEBUG
+	#define HSFM_IF_DEBUG_TYPES(...)	__VA_ARGS__
 #else
-	#define HSFM_IF_DEBUG(...)
+	#define HSFM_IF_DEBUG_TYPES(...)
 #endif
 
 #ifndef NDEBUG
@@ -26,6 +29,33 @@
 	#define HSFM_IF_ASSERT(...)
 #endif
 
+// opt-in alignment of the per-tick block in the root, define to the target's cache line size
+// (over-aligned machines can only be heap-allocated with c++17 aligned 'new');
+// left undefined, the layout is the same for every standard
+#ifdef HFSM_CACHE_LINE_SIZE
+	#define HFSM_ALIGN_HOT	alignas(HFSM_CACHE_LINE_SIZE)
+#else
+	#define HFSM_ALIGN_HOT
+#endif
+
+// msvc only lays the first empty base out at no cost, unless told otherwise
+#ifdef _MSC_VER
+	#define HFSM_EMPTY_BASES	__declspec(empty_bases)
+#else
+	#define HFSM_EMPTY_BASES
+#endif
+
+// react() takes std::variant<> events from c++17 on
+#if __cplusplus >= 201703L || defined _MSVC_LANG && _MSVC_LANG >= 201703L
+	#define HFSM_VARIANT_EVENTS
+#endif
+
+#ifdef HFSM_ENABLE_NOEXCEPT
+	#define HFSM_NOEXCEPT(...)		noexcept(__VA_ARGS__)
+#else
+	#define HFSM_NOEXCEPT(...)
+#endif
+
 //------------------------------------------------------------------------------
 
 namespace hfsm {
@@ -40,6 +70,21 @@ fill(T& a, const char value) {
 	memset(&a, (int) value, sizeof(a));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+inline
+bool
+isZero(const T& a) {
+	const char* const bytes = reinterpret_cast<const char*>(&a);
+
+	for (unsigned i = 0; i < sizeof(a); ++i)
+		if (bytes[i] != 0)
+			return false;
+
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename T, unsigned TCount>
@@ -87,6 +132,41 @@ struct Max {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// a T held as a member, or, when empty, as a private base taking no room (empty base optimization, any standard);
+// derive from it, as the empty ones of different types share their address
+template <typename T, bool = std::is_empty<T>::value && !std::is_final<T>::value>
+class Compact {
+public:
+	template <typename... TArgs>
+	inline Compact(TArgs&&... args)
+		: _item(std::forward<TArgs>(args)...)
+	{}
+
+	inline		 T& get()		HFSM_NOEXCEPT(true)	{ return _item;	}
+	inline const T& get() const	HFSM_NOEXCEPT(true)	{ return _item;	}
+
+private:
+	T _item;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+class Compact<T, true>
+	: private T
+{
+public:
+	template <typename... TArgs>
+	inline Compact(TArgs&&... args)
+		: T(std::forward<TArgs>(args)...)
+	{}
+
+	inline		 T& get()		HFSM_NOEXCEPT(true)	{ return *this;	}
+	inline const T& get() const	HFSM_NOEXCEPT(true)	{ return *this;	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 template <unsigned t>
 struct PowerOf2 {
 	enum {
@@ -151,5 +231,23 @@ struct NextPowerOf2 {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+template <typename T, typename... TS>
+struct Contains {
+	enum {
+		Value = false
+	};
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T, typename TFirst, typename... TRest>
+struct Contains<T, TFirst, TRest...> {
+	enum {
+		Value = std::is_same<T, TFirst>::value || Contains<T, TRest...>::Value
+	};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 }
 }
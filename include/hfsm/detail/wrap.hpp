@@ -35,7 +35,7 @@ public:
 	inline		 T* operator->()							{ return &get();				}
 	inline const T* operator->() const						{ return &get();				}
 
-	inline explicit operator bool() const					{ return _storage != 0;			}
+	inline explicit operator bool() const					{ return !isZero(_storage);		}
 
 	inline bool operator == (const Wrap other) const		{ return get() == other.get();	}
 
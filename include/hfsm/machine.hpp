@@ -32,13 +32,28 @@
 #include <assert.h>
 #include <string.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <new>
+#include <type_traits>
 #include <typeindex>
 #include <utility>
 
+#if defined HFSM_ENABLE_WATCHDOG || defined HFSM_ENABLE_SUBSTITUTION_STATS
+	#include <chrono>
+#endif
+
+#include "detail/utility.hpp"
+
+#ifdef HFSM_VARIANT_EVENTS
+	#include <variant>
+#endif
+
 #include "detail/array.hpp"
 #include "detail/hash_table.hpp"
 #include "detail/type_info.hpp"
+#include "detail/type_name.hpp"
 
 //------------------------------------------------------------------------------
 
@@ -50,10 +65,38 @@
 
 #ifdef HFSM_ENABLE_LOG_INTERFACE
 	#define HFSM_IF_LOGGER(...)		__VA_ARGS__
-	#define HFSM_LOGGER_OR(y, n)	y
 #else
 	#define HFSM_IF_LOGGER(...)
-	#define HFSM_LOGGER_OR(y, n)	n
+#endif
+
+#ifdef HFSM_ENABLE_WATCHDOG
+	#define HFSM_IF_WATCHDOG(...)	__VA_ARGS__
+#else
+	#define HFSM_IF_WATCHDOG(...)
+#endif
+
+#ifdef HFSM_ENABLE_EVENT_STATS
+	#define HFSM_IF_EVENT_STATS(...)	__VA_ARGS__
+#else
+	#define HFSM_IF_EVENT_STATS(...)
+#endif
+
+#ifdef HFSM_ENABLE_COVERAGE
+	#define HFSM_IF_COVERAGE(...)		__VA_ARGS__
+#else
+	#define HFSM_IF_COVERAGE(...)
+#endif
+
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+	#define HFSM_IF_SUBSTITUTION_STATS(...)	__VA_ARGS__
+#else
+	#define HFSM_IF_SUBSTITUTION_STATS(...)
+#endif
+
+#ifdef HFSM_ENABLE_SCRATCH
+	#define HFSM_IF_SCRATCH(...)		__VA_ARGS__
+#else
+	#define HFSM_IF_SCRATCH(...)
 #endif
 
 namespace hfsm {
@@ -62,9 +105,9 @@ namespace hfsm {
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 struct StructureEntry {
-	bool isActive;
 	const wchar_t* prefix;
 	const char* name;
+	unsigned footprint;		// bytes taken by the state and its sub-states in each machine instance
 };
 using MachineStructure = detail::ArrayView<StructureEntry>;
 using MachineActivity  = detail::ArrayView<char>;
@@ -81,7 +124,12 @@ struct LoggerInterface {
 		Leave,
 	};
 
-	virtual void record(const std::type_index& state,
+	static constexpr unsigned mask(const Method method)	{ return 1u << (unsigned) method;	}
+
+	// std::type_index, unless built without rtti
+	using StateType = detail::TypeInfo::Native;
+
+	virtual void record(const StateType& state,
 						const char* const stateName,
 						const Method method,
 						const char* const methodName) = 0;
@@ -105,9 +153,27 @@ static const char* methodName(const LoggerInterface::Method method) {
 using LoggerInterface = void;
 #endif
 
+//------------------------------------------------------------------------------
+
+// compile-time logger filter: a mask of LoggerInterface::mask() bits,
+// and the roots of the subtrees to log (none for the whole machine)
+template <unsigned TMethods = (unsigned) -1, typename... TSubtrees>
+struct LogFilter {
+	enum : unsigned { Methods = TMethods };
+
+	enum : bool { Everywhere = sizeof...(TSubtrees) == 0 };
+
+	static constexpr bool logs(const unsigned method)	{ return (Methods >> method) & 1;		}
+
+	template <typename T>
+	static constexpr bool isSubtree()					{ return detail::Contains<T, TSubtrees...>::Value;	}
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContext, unsigned TMaxSubstitutions = 4>
+template <typename TContext,
+		  unsigned TMaxSubstitutions = 4,
+		  typename TLogFilter = LogFilter<>>
 class M {
 	using TypeInfo = detail::TypeInfo;
 
@@ -128,6 +194,78 @@ public:
 	using Context = TContext;
 	class Control;
 
+	// what a composite remembers of its sub-states for resume(), declared by its head as
+	// 'static constexpr History HistoryPolicy = History::Shallow;'
+	enum class History {
+		None,		// nothing but schedule()-d prongs, resume() enters the initial prong otherwise
+		Shallow,	// the last active prong, entered with its own initial sub-states
+		Deep,		// the last active prong, its sub-states resumed in turn (default)
+	};
+
+	// the order react() offers the event to the active states in,
+	// until one of them calls Control::consume()
+	enum class Propagation {
+		RootFirst,	// each head ahead of its sub-states (default)
+		LeafFirst,	// each head after its sub-states
+	};
+
+#ifdef HFSM_VARIANT_EVENTS
+	// closed set of events, for the ones arriving type-erased
+	template <typename... TEvents>
+	using Events = std::variant<TEvents...>;
+#endif
+
+	// returned by react()
+	struct Reaction {
+		enum : unsigned { NONE = (unsigned) -1 };
+
+		unsigned consumer = NONE;	// id of the state that consumed the event
+
+		inline explicit operator bool() const				{ return consumer != NONE;	}
+	};
+
+	//----------------------------------------------------------------------
+
+	// compile-time topology, as reported by _R::locate<T>() and friends
+
+	enum : unsigned { INVALID_STATE = (unsigned) -1 };
+
+	// one step down the hierarchy: the region's fork, and the prong taken in it,
+	// forks being numbered in pre-order, same as at run time
+	struct PathStep {
+		unsigned fork;
+		unsigned prong;
+	};
+
+	// from the apex down to the state
+	template <unsigned TCapacity>
+	struct PathT {
+		PathStep steps[TCapacity];
+		unsigned count;
+
+		constexpr const PathStep& operator[] (const unsigned i) const	{ return steps[i];	}
+	};
+
+	// [begin, end) of state ids, the state itself and all of its sub-states
+	struct StateRange {
+		unsigned begin;
+		unsigned end;
+
+		constexpr bool contains(const unsigned state) const	{ return begin <= state && state < end;	}
+	};
+
+	template <unsigned TCapacity>
+	struct LocationT {
+		unsigned state;
+		unsigned parent;	// head of the enclosing region, INVALID_STATE for the apex
+		unsigned end;		// one past the last of the sub-states
+		bool orthogonal;	// any of the enclosing regions is orthogonal
+		PathT<TCapacity> path;
+	};
+
+	template <unsigned>
+	class LoweredT;
+
 private:
 	using Index = unsigned char;
 	enum : Index { INVALID_INDEX = std::numeric_limits<Index>::max() };
@@ -142,19 +280,19 @@ private:
 			Index prong = INVALID_INDEX;
 		#pragma pack(pop)
 
-		HSFM_IF_DEBUG(TypeInfo forkType);
-		HSFM_IF_DEBUG(TypeInfo prongType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo forkType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo prongType);
 
 		inline Parent() = default;
 
 		inline Parent(const Index fork_,
 					  const Index prong_
-					  HSFM_IF_DEBUG(, const TypeInfo forkType_)
-					  HSFM_IF_DEBUG(, const TypeInfo prongType_))
+					  HSFM_IF_DEBUG_TYPES(, const TypeInfo forkType_)
+					  HSFM_IF_DEBUG_TYPES(, const TypeInfo prongType_))
 			: fork(fork_)
 			, prong(prong_)
-			HSFM_IF_DEBUG(, forkType(forkType_))
-			HSFM_IF_DEBUG(, prongType(prongType_))
+			HSFM_IF_DEBUG_TYPES(, forkType(forkType_))
+			HSFM_IF_DEBUG_TYPES(, prongType(prongType_))
 		{}
 
 		inline explicit operator bool() const { return fork != INVALID_INDEX && prong != INVALID_INDEX; }
@@ -167,6 +305,7 @@ private:
 	struct StateRegistry {
 	public:
 		virtual unsigned add(const TypeInfo stateType) = 0;
+		virtual unsigned find(const TypeInfo stateType) const = 0;
 	};
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -182,7 +321,10 @@ private:
 	public:
 		inline unsigned operator[] (const TypeInfo stateType) const { return *_typeToIndex.find(*stateType); }
 
+		inline TypeInfo type(const unsigned index) const;
+
 		virtual unsigned add(const TypeInfo stateType) override;
+		virtual unsigned find(const TypeInfo stateType) const override	{ return (*this)[stateType];	}
 
 	private:
 		TypeToIndex _typeToIndex;
@@ -198,32 +340,108 @@ private:
 			Index requested = INVALID_INDEX;
 		#pragma pack(pop)
 
-		HSFM_IF_DEBUG(const TypeInfo type);
-		HSFM_IF_ASSERT(TypeInfo activeType);
-		HSFM_IF_ASSERT(TypeInfo resumableType);
-		HSFM_IF_ASSERT(TypeInfo requestedType);
+		HSFM_IF_DEBUG_TYPES(const TypeInfo type);
+		HSFM_IF_DEBUG_TYPES(TypeInfo activeType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo resumableType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo requestedType);
 
 		Fork(const Index index, const TypeInfo type_);
 	};
 	using ForkPointers = ArrayView<Fork*>;
 
+	//----------------------------------------------------------------------
+
+	// configurations requested by the rounds of a single processTransitions() call,
+	// a repeat means the substitutions are going round in circles;
+	// hashes only pre-filter the full comparisons
+	template <unsigned TForkCount>
+	class SubstitutionHistoryT {
+	public:
+		// to be filled with the 'requested' prong of every fork, then record()-ed
+		inline Index* pending() HFSM_NOEXCEPT(true)						{ return _configurations[_count];	}
+
+		// false if the pending configuration was recorded already
+		inline bool record() HFSM_NOEXCEPT(true);
+
+	private:
+		unsigned _hashes[MaxSubstitutions];
+		Index _configurations[MaxSubstitutions][TForkCount];
+		unsigned _count = 0;
+	};
+
+	//----------------------------------------------------------------------
+
+	// heads declaring 'enum : bool { SkipObsoleteUpdates = true };' don't have their sub-states updated
+	// on the ticks their own transition() restarts or resumes a state outside of their sub-tree,
+	// as the sub-states are about to be left then; schedule()-s and transitions within the sub-tree update them as usual
+	template <typename THead>
+	static constexpr bool skipsObsoleteUpdates(decltype(THead::SkipObsoleteUpdates)*)	{ return THead::SkipObsoleteUpdates;	}
+
+	template <typename>
+	static constexpr bool skipsObsoleteUpdates(...)										{ return false;							}
+
+	template <typename THead>
+	static constexpr History historyOf(decltype(THead::HistoryPolicy)*)					{ return THead::HistoryPolicy;			}
+
+	template <typename>
+	static constexpr History historyOf(...)												{ return History::Deep;					}
+
+	// heads declaring 'void react(TEvent&&, Control&, Context&)' get the rvalue events as such,
+	// take them over, and consume them, so no other state sees what's left;
+	// every other react() is passed an lvalue
+	template <typename THead, typename TEvent>
+	static constexpr bool takesOver(decltype(static_cast<void (THead::*)(TEvent&&, Control&, Context&)>(&THead::react))*)
+																						{ return !std::is_const<TEvent>::value;	}
+
+	template <typename, typename>
+	static constexpr bool takesOver(...)												{ return false;							}
+
+	template <typename THead, typename TEvent>
+	using PassedEvent = typename std::conditional<takesOver<THead, TEvent>(nullptr), TEvent&&, TEvent&>::type;
+
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 	template <typename T>
 	struct ForkT
 		: Fork
 	{
-		ForkT(const Index index,
-			  const Parent parent,
-			  Parents& forkParents)
-			: Fork(index, TypeInfo::get<T>())
+		ForkT(const Parent parent,
+			  Parents& forkParents,
+			  ForkPointers& forkPointers)
+			: Fork(static_cast<Index>(forkPointers << this), TypeInfo::get<T>())
 		{
-			forkParents[index] = parent;
+			forkParents[Fork::self] = parent;
 		}
 	};
 
 	//----------------------------------------------------------------------
 
+	// the state object of a node: heads with no data, trivial to create, copy and destroy, aren't stored,
+	// a fresh one is made up for every call, so such states take no room;
+	// keyed by the state id too, as empty bases of the same type (the peers' Base) can't share an address
+	template <unsigned TStateID, typename THead, bool = std::is_empty<THead>::value && std::is_trivial<THead>::value>
+	class HeadT {
+	public:
+		using Reference = THead&;
+
+		inline Reference head() HFSM_NOEXCEPT(true)				{ return _head;		}
+
+	private:
+		THead _head;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	template <unsigned TStateID, typename THead>
+	class HeadT<TStateID, THead, true> {
+	public:
+		using Reference = THead;
+
+		inline Reference head() HFSM_NOEXCEPT(true)				{ return THead{};	}
+	};
+
+	//----------------------------------------------------------------------
+
 	struct Transition {
 		enum Type {
 			Remain,
@@ -250,41 +468,44 @@ private:
 
 	//----------------------------------------------------------------------
 
-	template <typename>
+	template <unsigned, bool, typename>
 	struct _S;
 
-	template <typename, typename...>
+	template <unsigned, bool, typename, typename...>
 	struct _C;
 
-	template <typename, typename...>
+	template <unsigned, bool, typename, typename...>
 	struct _O;
 
 	template <typename>
 	class _R;
 
-	//----------------------------------------------------------------------
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-	template <typename... TS>
-	struct WrapState;
+	// user-facing region descriptors, turned into _C / _O by WrapState
+	template <typename, typename...>
+	struct _CI;
 
-	template <typename T>
-	struct WrapState<T> {
-		using Type = _S<T>;
-	};
+	template <typename, typename...>
+	struct _OI;
 
-	template <typename T>
-	struct WrapState<_S<T>> {
-		using Type = _S<T>;
+	//----------------------------------------------------------------------
+
+	// pre-order ids, matching both the registry and the structure report;
+	// log scope is set inside the subtrees selected by the log filter
+	template <unsigned TID, bool TLS, typename T>
+	struct WrapState {
+		using Type = _S<TID, TLS || TLogFilter::template isSubtree<T>(), T>;
 	};
 
-	template <typename T, typename... TS>
-	struct WrapState<_C<T, TS...>> {
-		using Type = _C<T, TS...>;
+	template <unsigned TID, bool TLS, typename T, typename... TS>
+	struct WrapState<TID, TLS, _CI<T, TS...>> {
+		using Type = _C<TID, TLS || TLogFilter::template isSubtree<T>(), T, TS...>;
 	};
 
-	template <typename T, typename... TS>
-	struct WrapState<_O<T, TS...>> {
-		using Type = _O<T, TS...>;
+	template <unsigned TID, bool TLS, typename T, typename... TS>
+	struct WrapState<TID, TLS, _OI<T, TS...>> {
+		using Type = _O<TID, TLS || TLogFilter::template isSubtree<T>(), T, TS...>;
 	};
 
 	//----------------------------------------------------------------------
@@ -301,21 +522,32 @@ private:
 		StateInfo(const unsigned parent_,
 				  const RegionType region_,
 				  const unsigned depth_,
-				  const char* const name_)
+				  const char* const name_,
+				  const unsigned footprint_)
 			: parent(parent_)
 			, region(region_)
 			, depth(depth_)
 			, name(name_)
+			, footprint(footprint_)
 		{}
 
 		unsigned parent;
 		RegionType region;
 		unsigned depth;
 		const char* name;
+		unsigned footprint;
 	};
 	using StateInfos = detail::ArrayView<StateInfo>;
 
 	using StateStructure = detail::ArrayView<StructureEntry>;
+
+	//----------------------------------------------------------------------
+
+	struct StateActivity {
+		unsigned since = 0;
+		bool isActive = false;
+	};
+	using StateActivities = ArrayView<StateActivity>;
 #endif
 
 #pragma endregion
@@ -334,20 +566,24 @@ public:
 		using Control	 = typename M::Control;
 		using Context	 = typename M::Context;
 		using Transition = typename M::Transition;
+		using History	 = typename M::History;
 
 	public:
-		inline void preSubstitute(Context&)				{}
-		inline void preEnter(Context&)					{}
-		inline void preUpdate(Context&)					{}
-		inline void preTransition(Context&)				{}
+		inline void preSubstitute(Context&)				HFSM_NOEXCEPT(true)	{}
+		inline void preEnter(Context&)					HFSM_NOEXCEPT(true)	{}
+		inline void preUpdate(Context&)					HFSM_NOEXCEPT(true)	{}
+		inline void preTransition(Context&)				HFSM_NOEXCEPT(true)	{}
 		template <typename TEvent>
-		inline void preReact(const TEvent&, Context&)	{}
-		inline void postLeave(Context&)					{}
+		inline void preReact(const TEvent&, Context&)	HFSM_NOEXCEPT(true)	{}
+		inline void postLeave(Context&)					HFSM_NOEXCEPT(true)	{}
 	};
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 private:
 
+	// returned by the default Base::react(), tells the states handling an event apart at compile time
+	struct Unhandled {};
+
 	template <typename...>
 	struct _B;
 
@@ -358,13 +594,31 @@ private:
 		: public TInjection
 		, public _B<TRest...>
 	{
-		inline void widePreSubstitute(Context& context);
-		inline void widePreEnter(Context& context);
-		inline void widePreUpdate(Context& context);
-		inline void widePreTransition(Context& context);
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptPreSubstitute = noexcept(std::declval<TInjection&>().preSubstitute(std::declval<Context&>())) && _B<TRest...>::NoexceptPreSubstitute,
+			NoexceptPreEnter	  = noexcept(std::declval<TInjection&>().preEnter	  (std::declval<Context&>())) && _B<TRest...>::NoexceptPreEnter,
+			NoexceptPreUpdate	  = noexcept(std::declval<TInjection&>().preUpdate	  (std::declval<Context&>())) && _B<TRest...>::NoexceptPreUpdate,
+			NoexceptPreTransition = noexcept(std::declval<TInjection&>().preTransition(std::declval<Context&>())) && _B<TRest...>::NoexceptPreTransition,
+			NoexceptPostLeave	  = noexcept(std::declval<TInjection&>().postLeave	  (std::declval<Context&>())) && _B<TRest...>::NoexceptPostLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptPreReact {
+			enum : bool {
+				Value = noexcept(std::declval<TInjection&>().preReact(std::declval<const TEvent&>(), std::declval<Context&>())) &&
+						_B<TRest...>::template NoexceptPreReact<TEvent>::Value
+			};
+		};
+	#endif
+
+		inline void widePreSubstitute(Context& context)	HFSM_NOEXCEPT(NoexceptPreSubstitute);
+		inline void widePreEnter(Context& context)		HFSM_NOEXCEPT(NoexceptPreEnter);
+		inline void widePreUpdate(Context& context)		HFSM_NOEXCEPT(NoexceptPreUpdate);
+		inline void widePreTransition(Context& context)	HFSM_NOEXCEPT(NoexceptPreTransition);
 		template <typename TEvent>
-		inline void widePreReact(const TEvent& event, Context& context);
-		inline void widePostLeave(Context& context);
+		inline void widePreReact(const TEvent& event, Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value);
+		inline void widePostLeave(Context& context)		HFSM_NOEXCEPT(NoexceptPostLeave);
 	};
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -373,194 +627,1219 @@ private:
 	struct _B<TInjection>
 		: public TInjection
 	{
-		inline void substitute(Control&, Context&)				{}
-		inline void enter(Context&)								{}
-		inline void update(Context&)							{}
-		inline void transition(Control&, Context&)				{}
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptPreSubstitute = noexcept(std::declval<TInjection&>().preSubstitute(std::declval<Context&>())),
+			NoexceptPreEnter	  = noexcept(std::declval<TInjection&>().preEnter	  (std::declval<Context&>())),
+			NoexceptPreUpdate	  = noexcept(std::declval<TInjection&>().preUpdate	  (std::declval<Context&>())),
+			NoexceptPreTransition = noexcept(std::declval<TInjection&>().preTransition(std::declval<Context&>())),
+			NoexceptPostLeave	  = noexcept(std::declval<TInjection&>().postLeave	  (std::declval<Context&>())),
+		};
+
+		template <typename TEvent>
+		struct NoexceptPreReact {
+			enum : bool {
+				Value = noexcept(std::declval<TInjection&>().preReact(std::declval<const TEvent&>(), std::declval<Context&>()))
+			};
+		};
+	#endif
+
+		inline void substitute(Control&, Context&)				HFSM_NOEXCEPT(true)	{}
+		inline void enter(Context&)								HFSM_NOEXCEPT(true)	{}
+		inline void update(Context&)							HFSM_NOEXCEPT(true)	{}
+		inline void transition(Control&, Context&)				HFSM_NOEXCEPT(true)	{}
 		template <typename TEvent>
-		inline void react(const TEvent&, Control&, Context&)	{}
-		inline void leave(Context&)								{}
+		inline Unhandled react(const TEvent&, Control&, Context&) HFSM_NOEXCEPT(true)	{ return Unhandled{};	}
+		inline void leave(Context&)								HFSM_NOEXCEPT(true)	{}
 
-		inline void widePreSubstitute(Context& context);
-		inline void widePreEnter(Context& context);
-		inline void widePreUpdate(Context& context);
-		inline void widePreTransition(Context& context);
+		inline void widePreSubstitute(Context& context)	HFSM_NOEXCEPT(NoexceptPreSubstitute);
+		inline void widePreEnter(Context& context)		HFSM_NOEXCEPT(NoexceptPreEnter);
+		inline void widePreUpdate(Context& context)		HFSM_NOEXCEPT(NoexceptPreUpdate);
+		inline void widePreTransition(Context& context)	HFSM_NOEXCEPT(NoexceptPreTransition);
 		template <typename TEvent>
-		inline void widePreReact(const TEvent& event, Context& context);
-		inline void widePostLeave(Context& context);
+		inline void widePreReact(const TEvent& event, Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value);
+		inline void widePostLeave(Context& context)		HFSM_NOEXCEPT(NoexceptPostLeave);
 	};
 
 #pragma endregion
 
 	//----------------------------------------------------------------------
 
-#pragma region Root
+#pragma region Logging
 
-	template <typename TApex>
-	class _R final {
-		using Apex = typename WrapState<TApex>::Type;
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+public:
 
+	// decides once per update() / react() whether the attached logger gets called,
+	// share one instance between machines to sample the whole fleet
+	class LogSampling {
 	public:
-		enum : unsigned {
-			ReverseDepth  = Apex::ReverseDepth,
-			DeepWidth	  = Apex::DeepWidth,
-			StateCount	  = Apex::StateCount,
-			ForkCount	  = Apex::ForkCount,
-			ProngCount	  = Apex::ProngCount,
-			Width		  = Apex::Width,
+		enum class Policy {
+			All,		// every call
+			Ticks,		// every 'rate'-th call of each machine
+			Machines,	// all calls of every 'rate'-th machine
+			Never,		// no calls, only feed the transition reservoir
 		};
-		static_assert(StateCount < std::numeric_limits<Index>::max(), "Too many states in the hierarchy. Change 'Index' type.");
 
-	private:
-		enum : unsigned {
-			StateCapacity = (unsigned) 1.3 * Apex::StateCount,
-		};
+		LogSampling(const Policy policy = Policy::All,
+					const unsigned rate = 1);
 
-		using StateRegistryImpl		 = StateRegistryT<StateCapacity>;
-		using StateParentStorage	 = Array<Parent, StateCount>;
-		using ForkParentStorage		 = Array<Parent, ForkCount>;
-		using ForkPointerStorage	 = Array<Fork*, ForkCount>;
-		using TransitionQueueStorage = Array<Transition, ForkCount>;
+		virtual ~LogSampling() = default;
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		enum : unsigned {
-			NameCount	  = Apex::NameCount,
-		};
+		inline unsigned enroll()												{ return _enrolled++;		}
 
-		using Prefix				 = detail::StaticArray<wchar_t, ReverseDepth * 2 + 2>;
-		using Prefixes				 = detail::StaticArray<Prefix, StateCount>;
+		inline bool sample(const unsigned machine, const unsigned tick) const HFSM_NOEXCEPT(true);
 
-		using StateInfoStorage		 = detail::Array<StateInfo, StateCount>;
+		virtual void offer(const Transition& /*transition*/) HFSM_NOEXCEPT(true)	{}
 
-		using StructureStorage		 = detail::Array<StructureEntry, NameCount>;
-		using ActivityHistoryStorage = detail::Array<char, NameCount>;
-	#endif
+	private:
+		const Policy _policy;
+		const unsigned _rate;
+		unsigned _enrolled = 0;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// additionally keeps a uniform sample of all offered transitions
+	template <unsigned TReservoirCapacity>
+	class LogSamplingT
+		: public LogSampling
+	{
+		enum : unsigned { Capacity = TReservoirCapacity };
+
+		using Policy	= typename LogSampling::Policy;
+		using Reservoir = Array<Transition, Capacity>;
 
 	public:
-		_R(Context& context
-		   HFSM_IF_LOGGER(, LoggerInterface* const logger = nullptr));
+		LogSamplingT(const Policy policy = Policy::All,
+					 const unsigned rate = 1,
+					 const unsigned seed = 1);
 
-		~_R();
+		virtual void offer(const Transition& transition) HFSM_NOEXCEPT(true) override;
 
-		void update();
+		inline const Reservoir& reservoir() const								{ return _reservoir;		}
+		inline unsigned offered() const											{ return _offered;			}
 
-		template <typename TEvent>
-		inline void react(const TEvent& event);
+	private:
+		inline unsigned random() HFSM_NOEXCEPT(true);
 
-		template <typename T>
-		inline void changeTo()	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+	private:
+		Reservoir _reservoir;
+		unsigned _offered = 0;
+		unsigned _random;
+	};
 
-		template <typename T>
-		inline void resume()	{ _requests << Transition(Transition::Type::Resume,   TypeInfo::get<T>());	}
+private:
+#endif
 
-		template <typename T>
-		inline void schedule()	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
+#pragma endregion
 
-		template <typename T>
-		inline bool isActive();
+	//----------------------------------------------------------------------
 
-		template <typename T>
-		inline bool isResumable();
+#pragma region Watchdog
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		const MachineStructure& structure() const								{ return _structure;		};
-		const MachineActivity&  activity()  const								{ return _activityHistory;	};
-	#endif
+#ifdef HFSM_ENABLE_WATCHDOG
+public:
 
-	#ifdef HFSM_ENABLE_LOG_INTERFACE
-		void attachLogger(LoggerInterface* const logger)						{ _logger = logger;			}
-	#endif
+	// times state callbacks against per-state / global thresholds,
+	// watches for substitution limit exhaustion, cycles and budget overruns, and enter / leave oscillation,
+	// keeps the latest incidents in a fixed-size ring
+	class Watchdog {
+		template <typename>
+		friend class _R;
+
+		friend class Control;
+
+	public:
+		using Clock		= std::chrono::steady_clock;
+		using Duration	= Clock::duration;
+		using TimePoint = Clock::time_point;
+
+		enum class Callback {
+			Substitute,
+			Enter,
+			Update,
+			Transition,
+			React,
+			Leave,
+		};
+
+		struct Incident {
+			enum class Type {
+				SlowCallback,		// 'callback' of 'state' took 'duration'
+				SubstitutionLimit,	// 'state' was still requested after TMaxSubstitutions rounds
+				SubstitutionCycle,	// 'state' was requested again for an already requested configuration, and dropped
+				SubstitutionBudget,	// 'state' was still requested after substituting for 'duration', past the budget
+				Oscillation,		// 'state' was entered more than the limit times within the window
+			};
+
+			Type type;
+			unsigned state;
+			Callback callback;
+			Duration duration;
+			unsigned tick;
+			TimePoint time;
+		};
+		using Incidents = ArrayView<Incident>;
+
+		struct StateWatch {
+			Duration threshold = Duration::zero();	// zero for the global threshold
+			unsigned windowStart = 0;
+			unsigned enters = 0;
+		};
+		using StateWatches = ArrayView<StateWatch>;
 
 	protected:
-		void processTransitions();
-		void requestImmediate(const Transition request);
-		void requestScheduled(const Transition request);
+		Watchdog(StateWatches& states,
+				 Incidents& incidents);
 
-		inline unsigned id(const Transition request) const	{ return _stateRegistry[*request.stateType];	}
+	public:
+		inline void threshold(const Duration threshold)							{ _threshold = threshold;				}
+		inline void threshold(const unsigned state, const Duration threshold)	{ _states[state].threshold = threshold;	}
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		void getStateNames();
-		void udpateActivity();
-	#endif
+		inline void oscillation(const unsigned limit, const unsigned window)	{ _oscillationLimit = limit; _oscillationWindow = window;	}
 
-	private:
-		Context& _context;
+		inline const Incidents& incidents() const								{ return _incidents;					}
+		inline unsigned reported() const										{ return _reported;						}
 
-		StateRegistryImpl _stateRegistry;
+		inline void clear()														{ _incidents.clear(); _reported = 0;	}
 
-		StateParentStorage _stateParents;
-		ForkParentStorage  _forkParents;
-		ForkPointerStorage _forkPointers;
+	private:
+		inline void tick()									HFSM_NOEXCEPT(true)	{ ++_tick;								}
 
-		TransitionQueueStorage _requests;
+		inline void check(const unsigned state,
+						  const Callback callback,
+						  const TimePoint begin) HFSM_NOEXCEPT(true);
 
-		Apex _apex;
+		inline void entered(const unsigned state) HFSM_NOEXCEPT(true);
+		inline void exhausted(const unsigned state) HFSM_NOEXCEPT(true);
+		inline void cycled(const unsigned state) HFSM_NOEXCEPT(true);
+		inline void overBudget(const unsigned state, const Duration duration) HFSM_NOEXCEPT(true);
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		Prefixes _prefixes;
-		StateInfoStorage _stateInfos;
+		void report(const Incident& incident) HFSM_NOEXCEPT(true);
 
-		StructureStorage _structure;
-		ActivityHistoryStorage _activityHistory;
+	private:
+		StateWatches& _states;
+		Incidents& _incidents;
 
-		struct DebugTransitionInfo {
-			typename Transition::Type type;
-			TypeInfo state;
+		Duration _threshold = std::chrono::milliseconds(1);
+		unsigned _oscillationLimit = 8;
+		unsigned _oscillationWindow = 60;
 
-			enum Source {
-				Update,
-				Substitute,
-				Linger,
+		unsigned _tick = 0;
+		unsigned _reported = 0;
+	};
 
-				COUNT
-			};
-			Source source;
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-			inline DebugTransitionInfo() = default;
+	// attach to a machine of up to TStateCapacity states
+	template <unsigned TStateCapacity, unsigned TIncidentCapacity = 16>
+	class WatchdogT
+		: public Watchdog
+	{
+		using StateWatchStorage = Array<typename Watchdog::StateWatch, TStateCapacity>;
+		using IncidentStorage	= Array<typename Watchdog::Incident, TIncidentCapacity>;
 
-			inline DebugTransitionInfo(const Transition transition,
-									   const Source source_)
-				: type(transition.type)
-				, state(transition.stateType)
-				, source(source_)
-			{
-				assert(source_ < Source::COUNT);
-			}
-		};
-		using DebugTransitionInfos = Array<DebugTransitionInfo, 2 * ForkCount>;
-		DebugTransitionInfos _lastTransitions;
-	#endif
+	public:
+		WatchdogT()
+			: Watchdog(_stateStorage, _incidentStorage)
+		{
+			_stateStorage.resize(TStateCapacity);
+		}
 
-		HFSM_IF_LOGGER(LoggerInterface* _logger);
+	private:
+		StateWatchStorage _stateStorage;
+		IncidentStorage _incidentStorage;
 	};
 
+private:
+#endif
+
+#pragma endregion
+
 	//----------------------------------------------------------------------
 
+#pragma region Event Stats
+
+#ifdef HFSM_ENABLE_EVENT_STATS
 public:
 
-	class Control final {
+	// per event type dispatch counters, attach to a single machine,
+	// or share one instance between machines to aggregate the whole fleet
+	class EventStats {
 		template <typename>
 		friend class _R;
 
-	private:
-		Control(TransitionQueue& requests)
-			: _requests(requests)
-		{}
-
 	public:
-		template <typename T>
-		inline void changeTo()	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+		struct Entry {
+			TypeInfo event;
+			unsigned dispatched;	// react() calls
+			unsigned visited;		// states the event was offered to
+			unsigned handled;		// ..of them overriding react() for it
+			unsigned transitions;	// transitions requested in response
+		};
+		using Entries = ArrayView<Entry>;
 
-		template <typename T>
-		inline void resume()	{ _requests << Transition(Transition::Type::Resume,	  TypeInfo::get<T>());	}
+	protected:
+		EventStats(Entries& entries);
 
-		template <typename T>
-		inline void schedule()	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
+	public:
+		template <typename TEvent>
+		inline const Entry* get() const						{ return find(TypeInfo::get<TEvent>());	}
+
+		inline const Entries& entries() const				{ return _entries;						}
+
+		// react() calls with event types past the capacity
+		inline unsigned dropped() const						{ return _dropped;						}
+
+		void merge(const EventStats& other);
+
+		inline void clear()									{ _entries.clear(); _dropped = 0;		}
+
+	private:
+		const Entry* find(const TypeInfo event) const HFSM_NOEXCEPT(true);
+		Entry* insert(const TypeInfo event) HFSM_NOEXCEPT(true);
+
+		inline Entry* dispatched(const TypeInfo event) HFSM_NOEXCEPT(true);
+
+	private:
+		Entries& _entries;
+		unsigned _dropped = 0;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// keeps up to TCapacity event types
+	template <unsigned TCapacity = 16>
+	class EventStatsT
+		: public EventStats
+	{
+		using EntryStorage = Array<typename EventStats::Entry, TCapacity>;
+
+	public:
+		EventStatsT()
+			: EventStats(_entryStorage)
+		{}
+
+	private:
+		EntryStorage _entryStorage;
+	};
+
+private:
+#endif
+
+#pragma endregion
+
+	//----------------------------------------------------------------------
+
+#pragma region Coverage
+
+#ifdef HFSM_ENABLE_COVERAGE
+public:
+
+	// one bit per state ever entered, and one per composite prong ever switched to by a transition
+	// (kept at the index of the state heading the prong);
+	// share one instance between machines of the same structure, or merge() them for a fleet-wide OR
+	class Coverage {
+		template <typename>
+		friend class _R;
+
+		friend class Control;
+
+	public:
+		using Words = ArrayView<unsigned>;
+
+		struct Prong {
+			unsigned fork;
+			unsigned prong;
+		};
+
+		enum : unsigned {
+			WordBits = sizeof(unsigned) * 8,
+		};
+
+	protected:
+		Coverage(const unsigned capacity,
+				 Words& states,
+				 Words& transitions);
+
+	public:
+		// states covered, ids past it are never recorded
+		inline unsigned capacity() const						{ return _capacity;					}
+
+		inline bool entered(const unsigned state) const			{ return state < _capacity && test(_states, state);		}
+		inline bool switchedTo(const unsigned state) const		{ return state < _capacity && test(_transitions, state);	}
+
+		// raw bits, to be dumped and OR-ed across processes
+		inline const Words& stateBits() const					{ return _states;					}
+		inline const Words& transitionBits() const				{ return _transitions;				}
+
+		// false, with nothing merged, for a coverage of a different capacity
+		bool merge(const Coverage& other);
+
+		// ids of the entered states, returns their count
+		unsigned exportStates(unsigned* const states, const unsigned capacity) const;
+
+		void clear();
+
+	private:
+		// ids are checked against the capacity once, on attaching
+		inline void enter(const unsigned state)		HFSM_NOEXCEPT(true)	{ set(_states, state);				}
+		inline void switchTo(const unsigned state)	HFSM_NOEXCEPT(true)	{ set(_transitions, state);			}
+
+		static inline void set (		Words& words, const unsigned bit)	HFSM_NOEXCEPT(true)	{ words[bit / WordBits] |= 1u << bit % WordBits;				}
+		static inline bool test(const Words& words, const unsigned bit)	HFSM_NOEXCEPT(true)	{ return (words[bit / WordBits] & 1u << bit % WordBits) != 0;	}
+
+	private:
+		const unsigned _capacity;
+		Words& _states;
+		Words& _transitions;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// attach to a machine of up to TStateCapacity states
+	template <unsigned TStateCapacity>
+	class CoverageT
+		: public Coverage
+	{
+		enum : unsigned {
+			WordCount = (TStateCapacity + Coverage::WordBits - 1) / Coverage::WordBits,
+		};
 
-		inline unsigned requestCount() const									{ return _requests.count();	}
+		using WordStorage = Array<unsigned, WordCount>;
+
+	public:
+		CoverageT()
+			: Coverage(TStateCapacity, _stateStorage, _transitionStorage)
+		{
+			_stateStorage.resize(WordCount);
+			_transitionStorage.resize(WordCount);
+		}
+
+	private:
+		WordStorage _stateStorage;
+		WordStorage _transitionStorage;
+	};
+
+private:
+#endif
+
+#pragma endregion
+
+	//----------------------------------------------------------------------
+
+#pragma region Substitution Stats
+
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+public:
+
+	// rounds taken by processTransitions() calls, to size TMaxSubstitutions from data,
+	// with an optional time budget per call
+	class SubstitutionStats {
+		template <typename>
+		friend class _R;
+
+	public:
+		using Clock		= std::chrono::steady_clock;
+		using Duration	= Clock::duration;
+
+		// past the budget, the remaining requests are left for the next update() / react(); zero for none
+		inline void budget(const Duration budget)			{ _budget = budget;							}
+
+		inline unsigned calls() const						{ return _calls;							}
+
+		// calls that took 'count' rounds, 1 .. TMaxSubstitutions
+		inline unsigned rounds(const unsigned count) const	{ assert(count <= MaxSubstitutions); return _rounds[count];	}
+		inline unsigned peak() const						{ return _peak;								}
+
+		inline unsigned cycles() const						{ return _cycles;							}
+		inline unsigned exhausted() const					{ return _exhausted;						}
+		inline unsigned overBudget() const					{ return _overBudget;						}
+
+		// keeps the budget
+		void clear();
+
+	private:
+		inline void record(const unsigned rounds) HFSM_NOEXCEPT(true);
+
+	private:
+		Duration _budget = Duration::zero();
+
+		unsigned _calls = 0;
+		unsigned _rounds[MaxSubstitutions + 1] = {};
+		unsigned _peak = 0;
+
+		unsigned _cycles = 0;
+		unsigned _exhausted = 0;
+		unsigned _overBudget = 0;
+	};
+
+private:
+#endif
+
+#pragma endregion
+
+	//----------------------------------------------------------------------
+
+#pragma region Scratch
+
+#ifdef HFSM_ENABLE_SCRATCH
+public:
+
+	// memory the states' scratch arenas are carved from, each on the first entry of its state;
+	// an arena is held until its machine is destroyed, then kept on a per-state free list for the next machine;
+	// attach to a single machine, or share one block between machines of the same structure;
+	// also keeps the most each state has used of its arena, to size the arenas from data
+	class Scratch;
+
+	class ScratchBlock {
+		friend class Control;
+		friend class Scratch;
+
+	public:
+		using HighWaters = ArrayView<unsigned>;
+		using FreeLists	 = ArrayView<char*>;
+
+	protected:
+		ScratchBlock(char* const memory,
+					 const unsigned capacity,
+					 HighWaters& highWaters,
+					 FreeLists& freeLists);
+
+	public:
+		inline unsigned capacity() const					{ return _capacity;					}
+
+		// handed out to the arenas so far
+		inline unsigned carved() const						{ return _carved;					}
+
+		// arenas that didn't fit, and were left empty; once per state and machine
+		inline unsigned missed() const						{ return _missed;					}
+
+		// bytes used by the state so far, the most seen
+		inline unsigned highWater(const unsigned state) const	{ return _highWaters[state];	}
+		inline const HighWaters& highWaters() const			{ return _highWaters;				}
+
+		// keeps the carved arenas
+		void clearHighWaters();
+
+	private:
+		char* carve(const unsigned state,
+					const unsigned size) HFSM_NOEXCEPT(true);
+
+		void release(const unsigned state,
+					 char* const arena) HFSM_NOEXCEPT(true);
+
+		inline void record(const unsigned state, const unsigned used) HFSM_NOEXCEPT(true)	{ if (_highWaters[state] < used) _highWaters[state] = used;	}
+
+	private:
+		char* const _memory;
+		const unsigned _capacity;
+		HighWaters& _highWaters;
+		FreeLists& _freeLists;
+
+		unsigned _carved = 0;
+		unsigned _missed = 0;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// TCapacity bytes, for a machine (or a fleet) of up to TStateCapacity states
+	template <unsigned TStateCapacity, unsigned TCapacity>
+	class ScratchBlockT
+		: public ScratchBlock
+	{
+		using HighWaterStorage = Array<unsigned, TStateCapacity>;
+		using FreeListStorage  = Array<char*, TStateCapacity>;
+
+	public:
+		ScratchBlockT()
+			: ScratchBlock(_memory, TCapacity, _highWaterStorage, _freeListStorage)
+		{
+			_highWaterStorage.resize(TStateCapacity);
+			_freeListStorage.resize(TStateCapacity);
+		}
+
+	private:
+		alignas(std::max_align_t) char _memory[TCapacity];
+		HighWaterStorage _highWaterStorage;
+		FreeListStorage _freeListStorage;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// injection giving the state a bump-pointer arena, released in bulk once the state is left,
+	// and returned to the block with the machine;
+	// nothing is destroyed on release, so only trivially destructible objects go in
+	class Scratch
+		: public Bare
+	{
+		friend class Control;
+
+	protected:
+		inline Scratch(const unsigned capacity)				: _capacity(capacity)				{}
+		inline ~Scratch()									{ if (_memory) _block->release(_state, _memory);	}
+
+		// nullptr without a block attached, or once the arena is full
+		inline void* allocate(const unsigned size,
+							  const unsigned alignment = alignof(std::max_align_t)) HFSM_NOEXCEPT(true);
+
+		template <typename T, typename... TArgs>
+		inline T* create(TArgs&&... args);
+
+		inline unsigned scratchCapacity() const				{ return _memory ? _capacity : 0;	}
+		inline unsigned scratchUsed() const					{ return _used;						}
+
+	private:
+		char* _memory = nullptr;
+		const unsigned _capacity;
+		unsigned _used = 0;
+
+		// where the arena came from
+		ScratchBlock* _block = nullptr;
+		unsigned _state = 0;
+		bool _missed = false;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// opt in with BaseT<ScratchT<bytes>, ..>
+	template <unsigned TCapacity>
+	class ScratchT
+		: public Scratch
+	{
+		static_assert(TCapacity > 0, "Empty scratch arenas can't be kept on the free list");
+
+	protected:
+		ScratchT()
+			: Scratch(TCapacity)
+		{}
+	};
+
+private:
+#endif
+
+#pragma endregion
+
+	//----------------------------------------------------------------------
+
+#pragma region Root
+
+	template <typename TApex>
+	class _R final {
+		using Apex = typename WrapState<0, TLogFilter::Everywhere, TApex>::Type;
+
+	public:
+		enum : unsigned {
+			ReverseDepth  = Apex::ReverseDepth,
+			DeepWidth	  = Apex::DeepWidth,
+			StateCount	  = Apex::StateCount,
+			ForkCount	  = Apex::ForkCount,
+			ProngCount	  = Apex::ProngCount,
+			Width		  = Apex::Width,
+		};
+		static_assert(StateCount < std::numeric_limits<Index>::max(), "Too many states in the hierarchy. Change 'Index' type.");
+
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptTransitions = Apex::NoexceptSubstitute && Apex::NoexceptEnter && Apex::NoexceptLeave,
+			NoexceptUpdate		= Apex::NoexceptUpdateAndTransition && NoexceptTransitions,
+		};
+
+		// TEvent is const for the events passed by reference
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Apex::template NoexceptReact<TEvent>::Value && NoexceptTransitions
+			};
+		};
+	#endif
+
+	private:
+		enum : unsigned {
+			StateCapacity = (unsigned) 1.3 * Apex::StateCount,
+		};
+
+		using StateRegistryImpl		 = StateRegistryT<StateCapacity>;
+		using StateParentStorage	 = Array<Parent, StateCount>;
+		using ForkParentStorage		 = Array<Parent, ForkCount>;
+		using ForkPointerStorage	 = Array<Fork*, ForkCount>;
+		using TransitionQueueStorage = Array<Transition, ForkCount>;
+		using SubstitutionHistory	 = SubstitutionHistoryT<ForkCount>;
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		enum : unsigned {
+			NameCount	  = Apex::NameCount,
+		};
+
+		using Prefix				 = detail::StaticArray<wchar_t, ReverseDepth * 2 + 2>;
+		using Prefixes				 = detail::StaticArray<Prefix, StateCount>;
+
+		using StateInfoStorage		 = detail::Array<StateInfo, StateCount>;
+
+		using StructureStorage		 = detail::Array<StructureEntry, NameCount>;
+		using StateActivityStorage	 = detail::Array<StateActivity, StateCount>;
+		using ActivityHistoryStorage = detail::Array<char, NameCount>;
+
+		// identical for all instances of the machine, built once on first use
+		struct StaticStructure {
+			StaticStructure();
+
+			Prefixes prefixes;
+			StateInfoStorage stateInfos;
+			StructureStorage structure;
+		};
+	#endif
+
+	public:
+		_R(Context& context
+		   HFSM_IF_LOGGER(, LoggerInterface* const logger = nullptr)
+		   HFSM_IF_COVERAGE(, Coverage* const coverage = nullptr)
+		   HFSM_IF_SCRATCH(, ScratchBlock* const scratch = nullptr));
+
+		~_R();
+
+		void update() HFSM_NOEXCEPT(NoexceptUpdate);
+
+		template <typename TEvent>
+		inline Reaction react(const TEvent& event) HFSM_NOEXCEPT(NoexceptReact<const TEvent>::Value)	{ return dispatch(event);	}
+
+		// rvalues can be taken over by a state's react(TEvent&&) overload,
+		// which consumes the event, the states before it see it as an lvalue
+		template <typename TEvent, typename = typename std::enable_if<!std::is_reference<TEvent>::value>::type>
+		inline Reaction react(TEvent&& event) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)			{ return dispatch(event);	}
+
+	#ifdef HFSM_VARIANT_EVENTS
+		// a single jump through a table of the per-alternative react() paths,
+		// std::monostate and valueless variants don't reach the states
+		template <typename... TEvents>
+		inline Reaction react(const std::variant<TEvents...>& events) HFSM_NOEXCEPT((NoexceptReact<const TEvents>::Value && ...))	{ return reactVariant(events, std::index_sequence_for<TEvents...>{});	}
+
+		// the alternative is passed on as an rvalue
+		template <typename... TEvents>
+		inline Reaction react(std::variant<TEvents...>&& events) HFSM_NOEXCEPT((NoexceptReact<TEvents>::Value && ...))			{ return reactVariant(events, std::index_sequence_for<TEvents...>{});	}
+	#endif
+
+		// constructs the event in place, and reacts to it as an rvalue
+		template <typename TEvent, typename... TArgs>
+		inline Reaction emplace(TArgs&&... args) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value &&
+															   std::is_nothrow_constructible<TEvent, TArgs&&...>::value);
+
+		inline void propagation(const Propagation order)	HFSM_NOEXCEPT(true)	{ _propagation = order;		}
+		inline Propagation propagation() const				HFSM_NOEXCEPT(true)	{ return _propagation;		}
+
+		template <typename T>
+		inline void changeTo()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void resume()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Resume,   TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void schedule()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline bool isActive();
+
+		template <typename T>
+		inline bool isResumable();
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		const MachineStructure& structure() const								{ return staticStructure().structure; };
+
+		// rebuilt on every call, over the view the previous call returned
+		const MachineActivity&  activity();
+	#endif
+
+	#ifdef _DEBUG
+		// type info derived from indices on demand, for the debugger
+		TypeInfo stateType(const unsigned state) const							{ return _stateRegistry.type(state);	}
+		TypeInfo prongType(const unsigned fork, const unsigned prong) const;
+
+		TypeInfo activeType	  (const unsigned fork) const	{ return prongType(fork, _forkPointers[fork]->active);		}
+		TypeInfo resumableType(const unsigned fork) const	{ return prongType(fork, _forkPointers[fork]->resumable);	}
+		TypeInfo requestedType(const unsigned fork) const	{ return prongType(fork, _forkPointers[fork]->requested);	}
+	#endif
+
+	#ifdef HFSM_ENABLE_LOG_INTERFACE
+		void attachLogger(LoggerInterface* const logger)						{ _logger = logger;			}
+
+		inline void attachSampling(LogSampling* const sampling);
+	#endif
+
+	#ifdef HFSM_ENABLE_WATCHDOG
+		template <unsigned TStateCapacity, unsigned TIncidentCapacity>
+		void attachWatchdog(WatchdogT<TStateCapacity, TIncidentCapacity>* const watchdog) {
+			static_assert(StateCount <= TStateCapacity, "Watchdog too small for the machine, see WatchdogT<>'s TStateCapacity.");
+
+			_watchdog = watchdog;
+		}
+
+		void detachWatchdog()													{ _watchdog = nullptr;		}
+	#endif
+
+		// as reported by Reaction, the watchdog, ..
+		template <typename T>
+		inline unsigned stateId() const							{ return _stateRegistry[TypeInfo::get<T>()];	}
+
+		// compile-time counterparts, for static tables, masks and side arrays keyed by state;
+		// ids are pre-order, so a state's sub-states follow it contiguously
+		using Path		= PathT<ReverseDepth>;
+		using Location	= LocationT<ReverseDepth>;
+
+		template <typename T>
+		static constexpr unsigned stateIndex();
+
+		template <typename T>
+		static constexpr Location locate();
+
+		template <typename T>
+		static constexpr unsigned parentOf()					{ return locate<T>().parent;						}
+
+		// the apex is at depth 0
+		template <typename T>
+		static constexpr unsigned depthOf()						{ return locate<T>().path.count;					}
+
+		template <typename T>
+		static constexpr Path pathOf()							{ return locate<T>().path;							}
+
+		template <typename T>
+		static constexpr StateRange subtreeRange()				{ return StateRange{stateIndex<T>(), locate<T>().end};	}
+
+		template <typename T>
+		static constexpr bool insideOrthogonal()				{ return locate<T>().orthogonal;					}
+
+		// bytes the state and its sub-states take in each machine instance (forks included),
+		// 0 for the states with no data, which aren't stored
+		template <typename T>
+		static constexpr unsigned footprintOf()					{ return stateIndex<T>(), Apex::template deepFootprint<T>();	}
+
+		// of the bookkeeping each composite and orthogonal region adds
+		static constexpr unsigned forkFootprint()				{ return sizeof(Fork);										}
+
+	#ifdef HFSM_ENABLE_EVENT_STATS
+		void attachEventStats(EventStats* const eventStats)					{ _eventStats = eventStats;	}
+	#endif
+
+	#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+		void attachSubstitutionStats(SubstitutionStats* const stats)		{ _substitutionStats = stats;	}
+	#endif
+
+	#ifdef HFSM_ENABLE_COVERAGE
+		// pass to the constructor instead to cover the initial states, too
+		// (checked at run time there, and left detached if too small)
+		template <unsigned TStateCapacity>
+		void attachCoverage(CoverageT<TStateCapacity>* const coverage) {
+			static_assert(StateCount <= TStateCapacity, "Coverage too small for the machine, see CoverageT<>'s TStateCapacity.");
+
+			_coverage = coverage;
+		}
+
+		void detachCoverage()												{ _coverage = &_coverageSink;	}
+
+		// (fork, prong) pairs switched to, as recorded by the attached coverage, returns their count
+		unsigned exportTransitions(typename Coverage::Prong* const prongs, const unsigned capacity) const;
+	#endif
+
+	#ifdef HFSM_ENABLE_SCRATCH
+		// pass to the constructor instead to give the initial states their arenas, too
+		void attachScratch(ScratchBlock* const scratch)						{ _scratch = scratch;		}
+	#endif
+
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+		// events constructed in place in fixed buffers of TCapacity bytes per lane,
+		// reacted to later as rvalues, then destroyed;
+		// higher lanes go first, pre-empting the lower ones between any two events,
+		// each lane keeps its own order
+		template <unsigned TCapacity, unsigned TLaneCount = 1>
+		class EventQueueT {
+			struct Entry {
+				void (*react)(_R& machine, void* const event);
+				void (*destroy)(void* const event);
+				unsigned event;		// offsets in the lane's buffer
+				unsigned next;
+			};
+
+		public:
+			enum : unsigned {
+				LaneCount = TLaneCount,
+			};
+			static_assert(LaneCount > 0, "");
+
+			struct Counters {
+				unsigned emplaced;
+				unsigned dispatched;
+				unsigned dropped;		// out of room
+				unsigned preempting;	// dispatched ahead of events pending in the lower lanes
+			};
+
+		private:
+			struct Lane {
+				alignas(std::max_align_t) char buffer[TCapacity];
+
+				unsigned head = 0;
+				unsigned tail = 0;
+				unsigned count = 0;
+
+				Counters counters = {};
+			};
+
+		public:
+			EventQueueT() = default;
+			EventQueueT(const EventQueueT&) = delete;
+			EventQueueT& operator = (const EventQueueT&) = delete;
+
+			~EventQueueT()									{ clear();							}
+
+			// into the lowest lane, false once out of room
+			template <typename TEvent, typename... TArgs>
+			inline bool emplace(TArgs&&... args)			{ return emplaceIn<TEvent>(0, std::forward<TArgs>(args)...);	}
+
+			template <typename TEvent, typename... TArgs>
+			bool emplaceIn(const unsigned lane, TArgs&&... args);
+
+			// including the events emplaced while reacting,
+			// each reaction followed by the transitions it requested
+			void dispatch(_R& machine);
+
+			unsigned count() const;
+			inline unsigned count(const unsigned lane) const			{ assert(lane < LaneCount); return _lanes[lane].count;		}
+
+			inline const Counters& counters(const unsigned lane) const	{ assert(lane < LaneCount); return _lanes[lane].counters;	}
+			void clearCounters();
+
+			// destroys the events without reacting, can be called from the reactions
+			void clear();
+			void clear(const unsigned lane);
+
+		private:
+			template <typename TEvent>
+			static void react(_R& machine, void* const event)	{ machine.react(std::move(*static_cast<TEvent*>(event)));	}
+
+			template <typename TEvent>
+			static void destroy(void* const event)				{ static_cast<TEvent*>(event)->~TEvent();					}
+
+			static constexpr unsigned align(const unsigned offset, const unsigned alignment)	{ return (offset + alignment - 1) & ~(alignment - 1);	}
+
+		private:
+			Lane _lanes[LaneCount];
+			bool _dispatching = false;
+		};
+
+	protected:
+		template <typename TEvent>
+		Reaction dispatch(TEvent& event) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+	#ifdef HFSM_VARIANT_EVENTS
+		// TVariant is const for the variants passed by reference
+		template <typename TVariant, std::size_t... TIndices>
+		Reaction reactVariant(TVariant& events, std::index_sequence<TIndices...>);
+
+		template <typename TVariant, std::size_t TIndex>
+		static Reaction reactAlternative(_R& machine, TVariant& events);
+	#endif
+
+		void processTransitions() HFSM_NOEXCEPT(NoexceptTransitions);
+		void requestImmediate(const Transition request) HFSM_NOEXCEPT(true);
+		void requestScheduled(const Transition request) HFSM_NOEXCEPT(true);
+
+		inline unsigned id(const Transition request) const	{ return _stateRegistry[*request.stateType];	}
+
+		inline Control control() HFSM_NOEXCEPT(true);
+
+		HFSM_IF_LOGGER(inline void sampleLogging() HFSM_NOEXCEPT(true));
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		static const StaticStructure& staticStructure();
+	#endif
+
+	private:
+		// only touched while processing transitions
+		// (constructed ahead of _apex, which fills them in)
+		StateRegistryImpl _stateRegistry;
+
+		StateParentStorage _stateParents;
+		ForkParentStorage  _forkParents;
+		ForkPointerStorage _forkPointers;
+
+		// touched on every update() / react(), starts on its own cache line with HFSM_CACHE_LINE_SIZE defined
+		HFSM_ALIGN_HOT TransitionQueueStorage _requests;
+
+		Context& _context;
+
+		Apex _apex;
+
+		Propagation _propagation = Propagation::RootFirst;
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		StateActivityStorage _activities;
+		unsigned _activityTick = 0;
+		ActivityHistoryStorage _activityHistory;
+
+		struct DebugTransitionInfo {
+			typename Transition::Type type;
+			TypeInfo state;
+
+			enum Source {
+				Update,
+				Substitute,
+				Linger,
+
+				COUNT
+			};
+			Source source;
+
+			inline DebugTransitionInfo() = default;
+
+			inline DebugTransitionInfo(const Transition transition,
+									   const Source source_)
+				: type(transition.type)
+				, state(transition.stateType)
+				, source(source_)
+			{
+				assert(source_ < Source::COUNT);
+			}
+		};
+		// each round's requests, and the substitutions they led to
+		using DebugTransitionInfos = Array<DebugTransitionInfo, 2 * MaxSubstitutions * ForkCount>;
+		DebugTransitionInfos _lastTransitions;
+	#endif
+
+	#ifdef HFSM_ENABLE_LOG_INTERFACE
+		LoggerInterface* _logger;
+
+		LogSampling* _sampling = nullptr;
+		unsigned _samplingIndex = 0;
+		unsigned _samplingTick = 0;
+		bool _sampled = true;
+	#endif
+
+		HFSM_IF_WATCHDOG(Watchdog* _watchdog = nullptr);
+		HFSM_IF_EVENT_STATS(EventStats* _eventStats = nullptr);
+	#ifdef HFSM_ENABLE_COVERAGE
+		// written to while no coverage is attached, so recording a state takes no checks
+		CoverageT<StateCount> _coverageSink;
+		Coverage* _coverage;
+	#endif
+
+		HFSM_IF_SUBSTITUTION_STATS(SubstitutionStats* _substitutionStats = nullptr);
+		HFSM_IF_SCRATCH(ScratchBlock* _scratch = nullptr);
+	};
+
+	//----------------------------------------------------------------------
+
+public:
+
+	class Control final {
+		template <typename>
+		friend class _R;
+
+		template <unsigned, bool, typename>
+		friend struct _S;
+
+		template <unsigned, bool, typename, typename...>
+		friend struct _C;
+
+		template <unsigned, bool, typename, typename...>
+		friend struct _O;
+
+		template <unsigned>
+		friend class LoweredT;
+
+	private:
+		Control(TransitionQueue& requests,
+				const StateRegistry* const stateRegistry
+				HFSM_IF_LOGGER(, LoggerInterface* const logger)
+				HFSM_IF_STRUCTURE(, StateActivities& activities)
+				HFSM_IF_STRUCTURE(, const unsigned tick)
+				HFSM_IF_WATCHDOG(, Watchdog* const watchdog)
+				HFSM_IF_COVERAGE(, Coverage* const coverage)
+				HFSM_IF_SCRATCH(, ScratchBlock* const scratch))
+			: _requests(requests)
+			, _stateRegistry(stateRegistry)
+			HFSM_IF_LOGGER(, _logger(logger))
+			HFSM_IF_STRUCTURE(, _activities(activities))
+			HFSM_IF_STRUCTURE(, _tick(tick))
+			HFSM_IF_WATCHDOG(, _watchdog(watchdog))
+			HFSM_IF_COVERAGE(, _coverage(coverage))
+			HFSM_IF_SCRATCH(, _scratch(scratch))
+		{}
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		inline void notifyEnter(const unsigned state)		HFSM_NOEXCEPT(true)	{ _activities[state] = StateActivity { _tick, true  };	}
+		inline void notifyLeave(const unsigned state)		HFSM_NOEXCEPT(true)	{ _activities[state] = StateActivity { _tick, false };	}
+	#endif
+
+	#ifdef HFSM_ENABLE_WATCHDOG
+		using WatchCallback = typename Watchdog::Callback;
+		using WatchTime		= typename Watchdog::TimePoint;
+
+		// the clock is only read with a watchdog attached
+		inline WatchTime watchBegin() const					HFSM_NOEXCEPT(true)	{ return _watchdog ? Watchdog::Clock::now() : WatchTime();	}
+
+		inline void watchEnd(const unsigned state,
+							 const WatchCallback callback,
+							 const WatchTime begin)			HFSM_NOEXCEPT(true)	{ if (_watchdog) _watchdog->check(state, callback, begin);	}
+
+		inline void watchEnter(const unsigned state)		HFSM_NOEXCEPT(true)	{ if (_watchdog) _watchdog->entered(state);				}
+	#endif
+
+	#ifdef HFSM_ENABLE_EVENT_STATS
+		using EventEntry = typename EventStats::Entry;
+
+		inline void countReact(const bool handled)			HFSM_NOEXCEPT(true)	{ if (_eventEntry) { ++_eventEntry->visited; _eventEntry->handled += handled; }	}
+	#endif
+
+	#ifdef HFSM_ENABLE_COVERAGE
+		inline void coverEnter(const unsigned state)		HFSM_NOEXCEPT(true)	{ _coverage->enter(state);				}
+		inline void coverSwitch(const unsigned state)		HFSM_NOEXCEPT(true)	{ _coverage->switchTo(state);			}
+	#endif
+
+		// any of the requests queued since 'from' restarting or resuming a state outside of 'range'
+		template <typename TStateId>
+		inline bool leaves(const unsigned from, const StateRange range, TStateId&& stateId) const HFSM_NOEXCEPT(true) {
+			for (unsigned i = from; i < _requests.count(); ++i) {
+				const Transition& request = _requests[i];
+
+				if ((request.type == Transition::Restart || request.type == Transition::Resume) &&
+					!range.contains(stateId(request.stateType)))
+					return true;
+			}
+
+			return false;
+		}
+
+		inline bool leaves(const unsigned from, const StateRange range) const HFSM_NOEXCEPT(true) {
+			return leaves(from, range, [this](const TypeInfo stateType) { return _stateRegistry->find(stateType); });
+		}
+
+	#ifdef HFSM_ENABLE_SCRATCH
+		inline void scratchEnter(const unsigned state, Scratch& scratch) HFSM_NOEXCEPT(true);
+		inline void scratchLeave(Scratch& scratch)			HFSM_NOEXCEPT(true)	{ scratch._used = 0;	}
+	#endif
+
+	public:
+		template <typename T>
+		inline void changeTo()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void resume()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Resume,	  TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void schedule()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
+
+		inline unsigned requestCount() const				HFSM_NOEXCEPT(true)	{ return _requests.count();	}
+
+		// in react() only, keeps the event from the states yet to be offered it
+		inline void consume()								HFSM_NOEXCEPT(true)	{ _consumed = true;			}
+		inline bool consumed() const						HFSM_NOEXCEPT(true)	{ return _consumed;			}
+
+	private:
+		inline bool leafFirst() const						HFSM_NOEXCEPT(true)	{ return _propagation == Propagation::LeafFirst;	}
 
 	private:
 		TransitionQueue& _requests;
+		const StateRegistry* const _stateRegistry;		// null in the lowered machines, which look states up themselves
+		HFSM_IF_LOGGER(LoggerInterface* const _logger);
+		HFSM_IF_STRUCTURE(StateActivities& _activities);
+		HFSM_IF_STRUCTURE(const unsigned _tick);
+		HFSM_IF_WATCHDOG(Watchdog* const _watchdog);
+		HFSM_IF_EVENT_STATS(EventEntry* _eventEntry = nullptr);	// set by react() only
+		HFSM_IF_COVERAGE(Coverage* const _coverage);
+		HFSM_IF_SCRATCH(ScratchBlock* const _scratch);
+
+		// set by react() only
+		Propagation _propagation = Propagation::RootFirst;
+		bool _consumed = false;
+		unsigned _consumer = Reaction::NONE;
+	};
+
+#pragma endregion
+
+	//----------------------------------------------------------------------
+
+#pragma region Lowering
+
+	// base of the standalone machines emitted by tools/lower.py:
+	// owns the request queue, and hands the user states the same Control
+	template <unsigned TRequestCapacity>
+	class LoweredT {
+	public:
+		using Propagation		  = typename M::Propagation;
+		using Reaction			  = typename M::Reaction;
+
+		inline void propagation(const Propagation order)	HFSM_NOEXCEPT(true)	{ _propagation = order;		}
+		inline Propagation propagation() const				HFSM_NOEXCEPT(true)	{ return _propagation;		}
+
+	protected:
+		using Transition		  = typename M::Transition;
+		using TypeInfo			  = typename M::TypeInfo;
+		using SubstitutionHistory = typename M::template SubstitutionHistoryT<TRequestCapacity>;
+		using History			  = typename M::History;
+		using StateRange		  = typename M::StateRange;
+
+		enum : unsigned { MaxSubstitutions = M::MaxSubstitutions };
+
+		template <typename THead>
+		static constexpr bool skipsObsoleteUpdates()		{ return M::template skipsObsoleteUpdates<THead>(nullptr);	}
+
+		template <typename THead>
+		static constexpr History historyOf()				{ return M::template historyOf<THead>(nullptr);				}
+
+		template <typename THead, typename TEvent>
+		static constexpr bool takesOver()					{ return M::template takesOver<THead, TEvent>(nullptr);		}
+
+		template <typename THead, typename TEvent>
+		using PassedEvent = typename M::template PassedEvent<THead, TEvent>;
+
+		inline Control control() HFSM_NOEXCEPT(true) {
+			return Control(_requests,
+						   nullptr
+						   HFSM_IF_LOGGER(, nullptr)
+						   HFSM_IF_STRUCTURE(, _activities)
+						   HFSM_IF_STRUCTURE(, 0)
+						   HFSM_IF_WATCHDOG(, nullptr)
+						   HFSM_IF_COVERAGE(, nullptr)
+						   HFSM_IF_SCRATCH(, nullptr));
+		}
+
+		// for react()
+		inline Control reactControl() HFSM_NOEXCEPT(true) {
+			Control control = this->control();
+			control._propagation = _propagation;
+
+			return control;
+		}
+
+		static inline bool leafFirst(const Control& control)	HFSM_NOEXCEPT(true)	{ return control.leafFirst();	}
+
+		// with the lowered machine's own state lookup, Control has no registry here
+		template <typename TStateId>
+		static inline bool leaves(const Control& control,
+								  const unsigned from,
+								  const StateRange range,
+								  TStateId&& stateId)			HFSM_NOEXCEPT(true)
+		{
+			return control.leaves(from, range, std::forward<TStateId>(stateId));
+		}
+
+		static inline void reacted(Control& control, const unsigned state) HFSM_NOEXCEPT(true) {
+			if (control._consumed && control._consumer == Reaction::NONE)
+				control._consumer = state;
+		}
+
+		static inline Reaction reaction(const Control& control) HFSM_NOEXCEPT(true) {
+			Reaction reaction;
+			reaction.consumer = control._consumer;
+
+			return reaction;
+		}
+
+		Array<Transition, TRequestCapacity> _requests;
+		Propagation _propagation = Propagation::RootFirst;
+
+		// only written by the template engine
+		HFSM_IF_STRUCTURE(Array<StateActivity, 1> _activities);
 	};
 
 #pragma endregion
@@ -577,18 +1856,18 @@ public:
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 	template <typename TState, typename... TSubStates>
-	using Composite	= _C<TState, TSubStates...>;
+	using Composite	= _CI<TState, TSubStates...>;
 
 	template <typename... TSubStates>
-	using CompositePeers = _C<Base, TSubStates...>;
+	using CompositePeers = _CI<Base, TSubStates...>;
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 	template <typename TState, typename... TSubStates>
-	using Orthogonal = _O<TState, TSubStates...>;
+	using Orthogonal = _OI<TState, TSubStates...>;
 
 	template <typename... TSubStates>
-	using OrthogonalPeers = _O<Base, TSubStates...>;
+	using OrthogonalPeers = _OI<Base, TSubStates...>;
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -609,8 +1888,10 @@ public:
 #pragma endregion
 };
 
-template <typename TContext, unsigned TMaxSubstitutions = 4>
-using Machine = M<TContext, TMaxSubstitutions>;
+template <typename TContext,
+		  unsigned TMaxSubstitutions = 4,
+		  typename TLogFilter = LogFilter<>>
+using Machine = M<TContext, TMaxSubstitutions, TLogFilter>;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -620,4 +1901,8 @@ using Machine = M<TContext, TMaxSubstitutions>;
 
 #undef HFSM_IF_STRUCTURE
 #undef HFSM_IF_LOGGER
-#undef HFSM_LOGGER_OR
+#undef HFSM_IF_WATCHDOG
+#undef HFSM_IF_EVENT_STATS
+#undef HFSM_IF_COVERAGE
+#undef HFSM_IF_SUBSTITUTION_STATS
+#undef HFSM_IF_SCRATCH
@@ -32,148 +32,17 @@
 #include <assert.h>
 #include <string.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <new>
+#include <type_traits>
 #include <typeindex>
 #include <utility>
 
-
-
-namespace hfsm {
-namespace detail {
-
-////////////////////////////////////////////////////////////////////////////////
-
-#pragma pack(push, 4)
-
-template <typename T>
-class ArrayView {
-public:
-	using Item = T;
-
-	template <typename>
-	friend class Iterator;
-
-protected:
-	ArrayView(const unsigned capacity);
-	~ArrayView();
-
-public:
-	inline void clear()										{ _count = 0;				}
-
-	inline unsigned resize(const unsigned count);
-
-	template <typename TValue>
-	inline unsigned operator << (TValue&& value);
-
-	inline		 Item& operator[] (const unsigned i)		{ return get(i);			}
-	inline const Item& operator[] (const unsigned i) const	{ return get(i);			}
-
-	inline unsigned capacity() const						{ return _capacity;			}
-	inline unsigned count() const							{ return _count;			}
-
-protected:
-	inline unsigned first() const							{ return 0;					}
-	inline unsigned limit() const							{ return _count;			}
-
-	inline unsigned prev(const unsigned i) const			{ return i - 1;				}
-	inline unsigned next(const unsigned i) const			{ return i + 1;				}
-
-	inline		 Item& get(const unsigned i);
-	inline const Item& get(const unsigned i) const;
-
-private:
-	// hacks
-	inline		 Item* data()		{ return reinterpret_cast<		Item*>(&_count + 1);	}
-	inline const Item* data() const	{ return reinterpret_cast<const Item*>(&_count + 1);	}
-
-protected:
-	const unsigned _capacity;
-	unsigned _count = 0;
-};
-
-#pragma pack(pop)
-
-////////////////////////////////////////////////////////////////////////////////
-
-}
-}
-
-namespace hfsm {
-namespace detail {
-
-////////////////////////////////////////////////////////////////////////////////
-
-template <typename T>
-ArrayView<T>::ArrayView(const unsigned capacity)
-	: _capacity(capacity)
-{}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename T>
-ArrayView<T>::~ArrayView() {
-	if (_count > 0)
-		for (int i = _count - 1; i >= 0; --i)
-			get(i).~Item();
-}
-
-//------------------------------------------------------------------------------
-
-template <typename T>
-unsigned
-ArrayView<T>::resize(const unsigned count) {
-	const unsigned clampedCount = count < _capacity ?
-		count : _capacity;
-
-	if (clampedCount > _count) {
-		for (unsigned i = _count; i < clampedCount; ++i)
-			get(i) = Item();
-	}
-	else if (clampedCount < _count) {
-		for (unsigned i = _count - 1; i >= clampedCount; --i)
-			get(i).~Item();
-	}
-
-	return _count = clampedCount;
-}
-
-//------------------------------------------------------------------------------
-
-template <typename T>
-template <typename TValue>
-unsigned
-ArrayView<T>::operator << (TValue&& value) {
-	assert(_count < _capacity);
-
-	new (&get(_count)) Item(std::move(value));
-
-	return _count++;
-}
-
-//------------------------------------------------------------------------------
-
-template <typename T>
-T&
-ArrayView<T>::get(const unsigned i) {
-	assert(0 <= i && i < _capacity);
-
-	return data()[i];
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename T>
-const T&
-ArrayView<T>::get(const unsigned i) const {
-	assert(0 <= i && i < _capacity);
-
-	return data()[i];
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-}
-}
+#if defined HFSM_ENABLE_WATCHDOG || defined HFSM_ENABLE_SUBSTITUTION_STATS
+	#include <chrono>
+#endif
 
 
 #if defined _DEBUG && _MSC_VER
@@ -190,10 +59,13 @@ ArrayView<T>::get(const unsigned i) const {
 	#define HSFM_CHECKED(x)			x
 #endif
 
-#ifdef _DEBUG
-	#define HSFM_IF_DEBUG(...)		__VA_ARGS__
+// type info copies in forks, parents and nodes, kept up to date on every transition;
+// the fast debug profile drops them (and keeps the asserts),
+// the debugger can still get them from indices via M::_R::stateType() / prongType()
+#if defined _DEBUG && !defined HFSM_ENABLE_FAST_DEBUG
+	#define HSFM_IF_DEBUG_TYPES(...)	__VA_ARGS__
 #else
-	#define HSFM_IF_DEBUG(...)
+	#define HSFM_IF_DEBUG_TYPES(...)
 #endif
 
 #ifndef NDEBUG
@@ -202,6 +74,33 @@ ArrayView<T>::get(const unsigned i) const {
 	#define HSFM_IF_ASSERT(...)
 #endif
 
+// opt-in alignment of the per-tick block in the root, define to the target's cache line size
+// (over-aligned machines can only be heap-allocated with c++17 aligned 'new');
+// left undefined, the layout is the same for every standard
+#ifdef HFSM_CACHE_LINE_SIZE
+	#define HFSM_ALIGN_HOT	alignas(HFSM_CACHE_LINE_SIZE)
+#else
+	#define HFSM_ALIGN_HOT
+#endif
+
+// msvc only lays the first empty base out at no cost, unless told otherwise
+#ifdef _MSC_VER
+	#define HFSM_EMPTY_BASES	__declspec(empty_bases)
+#else
+	#define HFSM_EMPTY_BASES
+#endif
+
+// react() takes std::variant<> events from c++17 on
+#if __cplusplus >= 201703L || defined _MSVC_LANG && _MSVC_LANG >= 201703L
+	#define HFSM_VARIANT_EVENTS
+#endif
+
+#ifdef HFSM_ENABLE_NOEXCEPT
+	#define HFSM_NOEXCEPT(...)		noexcept(__VA_ARGS__)
+#else
+	#define HFSM_NOEXCEPT(...)
+#endif
+
 //------------------------------------------------------------------------------
 
 namespace hfsm {
@@ -216,6 +115,21 @@ fill(T& a, const char value) {
 	memset(&a, (int) value, sizeof(a));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+inline
+bool
+isZero(const T& a) {
+	const char* const bytes = reinterpret_cast<const char*>(&a);
+
+	for (unsigned i = 0; i < sizeof(a); ++i)
+		if (bytes[i] != 0)
+			return false;
+
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename T, unsigned TCount>
@@ -263,6 +177,41 @@ struct Max {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// a T held as a member, or, when empty, as a private base taking no room (empty base optimization, any standard);
+// derive from it, as the empty ones of different types share their address
+template <typename T, bool = std::is_empty<T>::value && !std::is_final<T>::value>
+class Compact {
+public:
+	template <typename... TArgs>
+	inline Compact(TArgs&&... args)
+		: _item(std::forward<TArgs>(args)...)
+	{}
+
+	inline		 T& get()		HFSM_NOEXCEPT(true)	{ return _item;	}
+	inline const T& get() const	HFSM_NOEXCEPT(true)	{ return _item;	}
+
+private:
+	T _item;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+class Compact<T, true>
+	: private T
+{
+public:
+	template <typename... TArgs>
+	inline Compact(TArgs&&... args)
+		: T(std::forward<TArgs>(args)...)
+	{}
+
+	inline		 T& get()		HFSM_NOEXCEPT(true)	{ return *this;	}
+	inline const T& get() const	HFSM_NOEXCEPT(true)	{ return *this;	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 template <unsigned t>
 struct PowerOf2 {
 	enum {
@@ -327,76 +276,88 @@ struct NextPowerOf2 {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-}
-}
+template <typename T, typename... TS>
+struct Contains {
+	enum {
+		Value = false
+	};
+};
 
-namespace hfsm {
-namespace detail {
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T, typename TFirst, typename... TRest>
+struct Contains<T, TFirst, TRest...> {
+	enum {
+		Value = std::is_same<T, TFirst>::value || Contains<T, TRest...>::Value
+	};
+};
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContainer>
-class Iterator {
-public:
-	using Container = TContainer;
-	using Item = typename Container::Item;
+}
+}
 
-	template <typename T, unsigned TCapacity>
-	friend class Array;
+#ifdef HFSM_VARIANT_EVENTS
+	#include <variant>
+#endif
 
-private:
-	inline Iterator(Container& container, const unsigned cursor)
-		: _container(container)
-		, _cursor(cursor)
-	{}
 
-public:
-	inline bool operator != (const Iterator<Container>& dummy) const;
 
-	inline Iterator& operator ++();
 
-	inline		 Item& operator *()		  { return _container[_cursor]; }
-	inline const Item& operator *() const { return _container[_cursor]; }
+namespace hfsm {
+namespace detail {
 
-	inline		 Item* operator->()		  { return &operator *();		}
-	inline const Item* operator->() const { return &operator *();		}
+////////////////////////////////////////////////////////////////////////////////
 
-private:
-	Container& _container;
+// the items are owned by the derived Array, and stored right after the view;
+// the view is aligned (and so padded) for the items, so they start at 'this + 1' whatever their alignment
+template <typename T>
+class alignas(alignof(T) > alignof(unsigned) ? alignof(T) : alignof(unsigned)) ArrayView {
+public:
+	using Item = T;
 
-	unsigned _cursor;
-};
+	template <typename>
+	friend class Iterator;
 
-//------------------------------------------------------------------------------
+protected:
+	ArrayView(const unsigned capacity);
+	~ArrayView();
+
+	ArrayView(const ArrayView&) = delete;
+	ArrayView& operator = (const ArrayView&) = delete;
 
-template <typename TContainer>
-class Iterator<const TContainer> {
 public:
-	using Container = TContainer;
-	using Item = typename Container::Item;
+	inline void clear()								HFSM_NOEXCEPT(true)	{ _count = 0;				}
 
-	template <typename T, unsigned TCapacity>
-	friend class Array;
+	inline unsigned resize(const unsigned count) HFSM_NOEXCEPT(std::is_nothrow_default_constructible<Item>::value);
 
-private:
-	inline Iterator(const Container& container, const unsigned cursor)
-		: _container(container)
-		, _cursor(cursor)
-	{}
+	template <typename TValue>
+	inline unsigned operator << (TValue&& value) HFSM_NOEXCEPT(std::is_nothrow_constructible<Item, TValue&&>::value);
 
-public:
-	inline bool operator != (const Iterator<const Container>& dummy) const;
+	inline		 Item& operator[] (const unsigned i)		HFSM_NOEXCEPT(true)	{ return get(i);			}
+	inline const Item& operator[] (const unsigned i) const	HFSM_NOEXCEPT(true)	{ return get(i);			}
 
-	inline Iterator& operator ++();
+	inline unsigned capacity() const				HFSM_NOEXCEPT(true)	{ return _capacity;			}
+	inline unsigned count() const					HFSM_NOEXCEPT(true)	{ return _count;			}
 
-	inline const Item& operator *() const { return _container[_cursor]; }
+protected:
+	inline unsigned first() const							{ return 0;					}
+	inline unsigned limit() const							{ return _count;			}
 
-	inline const Item* operator->() const { return &operator *();		}
+	inline unsigned prev(const unsigned i) const			{ return i - 1;				}
+	inline unsigned next(const unsigned i) const			{ return i + 1;				}
+
+	inline		 Item& get(const unsigned i) HFSM_NOEXCEPT(true);
+	inline const Item& get(const unsigned i) const HFSM_NOEXCEPT(true);
 
 private:
-	const Container& _container;
+	// through an integer, as the items lie past the view object itself
+	inline		 Item* data()		HFSM_NOEXCEPT(true)	{ return reinterpret_cast<	   Item*>(reinterpret_cast<std::uintptr_t>(this) + sizeof(ArrayView));	}
+	inline const Item* data() const	HFSM_NOEXCEPT(true)	{ return reinterpret_cast<const Item*>(reinterpret_cast<std::uintptr_t>(this) + sizeof(ArrayView));	}
 
-	unsigned _cursor;
+protected:
+	const unsigned _capacity;
+	unsigned _count = 0;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -409,18 +370,170 @@ namespace detail {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContainer>
-bool
-Iterator<TContainer>::operator != (const Iterator<TContainer>& HSFM_IF_ASSERT(dummy)) const {
-	assert(&_container == &dummy._container);
+template <typename T>
+ArrayView<T>::ArrayView(const unsigned capacity)
+	: _capacity(capacity)
+{}
 
-	return _cursor != _container.limit();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+ArrayView<T>::~ArrayView() {
+	if (_count > 0)
+		for (int i = _count - 1; i >= 0; --i)
+			get(i).~Item();
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TContainer>
-Iterator<TContainer>&
+template <typename T>
+unsigned
+ArrayView<T>::resize(const unsigned count) HFSM_NOEXCEPT(std::is_nothrow_default_constructible<Item>::value) {
+	const unsigned clampedCount = count < _capacity ?
+		count : _capacity;
+
+	if (clampedCount > _count) {
+		for (unsigned i = _count; i < clampedCount; ++i)
+			get(i) = Item();
+	}
+	else if (clampedCount < _count) {
+		for (unsigned i = _count; i > clampedCount; --i)
+			get(i - 1).~Item();
+	}
+
+	return _count = clampedCount;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+template <typename TValue>
+unsigned
+ArrayView<T>::operator << (TValue&& value) HFSM_NOEXCEPT(std::is_nothrow_constructible<Item, TValue&&>::value) {
+	assert(_count < _capacity);
+
+	new (&get(_count)) Item(std::move(value));
+
+	return _count++;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+T&
+ArrayView<T>::get(const unsigned i) HFSM_NOEXCEPT(true) {
+	assert(0 <= i && i < _capacity);
+
+	return data()[i];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+const T&
+ArrayView<T>::get(const unsigned i) const HFSM_NOEXCEPT(true) {
+	assert(0 <= i && i < _capacity);
+
+	return data()[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+
+namespace hfsm {
+namespace detail {
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename TContainer>
+class Iterator {
+public:
+	using Container = TContainer;
+	using Item = typename Container::Item;
+
+	template <typename T, unsigned TCapacity>
+	friend class Array;
+
+private:
+	inline Iterator(Container& container, const unsigned cursor)
+		: _container(container)
+		, _cursor(cursor)
+	{}
+
+public:
+	inline bool operator != (const Iterator<Container>& dummy) const;
+
+	inline Iterator& operator ++();
+
+	inline		 Item& operator *()		  { return _container[_cursor]; }
+	inline const Item& operator *() const { return _container[_cursor]; }
+
+	inline		 Item* operator->()		  { return &operator *();		}
+	inline const Item* operator->() const { return &operator *();		}
+
+private:
+	Container& _container;
+
+	unsigned _cursor;
+};
+
+//------------------------------------------------------------------------------
+
+template <typename TContainer>
+class Iterator<const TContainer> {
+public:
+	using Container = TContainer;
+	using Item = typename Container::Item;
+
+	template <typename T, unsigned TCapacity>
+	friend class Array;
+
+private:
+	inline Iterator(const Container& container, const unsigned cursor)
+		: _container(container)
+		, _cursor(cursor)
+	{}
+
+public:
+	inline bool operator != (const Iterator<const Container>& dummy) const;
+
+	inline Iterator& operator ++();
+
+	inline const Item& operator *() const { return _container[_cursor]; }
+
+	inline const Item* operator->() const { return &operator *();		}
+
+private:
+	const Container& _container;
+
+	unsigned _cursor;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+namespace hfsm {
+namespace detail {
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename TContainer>
+bool
+Iterator<TContainer>::operator != (const Iterator<TContainer>& HSFM_IF_ASSERT(dummy)) const {
+	assert(&_container == &dummy._container);
+
+	return _cursor != _container.limit();
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TContainer>
+Iterator<TContainer>&
 Iterator<TContainer>::operator ++() {
 	_cursor = _container.next(_cursor);
 
@@ -457,8 +570,6 @@ namespace detail {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#pragma pack(push, 4)
-
 template <typename T, unsigned TCapacity>
 class StaticArray {
 public:
@@ -473,8 +584,8 @@ public:
 public:
 	inline StaticArray() = default;
 
-	inline		 Item& operator[] (const unsigned i);
-	inline const Item& operator[] (const unsigned i) const;
+	inline		 Item& operator[] (const unsigned i) HFSM_NOEXCEPT(true);
+	inline const Item& operator[] (const unsigned i) const HFSM_NOEXCEPT(true);
 
 	inline const unsigned count() const						{ return CAPACITY; }
 
@@ -522,8 +633,6 @@ private:
 	Item _storage[CAPACITY];
 };
 
-#pragma pack(pop)
-
 ////////////////////////////////////////////////////////////////////////////////
 
 }
@@ -536,7 +645,7 @@ namespace detail {
 
 template <typename T, unsigned TCapacity>
 T&
-StaticArray<T, TCapacity>::operator[] (const unsigned i) {
+StaticArray<T, TCapacity>::operator[] (const unsigned i) HFSM_NOEXCEPT(true) {
 	assert(0 <= i && i < CAPACITY);
 
 	return _items[i];
@@ -546,7 +655,7 @@ StaticArray<T, TCapacity>::operator[] (const unsigned i) {
 
 template <typename T, unsigned TCapacity>
 const T&
-StaticArray<T, TCapacity>::operator[] (const unsigned i) const {
+StaticArray<T, TCapacity>::operator[] (const unsigned i) const HFSM_NOEXCEPT(true) {
 	assert(0 <= i && i < CAPACITY);
 
 	return _items[i];
@@ -593,7 +702,7 @@ public:
 	inline		 T* operator->()							{ return &get();				}
 	inline const T* operator->() const						{ return &get();				}
 
-	inline explicit operator bool() const					{ return _storage != 0;			}
+	inline explicit operator bool() const					{ return !isZero(_storage);		}
 
 	inline bool operator == (const Wrap other) const		{ return get() == other.get();	}
 
@@ -688,13 +797,16 @@ public:
 
 	bool insert(const Key key, const Value value);
 
-		  Value* find(const Key key);
-	const Value* find(const Key key) const;
+		  Value* find(const Key key) HFSM_NOEXCEPT(true);
+	const Value* find(const Key key) const HFSM_NOEXCEPT(true);
+
+	// reverse lookup, linear
+	const Key* findKey(const Value& value) const;
 
 	inline unsigned count() const						{ return _count;						}
 
 private:
-	unsigned locate(const Key key) const;
+	unsigned locate(const Key key) const HFSM_NOEXCEPT(true);
 
 	inline unsigned probeCount(const unsigned i) const;
 
@@ -794,7 +906,7 @@ HashTable<TK, TV, TC, TH>::insert(const Key key, const Value value) {
 
 template <typename TK, typename TV, unsigned TC, typename TH>
 typename HashTable<TK, TV, TC, TH>::Value*
-HashTable<TK, TV, TC, TH>::find(const Key key) {
+HashTable<TK, TV, TC, TH>::find(const Key key) HFSM_NOEXCEPT(true) {
 	const unsigned index = locate(key);
 
 	return index != INVALID ?
@@ -805,18 +917,30 @@ HashTable<TK, TV, TC, TH>::find(const Key key) {
 
 template <typename TK, typename TV, unsigned TC, typename TH>
 const typename HashTable<TK, TV, TC, TH>::Value*
-HashTable<TK, TV, TC, TH>::find(const Key key) const {
+HashTable<TK, TV, TC, TH>::find(const Key key) const HFSM_NOEXCEPT(true) {
 	const unsigned index = locate(key);
 
 	return index != INVALID ?
 		_items[index].value() : nullptr;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TK, typename TV, unsigned TC, typename TH>
+const typename HashTable<TK, TV, TC, TH>::Key*
+HashTable<TK, TV, TC, TH>::findKey(const Value& value) const {
+	for (unsigned i = 0; i < CAPACITY; ++i)
+		if (_items[i].occupied() && *_items[i].value() == value)
+			return &_items[i].key();
+
+	return nullptr;
+}
+
 //------------------------------------------------------------------------------
 
 template <typename TK, typename TV, unsigned TC, typename TH>
 unsigned
-HashTable<TK, TV, TC, TH>::locate(const Key key) const {
+HashTable<TK, TV, TC, TH>::locate(const Key key) const HFSM_NOEXCEPT(true) {
 	const Item item(hash(key), key);
 
 	for (unsigned i = index(item.hash()), distance = 0;
@@ -870,31 +994,190 @@ HashTable<TK, TV, TC, TH>::skipVacantForward(const unsigned i) const {
 }
 }
 
+#include <functional>
+
 
 namespace hfsm {
 namespace detail {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#if !defined(__GXX_RTTI) && !defined(_CPPRTTI)
+
+// without rtti, the address of a per-type tag stands in for std::type_index
+template <typename T>
+struct TypeTag {
+	static char tag;
+};
+
+template <typename T>
+char TypeTag<T>::tag;
+
+#endif
+
+//------------------------------------------------------------------------------
+
 class TypeInfo
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
 	: public Wrap<std::type_index>
 {
 	using Base = Wrap<std::type_index>;
 
 public:
 	typedef std::type_index Native;
+#else
+	: public Wrap<const void*>
+{
+	using Base = Wrap<const void*>;
+
+public:
+	typedef const void* Native;
+#endif
 
 public:
 	inline TypeInfo() = default;
 
-	inline TypeInfo(const std::type_index type)
+	inline TypeInfo(const Native type)
 		: Base(type)
 	{}
 
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
 	template <typename T>
 	static inline TypeInfo get() { return TypeInfo(typeid(T)); }
+#else
+	template <typename T>
+	static inline TypeInfo get() { return TypeInfo(&TypeTag<T>::tag); }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#include <utility>
+
+namespace hfsm {
+namespace detail {
+
+// compile-time type names, cut out of the compiler-generated function signature
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+	#define HFSM_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+	#define HFSM_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+constexpr const char*
+signature() {
+	return HFSM_FUNCTION_SIGNATURE;
+}
+
+#undef HFSM_FUNCTION_SIGNATURE
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+constexpr unsigned
+length(const char* const s) {
+	unsigned l = 0;
+	while (s[l])
+		++l;
+
+	return l;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+constexpr bool
+startsWith(const char* const s, const char* const prefix) {
+	for (unsigned i = 0; prefix[i]; ++i)
+		if (s[i] != prefix[i])
+			return false;
+
+	return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+constexpr unsigned
+find(const char* const s, const char* const pattern) {
+	for (unsigned i = 0; s[i]; ++i)
+		if (startsWith(s + i, pattern))
+			return i;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+// the signature of a known type tells where a type name starts and how much trails it
+struct SignatureLayout {
+	enum : unsigned {
+		Prefix = find(signature<double>(), "double"),
+		Suffix = length(signature<double>()) - Prefix - 6,
+	};
+};
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+struct TypeName {
+	// 'struct ' / 'class ' on msvc
+	static constexpr unsigned qualifiedBegin() {
+		return SignatureLayout::Prefix +
+			   (startsWith(signature<T>() + SignatureLayout::Prefix, "struct ") ? 7 :
+				startsWith(signature<T>() + SignatureLayout::Prefix, "class ")  ? 6 : 0);
+	}
+
+	static constexpr unsigned end() {
+		return length(signature<T>()) - SignatureLayout::Suffix;
+	}
+
+	// past the last '::' outside of template arguments
+	static constexpr unsigned unqualifiedBegin() {
+		unsigned begin = qualifiedBegin();
+
+		int depth = 0;
+		for (unsigned i = begin; i + 1 < end(); ++i) {
+			const char c = signature<T>()[i];
+
+			if (c == '<')
+				++depth;
+			else if (c == '>')
+				--depth;
+			else if (depth == 0 && c == ':' && signature<T>()[i + 1] == ':')
+				begin = i + 2;
+		}
+
+		return begin;
+	}
+
+	template <unsigned TBegin, typename>
+	struct Storage;
+
+	template <unsigned TBegin, std::size_t... TI>
+	struct Storage<TBegin, std::index_sequence<TI...>> {
+		static constexpr char value[] = { signature<T>()[TBegin + TI]..., '\0' };
+	};
+
+	using Qualified	  = Storage<qualifiedBegin(),	std::make_index_sequence<end() - qualifiedBegin()>>;
+	using Unqualified = Storage<unqualifiedBegin(), std::make_index_sequence<end() - unqualifiedBegin()>>;
+
+	static constexpr const char* qualified()	{ return Qualified::value;	}
+	static constexpr const char* unqualified()	{ return Unqualified::value;	}
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+template <unsigned TBegin, std::size_t... TI>
+constexpr char TypeName<T>::Storage<TBegin, std::index_sequence<TI...>>::value[];
+
 ////////////////////////////////////////////////////////////////////////////////
 
 }
@@ -910,10 +1193,38 @@ public:
 
 #ifdef HFSM_ENABLE_LOG_INTERFACE
 	#define HFSM_IF_LOGGER(...)		__VA_ARGS__
-	#define HFSM_LOGGER_OR(y, n)	y
 #else
 	#define HFSM_IF_LOGGER(...)
-	#define HFSM_LOGGER_OR(y, n)	n
+#endif
+
+#ifdef HFSM_ENABLE_WATCHDOG
+	#define HFSM_IF_WATCHDOG(...)	__VA_ARGS__
+#else
+	#define HFSM_IF_WATCHDOG(...)
+#endif
+
+#ifdef HFSM_ENABLE_EVENT_STATS
+	#define HFSM_IF_EVENT_STATS(...)	__VA_ARGS__
+#else
+	#define HFSM_IF_EVENT_STATS(...)
+#endif
+
+#ifdef HFSM_ENABLE_COVERAGE
+	#define HFSM_IF_COVERAGE(...)		__VA_ARGS__
+#else
+	#define HFSM_IF_COVERAGE(...)
+#endif
+
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+	#define HFSM_IF_SUBSTITUTION_STATS(...)	__VA_ARGS__
+#else
+	#define HFSM_IF_SUBSTITUTION_STATS(...)
+#endif
+
+#ifdef HFSM_ENABLE_SCRATCH
+	#define HFSM_IF_SCRATCH(...)		__VA_ARGS__
+#else
+	#define HFSM_IF_SCRATCH(...)
 #endif
 
 namespace hfsm {
@@ -922,9 +1233,9 @@ namespace hfsm {
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 struct StructureEntry {
-	bool isActive;
 	const wchar_t* prefix;
 	const char* name;
+	unsigned footprint;		// bytes taken by the state and its sub-states in each machine instance
 };
 using MachineStructure = detail::ArrayView<StructureEntry>;
 using MachineActivity  = detail::ArrayView<char>;
@@ -941,7 +1252,12 @@ struct LoggerInterface {
 		Leave,
 	};
 
-	virtual void record(const std::type_index& state,
+	static constexpr unsigned mask(const Method method)	{ return 1u << (unsigned) method;	}
+
+	// std::type_index, unless built without rtti
+	using StateType = detail::TypeInfo::Native;
+
+	virtual void record(const StateType& state,
 						const char* const stateName,
 						const Method method,
 						const char* const methodName) = 0;
@@ -965,9 +1281,27 @@ static const char* methodName(const LoggerInterface::Method method) {
 using LoggerInterface = void;
 #endif
 
-////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
 
-template <typename TContext, unsigned TMaxSubstitutions = 4>
+// compile-time logger filter: a mask of LoggerInterface::mask() bits,
+// and the roots of the subtrees to log (none for the whole machine)
+template <unsigned TMethods = (unsigned) -1, typename... TSubtrees>
+struct LogFilter {
+	enum : unsigned { Methods = TMethods };
+
+	enum : bool { Everywhere = sizeof...(TSubtrees) == 0 };
+
+	static constexpr bool logs(const unsigned method)	{ return (Methods >> method) & 1;		}
+
+	template <typename T>
+	static constexpr bool isSubtree()					{ return detail::Contains<T, TSubtrees...>::Value;	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename TContext,
+		  unsigned TMaxSubstitutions = 4,
+		  typename TLogFilter = LogFilter<>>
 class M {
 	using TypeInfo = detail::TypeInfo;
 
@@ -987,6 +1321,78 @@ public:
 	using Context = TContext;
 	class Control;
 
+	// what a composite remembers of its sub-states for resume(), declared by its head as
+	// 'static constexpr History HistoryPolicy = History::Shallow;'
+	enum class History {
+		None,		// nothing but schedule()-d prongs, resume() enters the initial prong otherwise
+		Shallow,	// the last active prong, entered with its own initial sub-states
+		Deep,		// the last active prong, its sub-states resumed in turn (default)
+	};
+
+	// the order react() offers the event to the active states in,
+	// until one of them calls Control::consume()
+	enum class Propagation {
+		RootFirst,	// each head ahead of its sub-states (default)
+		LeafFirst,	// each head after its sub-states
+	};
+
+#ifdef HFSM_VARIANT_EVENTS
+	// closed set of events, for the ones arriving type-erased
+	template <typename... TEvents>
+	using Events = std::variant<TEvents...>;
+#endif
+
+	// returned by react()
+	struct Reaction {
+		enum : unsigned { NONE = (unsigned) -1 };
+
+		unsigned consumer = NONE;	// id of the state that consumed the event
+
+		inline explicit operator bool() const				{ return consumer != NONE;	}
+	};
+
+	//----------------------------------------------------------------------
+
+	// compile-time topology, as reported by _R::locate<T>() and friends
+
+	enum : unsigned { INVALID_STATE = (unsigned) -1 };
+
+	// one step down the hierarchy: the region's fork, and the prong taken in it,
+	// forks being numbered in pre-order, same as at run time
+	struct PathStep {
+		unsigned fork;
+		unsigned prong;
+	};
+
+	// from the apex down to the state
+	template <unsigned TCapacity>
+	struct PathT {
+		PathStep steps[TCapacity];
+		unsigned count;
+
+		constexpr const PathStep& operator[] (const unsigned i) const	{ return steps[i];	}
+	};
+
+	// [begin, end) of state ids, the state itself and all of its sub-states
+	struct StateRange {
+		unsigned begin;
+		unsigned end;
+
+		constexpr bool contains(const unsigned state) const	{ return begin <= state && state < end;	}
+	};
+
+	template <unsigned TCapacity>
+	struct LocationT {
+		unsigned state;
+		unsigned parent;	// head of the enclosing region, INVALID_STATE for the apex
+		unsigned end;		// one past the last of the sub-states
+		bool orthogonal;	// any of the enclosing regions is orthogonal
+		PathT<TCapacity> path;
+	};
+
+	template <unsigned>
+	class LoweredT;
+
 private:
 	using Index = unsigned char;
 	enum : Index { INVALID_INDEX = std::numeric_limits<Index>::max() };
@@ -1001,19 +1407,19 @@ private:
 			Index prong = INVALID_INDEX;
 		#pragma pack(pop)
 
-		HSFM_IF_DEBUG(TypeInfo forkType);
-		HSFM_IF_DEBUG(TypeInfo prongType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo forkType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo prongType);
 
 		inline Parent() = default;
 
 		inline Parent(const Index fork_,
 					  const Index prong_
-					  HSFM_IF_DEBUG(, const TypeInfo forkType_)
-					  HSFM_IF_DEBUG(, const TypeInfo prongType_))
+					  HSFM_IF_DEBUG_TYPES(, const TypeInfo forkType_)
+					  HSFM_IF_DEBUG_TYPES(, const TypeInfo prongType_))
 			: fork(fork_)
 			, prong(prong_)
-			HSFM_IF_DEBUG(, forkType(forkType_))
-			HSFM_IF_DEBUG(, prongType(prongType_))
+			HSFM_IF_DEBUG_TYPES(, forkType(forkType_))
+			HSFM_IF_DEBUG_TYPES(, prongType(prongType_))
 		{}
 
 		inline explicit operator bool() const { return fork != INVALID_INDEX && prong != INVALID_INDEX; }
@@ -1026,6 +1432,7 @@ private:
 	struct StateRegistry {
 	public:
 		virtual unsigned add(const TypeInfo stateType) = 0;
+		virtual unsigned find(const TypeInfo stateType) const = 0;
 	};
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1041,7 +1448,10 @@ private:
 	public:
 		inline unsigned operator[] (const TypeInfo stateType) const { return *_typeToIndex.find(*stateType); }
 
+		inline TypeInfo type(const unsigned index) const;
+
 		virtual unsigned add(const TypeInfo stateType) override;
+		virtual unsigned find(const TypeInfo stateType) const override	{ return (*this)[stateType];	}
 
 	private:
 		TypeToIndex _typeToIndex;
@@ -1057,32 +1467,108 @@ private:
 			Index requested = INVALID_INDEX;
 		#pragma pack(pop)
 
-		HSFM_IF_DEBUG(const TypeInfo type);
-		HSFM_IF_ASSERT(TypeInfo activeType);
-		HSFM_IF_ASSERT(TypeInfo resumableType);
-		HSFM_IF_ASSERT(TypeInfo requestedType);
+		HSFM_IF_DEBUG_TYPES(const TypeInfo type);
+		HSFM_IF_DEBUG_TYPES(TypeInfo activeType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo resumableType);
+		HSFM_IF_DEBUG_TYPES(TypeInfo requestedType);
 
 		Fork(const Index index, const TypeInfo type_);
 	};
 	using ForkPointers = ArrayView<Fork*>;
 
+	//----------------------------------------------------------------------
+
+	// configurations requested by the rounds of a single processTransitions() call,
+	// a repeat means the substitutions are going round in circles;
+	// hashes only pre-filter the full comparisons
+	template <unsigned TForkCount>
+	class SubstitutionHistoryT {
+	public:
+		// to be filled with the 'requested' prong of every fork, then record()-ed
+		inline Index* pending() HFSM_NOEXCEPT(true)						{ return _configurations[_count];	}
+
+		// false if the pending configuration was recorded already
+		inline bool record() HFSM_NOEXCEPT(true);
+
+	private:
+		unsigned _hashes[MaxSubstitutions];
+		Index _configurations[MaxSubstitutions][TForkCount];
+		unsigned _count = 0;
+	};
+
+	//----------------------------------------------------------------------
+
+	// heads declaring 'enum : bool { SkipObsoleteUpdates = true };' don't have their sub-states updated
+	// on the ticks their own transition() restarts or resumes a state outside of their sub-tree,
+	// as the sub-states are about to be left then; schedule()-s and transitions within the sub-tree update them as usual
+	template <typename THead>
+	static constexpr bool skipsObsoleteUpdates(decltype(THead::SkipObsoleteUpdates)*)	{ return THead::SkipObsoleteUpdates;	}
+
+	template <typename>
+	static constexpr bool skipsObsoleteUpdates(...)										{ return false;							}
+
+	template <typename THead>
+	static constexpr History historyOf(decltype(THead::HistoryPolicy)*)					{ return THead::HistoryPolicy;			}
+
+	template <typename>
+	static constexpr History historyOf(...)												{ return History::Deep;					}
+
+	// heads declaring 'void react(TEvent&&, Control&, Context&)' get the rvalue events as such,
+	// take them over, and consume them, so no other state sees what's left;
+	// every other react() is passed an lvalue
+	template <typename THead, typename TEvent>
+	static constexpr bool takesOver(decltype(static_cast<void (THead::*)(TEvent&&, Control&, Context&)>(&THead::react))*)
+																						{ return !std::is_const<TEvent>::value;	}
+
+	template <typename, typename>
+	static constexpr bool takesOver(...)												{ return false;							}
+
+	template <typename THead, typename TEvent>
+	using PassedEvent = typename std::conditional<takesOver<THead, TEvent>(nullptr), TEvent&&, TEvent&>::type;
+
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 	template <typename T>
 	struct ForkT
 		: Fork
 	{
-		ForkT(const Index index,
-			  const Parent parent,
-			  Parents& forkParents)
-			: Fork(index, TypeInfo::get<T>())
+		ForkT(const Parent parent,
+			  Parents& forkParents,
+			  ForkPointers& forkPointers)
+			: Fork(static_cast<Index>(forkPointers << this), TypeInfo::get<T>())
 		{
-			forkParents[index] = parent;
+			forkParents[Fork::self] = parent;
 		}
 	};
 
 	//----------------------------------------------------------------------
 
+	// the state object of a node: heads with no data, trivial to create, copy and destroy, aren't stored,
+	// a fresh one is made up for every call, so such states take no room;
+	// keyed by the state id too, as empty bases of the same type (the peers' Base) can't share an address
+	template <unsigned TStateID, typename THead, bool = std::is_empty<THead>::value && std::is_trivial<THead>::value>
+	class HeadT {
+	public:
+		using Reference = THead&;
+
+		inline Reference head() HFSM_NOEXCEPT(true)				{ return _head;		}
+
+	private:
+		THead _head;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	template <unsigned TStateID, typename THead>
+	class HeadT<TStateID, THead, true> {
+	public:
+		using Reference = THead;
+
+		inline Reference head() HFSM_NOEXCEPT(true)				{ return THead{};	}
+	};
+
+	//----------------------------------------------------------------------
+
 	struct Transition {
 		enum Type {
 			Remain,
@@ -1109,41 +1595,44 @@ private:
 
 	//----------------------------------------------------------------------
 
-	template <typename>
+	template <unsigned, bool, typename>
 	struct _S;
 
-	template <typename, typename...>
+	template <unsigned, bool, typename, typename...>
 	struct _C;
 
-	template <typename, typename...>
+	template <unsigned, bool, typename, typename...>
 	struct _O;
 
 	template <typename>
 	class _R;
 
-	//----------------------------------------------------------------------
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-	template <typename... TS>
-	struct WrapState;
+	// user-facing region descriptors, turned into _C / _O by WrapState
+	template <typename, typename...>
+	struct _CI;
 
-	template <typename T>
-	struct WrapState<T> {
-		using Type = _S<T>;
-	};
+	template <typename, typename...>
+	struct _OI;
 
-	template <typename T>
-	struct WrapState<_S<T>> {
-		using Type = _S<T>;
+	//----------------------------------------------------------------------
+
+	// pre-order ids, matching both the registry and the structure report;
+	// log scope is set inside the subtrees selected by the log filter
+	template <unsigned TID, bool TLS, typename T>
+	struct WrapState {
+		using Type = _S<TID, TLS || TLogFilter::template isSubtree<T>(), T>;
 	};
 
-	template <typename T, typename... TS>
-	struct WrapState<_C<T, TS...>> {
-		using Type = _C<T, TS...>;
+	template <unsigned TID, bool TLS, typename T, typename... TS>
+	struct WrapState<TID, TLS, _CI<T, TS...>> {
+		using Type = _C<TID, TLS || TLogFilter::template isSubtree<T>(), T, TS...>;
 	};
 
-	template <typename T, typename... TS>
-	struct WrapState<_O<T, TS...>> {
-		using Type = _O<T, TS...>;
+	template <unsigned TID, bool TLS, typename T, typename... TS>
+	struct WrapState<TID, TLS, _OI<T, TS...>> {
+		using Type = _O<TID, TLS || TLogFilter::template isSubtree<T>(), T, TS...>;
 	};
 
 	//----------------------------------------------------------------------
@@ -1160,21 +1649,32 @@ private:
 		StateInfo(const unsigned parent_,
 				  const RegionType region_,
 				  const unsigned depth_,
-				  const char* const name_)
+				  const char* const name_,
+				  const unsigned footprint_)
 			: parent(parent_)
 			, region(region_)
 			, depth(depth_)
 			, name(name_)
+			, footprint(footprint_)
 		{}
 
 		unsigned parent;
 		RegionType region;
 		unsigned depth;
 		const char* name;
+		unsigned footprint;
 	};
 	using StateInfos = detail::ArrayView<StateInfo>;
 
 	using StateStructure = detail::ArrayView<StructureEntry>;
+
+	//----------------------------------------------------------------------
+
+	struct StateActivity {
+		unsigned since = 0;
+		bool isActive = false;
+	};
+	using StateActivities = ArrayView<StateActivity>;
 #endif
 
 
@@ -1191,20 +1691,24 @@ public:
 		using Control	 = typename M::Control;
 		using Context	 = typename M::Context;
 		using Transition = typename M::Transition;
+		using History	 = typename M::History;
 
 	public:
-		inline void preSubstitute(Context&)				{}
-		inline void preEnter(Context&)					{}
-		inline void preUpdate(Context&)					{}
-		inline void preTransition(Context&)				{}
+		inline void preSubstitute(Context&)				HFSM_NOEXCEPT(true)	{}
+		inline void preEnter(Context&)					HFSM_NOEXCEPT(true)	{}
+		inline void preUpdate(Context&)					HFSM_NOEXCEPT(true)	{}
+		inline void preTransition(Context&)				HFSM_NOEXCEPT(true)	{}
 		template <typename TEvent>
-		inline void preReact(const TEvent&, Context&)	{}
-		inline void postLeave(Context&)					{}
+		inline void preReact(const TEvent&, Context&)	HFSM_NOEXCEPT(true)	{}
+		inline void postLeave(Context&)					HFSM_NOEXCEPT(true)	{}
 	};
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 private:
 
+	// returned by the default Base::react(), tells the states handling an event apart at compile time
+	struct Unhandled {};
+
 	template <typename...>
 	struct _B;
 
@@ -1215,13 +1719,31 @@ private:
 		: public TInjection
 		, public _B<TRest...>
 	{
-		inline void widePreSubstitute(Context& context);
-		inline void widePreEnter(Context& context);
-		inline void widePreUpdate(Context& context);
-		inline void widePreTransition(Context& context);
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptPreSubstitute = noexcept(std::declval<TInjection&>().preSubstitute(std::declval<Context&>())) && _B<TRest...>::NoexceptPreSubstitute,
+			NoexceptPreEnter	  = noexcept(std::declval<TInjection&>().preEnter	  (std::declval<Context&>())) && _B<TRest...>::NoexceptPreEnter,
+			NoexceptPreUpdate	  = noexcept(std::declval<TInjection&>().preUpdate	  (std::declval<Context&>())) && _B<TRest...>::NoexceptPreUpdate,
+			NoexceptPreTransition = noexcept(std::declval<TInjection&>().preTransition(std::declval<Context&>())) && _B<TRest...>::NoexceptPreTransition,
+			NoexceptPostLeave	  = noexcept(std::declval<TInjection&>().postLeave	  (std::declval<Context&>())) && _B<TRest...>::NoexceptPostLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptPreReact {
+			enum : bool {
+				Value = noexcept(std::declval<TInjection&>().preReact(std::declval<const TEvent&>(), std::declval<Context&>())) &&
+						_B<TRest...>::template NoexceptPreReact<TEvent>::Value
+			};
+		};
+	#endif
+
+		inline void widePreSubstitute(Context& context)	HFSM_NOEXCEPT(NoexceptPreSubstitute);
+		inline void widePreEnter(Context& context)		HFSM_NOEXCEPT(NoexceptPreEnter);
+		inline void widePreUpdate(Context& context)		HFSM_NOEXCEPT(NoexceptPreUpdate);
+		inline void widePreTransition(Context& context)	HFSM_NOEXCEPT(NoexceptPreTransition);
 		template <typename TEvent>
-		inline void widePreReact(const TEvent& event, Context& context);
-		inline void widePostLeave(Context& context);
+		inline void widePreReact(const TEvent& event, Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value);
+		inline void widePostLeave(Context& context)		HFSM_NOEXCEPT(NoexceptPostLeave);
 	};
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1230,452 +1752,2196 @@ private:
 	struct _B<TInjection>
 		: public TInjection
 	{
-		inline void substitute(Control&, Context&)				{}
-		inline void enter(Context&)								{}
-		inline void update(Context&)							{}
-		inline void transition(Control&, Context&)				{}
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptPreSubstitute = noexcept(std::declval<TInjection&>().preSubstitute(std::declval<Context&>())),
+			NoexceptPreEnter	  = noexcept(std::declval<TInjection&>().preEnter	  (std::declval<Context&>())),
+			NoexceptPreUpdate	  = noexcept(std::declval<TInjection&>().preUpdate	  (std::declval<Context&>())),
+			NoexceptPreTransition = noexcept(std::declval<TInjection&>().preTransition(std::declval<Context&>())),
+			NoexceptPostLeave	  = noexcept(std::declval<TInjection&>().postLeave	  (std::declval<Context&>())),
+		};
+
 		template <typename TEvent>
-		inline void react(const TEvent&, Control&, Context&)	{}
-		inline void leave(Context&)								{}
+		struct NoexceptPreReact {
+			enum : bool {
+				Value = noexcept(std::declval<TInjection&>().preReact(std::declval<const TEvent&>(), std::declval<Context&>()))
+			};
+		};
+	#endif
+
+		inline void substitute(Control&, Context&)				HFSM_NOEXCEPT(true)	{}
+		inline void enter(Context&)								HFSM_NOEXCEPT(true)	{}
+		inline void update(Context&)							HFSM_NOEXCEPT(true)	{}
+		inline void transition(Control&, Context&)				HFSM_NOEXCEPT(true)	{}
+		template <typename TEvent>
+		inline Unhandled react(const TEvent&, Control&, Context&) HFSM_NOEXCEPT(true)	{ return Unhandled{};	}
+		inline void leave(Context&)								HFSM_NOEXCEPT(true)	{}
 
-		inline void widePreSubstitute(Context& context);
-		inline void widePreEnter(Context& context);
-		inline void widePreUpdate(Context& context);
-		inline void widePreTransition(Context& context);
+		inline void widePreSubstitute(Context& context)	HFSM_NOEXCEPT(NoexceptPreSubstitute);
+		inline void widePreEnter(Context& context)		HFSM_NOEXCEPT(NoexceptPreEnter);
+		inline void widePreUpdate(Context& context)		HFSM_NOEXCEPT(NoexceptPreUpdate);
+		inline void widePreTransition(Context& context)	HFSM_NOEXCEPT(NoexceptPreTransition);
 		template <typename TEvent>
-		inline void widePreReact(const TEvent& event, Context& context);
-		inline void widePostLeave(Context& context);
+		inline void widePreReact(const TEvent& event, Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value);
+		inline void widePostLeave(Context& context)		HFSM_NOEXCEPT(NoexceptPostLeave);
 	};
 
 
 	//----------------------------------------------------------------------
 
 
-	template <typename TApex>
-	class _R final {
-		using Apex = typename WrapState<TApex>::Type;
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+public:
 
+	// decides once per update() / react() whether the attached logger gets called,
+	// share one instance between machines to sample the whole fleet
+	class LogSampling {
 	public:
-		enum : unsigned {
-			ReverseDepth  = Apex::ReverseDepth,
-			DeepWidth	  = Apex::DeepWidth,
-			StateCount	  = Apex::StateCount,
-			ForkCount	  = Apex::ForkCount,
-			ProngCount	  = Apex::ProngCount,
-			Width		  = Apex::Width,
+		enum class Policy {
+			All,		// every call
+			Ticks,		// every 'rate'-th call of each machine
+			Machines,	// all calls of every 'rate'-th machine
+			Never,		// no calls, only feed the transition reservoir
 		};
-		static_assert(StateCount < std::numeric_limits<Index>::max(), "Too many states in the hierarchy. Change 'Index' type.");
 
-	private:
-		enum : unsigned {
-			StateCapacity = (unsigned) 1.3 * Apex::StateCount,
-		};
+		LogSampling(const Policy policy = Policy::All,
+					const unsigned rate = 1);
 
-		using StateRegistryImpl		 = StateRegistryT<StateCapacity>;
-		using StateParentStorage	 = Array<Parent, StateCount>;
-		using ForkParentStorage		 = Array<Parent, ForkCount>;
-		using ForkPointerStorage	 = Array<Fork*, ForkCount>;
-		using TransitionQueueStorage = Array<Transition, ForkCount>;
+		virtual ~LogSampling() = default;
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		enum : unsigned {
-			NameCount	  = Apex::NameCount,
-		};
+		inline unsigned enroll()												{ return _enrolled++;		}
 
-		using Prefix				 = detail::StaticArray<wchar_t, ReverseDepth * 2 + 2>;
-		using Prefixes				 = detail::StaticArray<Prefix, StateCount>;
+		inline bool sample(const unsigned machine, const unsigned tick) const HFSM_NOEXCEPT(true);
 
-		using StateInfoStorage		 = detail::Array<StateInfo, StateCount>;
+		virtual void offer(const Transition& /*transition*/) HFSM_NOEXCEPT(true)	{}
 
-		using StructureStorage		 = detail::Array<StructureEntry, NameCount>;
-		using ActivityHistoryStorage = detail::Array<char, NameCount>;
-	#endif
+	private:
+		const Policy _policy;
+		const unsigned _rate;
+		unsigned _enrolled = 0;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// additionally keeps a uniform sample of all offered transitions
+	template <unsigned TReservoirCapacity>
+	class LogSamplingT
+		: public LogSampling
+	{
+		enum : unsigned { Capacity = TReservoirCapacity };
+
+		using Policy	= typename LogSampling::Policy;
+		using Reservoir = Array<Transition, Capacity>;
 
 	public:
-		_R(Context& context
-		   HFSM_IF_LOGGER(, LoggerInterface* const logger = nullptr));
+		LogSamplingT(const Policy policy = Policy::All,
+					 const unsigned rate = 1,
+					 const unsigned seed = 1);
 
-		~_R();
+		virtual void offer(const Transition& transition) HFSM_NOEXCEPT(true) override;
 
-		void update();
+		inline const Reservoir& reservoir() const								{ return _reservoir;		}
+		inline unsigned offered() const											{ return _offered;			}
 
-		template <typename TEvent>
-		inline void react(const TEvent& event);
+	private:
+		inline unsigned random() HFSM_NOEXCEPT(true);
 
-		template <typename T>
-		inline void changeTo()	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+	private:
+		Reservoir _reservoir;
+		unsigned _offered = 0;
+		unsigned _random;
+	};
 
-		template <typename T>
-		inline void resume()	{ _requests << Transition(Transition::Type::Resume,   TypeInfo::get<T>());	}
+private:
+#endif
 
-		template <typename T>
-		inline void schedule()	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
 
-		template <typename T>
-		inline bool isActive();
+	//----------------------------------------------------------------------
 
-		template <typename T>
-		inline bool isResumable();
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		const MachineStructure& structure() const								{ return _structure;		};
-		const MachineActivity&  activity()  const								{ return _activityHistory;	};
-	#endif
+#ifdef HFSM_ENABLE_WATCHDOG
+public:
 
-	#ifdef HFSM_ENABLE_LOG_INTERFACE
-		void attachLogger(LoggerInterface* const logger)						{ _logger = logger;			}
-	#endif
+	// times state callbacks against per-state / global thresholds,
+	// watches for substitution limit exhaustion, cycles and budget overruns, and enter / leave oscillation,
+	// keeps the latest incidents in a fixed-size ring
+	class Watchdog {
+		template <typename>
+		friend class _R;
+
+		friend class Control;
+
+	public:
+		using Clock		= std::chrono::steady_clock;
+		using Duration	= Clock::duration;
+		using TimePoint = Clock::time_point;
+
+		enum class Callback {
+			Substitute,
+			Enter,
+			Update,
+			Transition,
+			React,
+			Leave,
+		};
+
+		struct Incident {
+			enum class Type {
+				SlowCallback,		// 'callback' of 'state' took 'duration'
+				SubstitutionLimit,	// 'state' was still requested after TMaxSubstitutions rounds
+				SubstitutionCycle,	// 'state' was requested again for an already requested configuration, and dropped
+				SubstitutionBudget,	// 'state' was still requested after substituting for 'duration', past the budget
+				Oscillation,		// 'state' was entered more than the limit times within the window
+			};
+
+			Type type;
+			unsigned state;
+			Callback callback;
+			Duration duration;
+			unsigned tick;
+			TimePoint time;
+		};
+		using Incidents = ArrayView<Incident>;
+
+		struct StateWatch {
+			Duration threshold = Duration::zero();	// zero for the global threshold
+			unsigned windowStart = 0;
+			unsigned enters = 0;
+		};
+		using StateWatches = ArrayView<StateWatch>;
 
 	protected:
-		void processTransitions();
-		void requestImmediate(const Transition request);
-		void requestScheduled(const Transition request);
+		Watchdog(StateWatches& states,
+				 Incidents& incidents);
 
-		inline unsigned id(const Transition request) const	{ return _stateRegistry[*request.stateType];	}
+	public:
+		inline void threshold(const Duration threshold)							{ _threshold = threshold;				}
+		inline void threshold(const unsigned state, const Duration threshold)	{ _states[state].threshold = threshold;	}
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		void getStateNames();
-		void udpateActivity();
-	#endif
+		inline void oscillation(const unsigned limit, const unsigned window)	{ _oscillationLimit = limit; _oscillationWindow = window;	}
 
-	private:
-		Context& _context;
+		inline const Incidents& incidents() const								{ return _incidents;					}
+		inline unsigned reported() const										{ return _reported;						}
 
-		StateRegistryImpl _stateRegistry;
+		inline void clear()														{ _incidents.clear(); _reported = 0;	}
 
-		StateParentStorage _stateParents;
-		ForkParentStorage  _forkParents;
-		ForkPointerStorage _forkPointers;
+	private:
+		inline void tick()									HFSM_NOEXCEPT(true)	{ ++_tick;								}
 
-		TransitionQueueStorage _requests;
+		inline void check(const unsigned state,
+						  const Callback callback,
+						  const TimePoint begin) HFSM_NOEXCEPT(true);
 
-		Apex _apex;
+		inline void entered(const unsigned state) HFSM_NOEXCEPT(true);
+		inline void exhausted(const unsigned state) HFSM_NOEXCEPT(true);
+		inline void cycled(const unsigned state) HFSM_NOEXCEPT(true);
+		inline void overBudget(const unsigned state, const Duration duration) HFSM_NOEXCEPT(true);
 
-	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-		Prefixes _prefixes;
-		StateInfoStorage _stateInfos;
+		void report(const Incident& incident) HFSM_NOEXCEPT(true);
 
-		StructureStorage _structure;
-		ActivityHistoryStorage _activityHistory;
+	private:
+		StateWatches& _states;
+		Incidents& _incidents;
 
-		struct DebugTransitionInfo {
-			typename Transition::Type type;
-			TypeInfo state;
+		Duration _threshold = std::chrono::milliseconds(1);
+		unsigned _oscillationLimit = 8;
+		unsigned _oscillationWindow = 60;
 
-			enum Source {
-				Update,
-				Substitute,
-				Linger,
+		unsigned _tick = 0;
+		unsigned _reported = 0;
+	};
 
-				COUNT
-			};
-			Source source;
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-			inline DebugTransitionInfo() = default;
+	// attach to a machine of up to TStateCapacity states
+	template <unsigned TStateCapacity, unsigned TIncidentCapacity = 16>
+	class WatchdogT
+		: public Watchdog
+	{
+		using StateWatchStorage = Array<typename Watchdog::StateWatch, TStateCapacity>;
+		using IncidentStorage	= Array<typename Watchdog::Incident, TIncidentCapacity>;
 
-			inline DebugTransitionInfo(const Transition transition,
-									   const Source source_)
-				: type(transition.type)
-				, state(transition.stateType)
-				, source(source_)
-			{
-				assert(source_ < Source::COUNT);
-			}
-		};
-		using DebugTransitionInfos = Array<DebugTransitionInfo, 2 * ForkCount>;
-		DebugTransitionInfos _lastTransitions;
-	#endif
+	public:
+		WatchdogT()
+			: Watchdog(_stateStorage, _incidentStorage)
+		{
+			_stateStorage.resize(TStateCapacity);
+		}
 
-		HFSM_IF_LOGGER(LoggerInterface* _logger);
+	private:
+		StateWatchStorage _stateStorage;
+		IncidentStorage _incidentStorage;
 	};
 
+private:
+#endif
+
+
 	//----------------------------------------------------------------------
 
+
+#ifdef HFSM_ENABLE_EVENT_STATS
 public:
 
-	class Control final {
+	// per event type dispatch counters, attach to a single machine,
+	// or share one instance between machines to aggregate the whole fleet
+	class EventStats {
 		template <typename>
 		friend class _R;
 
-	private:
-		Control(TransitionQueue& requests)
-			: _requests(requests)
-		{}
-
 	public:
-		template <typename T>
-		inline void changeTo()	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+		struct Entry {
+			TypeInfo event;
+			unsigned dispatched;	// react() calls
+			unsigned visited;		// states the event was offered to
+			unsigned handled;		// ..of them overriding react() for it
+			unsigned transitions;	// transitions requested in response
+		};
+		using Entries = ArrayView<Entry>;
 
-		template <typename T>
-		inline void resume()	{ _requests << Transition(Transition::Type::Resume,	  TypeInfo::get<T>());	}
+	protected:
+		EventStats(Entries& entries);
 
-		template <typename T>
-		inline void schedule()	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
+	public:
+		template <typename TEvent>
+		inline const Entry* get() const						{ return find(TypeInfo::get<TEvent>());	}
 
-		inline unsigned requestCount() const									{ return _requests.count();	}
+		inline const Entries& entries() const				{ return _entries;						}
 
-	private:
-		TransitionQueue& _requests;
-	};
+		// react() calls with event types past the capacity
+		inline unsigned dropped() const						{ return _dropped;						}
 
+		void merge(const EventStats& other);
 
-	//----------------------------------------------------------------------
+		inline void clear()									{ _entries.clear(); _dropped = 0;		}
 
+	private:
+		const Entry* find(const TypeInfo event) const HFSM_NOEXCEPT(true);
+		Entry* insert(const TypeInfo event) HFSM_NOEXCEPT(true);
 
-	using Base = _B<Bare>;
+		inline Entry* dispatched(const TypeInfo event) HFSM_NOEXCEPT(true);
 
-	template <typename... TInjections>
-	using BaseT = _B<TInjections...>;
+	private:
+		Entries& _entries;
+		unsigned _dropped = 0;
+	};
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-	template <typename TState, typename... TSubStates>
-	using Composite	= _C<TState, TSubStates...>;
+	// keeps up to TCapacity event types
+	template <unsigned TCapacity = 16>
+	class EventStatsT
+		: public EventStats
+	{
+		using EntryStorage = Array<typename EventStats::Entry, TCapacity>;
 
-	template <typename... TSubStates>
-	using CompositePeers = _C<Base, TSubStates...>;
+	public:
+		EventStatsT()
+			: EventStats(_entryStorage)
+		{}
 
-	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	private:
+		EntryStorage _entryStorage;
+	};
 
-	template <typename TState, typename... TSubStates>
-	using Orthogonal = _O<TState, TSubStates...>;
+private:
+#endif
 
-	template <typename... TSubStates>
-	using OrthogonalPeers = _O<Base, TSubStates...>;
+
+	//----------------------------------------------------------------------
+
+
+#ifdef HFSM_ENABLE_COVERAGE
+public:
+
+	// one bit per state ever entered, and one per composite prong ever switched to by a transition
+	// (kept at the index of the state heading the prong);
+	// share one instance between machines of the same structure, or merge() them for a fleet-wide OR
+	class Coverage {
+		template <typename>
+		friend class _R;
+
+		friend class Control;
+
+	public:
+		using Words = ArrayView<unsigned>;
+
+		struct Prong {
+			unsigned fork;
+			unsigned prong;
+		};
+
+		enum : unsigned {
+			WordBits = sizeof(unsigned) * 8,
+		};
+
+	protected:
+		Coverage(const unsigned capacity,
+				 Words& states,
+				 Words& transitions);
+
+	public:
+		// states covered, ids past it are never recorded
+		inline unsigned capacity() const						{ return _capacity;					}
+
+		inline bool entered(const unsigned state) const			{ return state < _capacity && test(_states, state);		}
+		inline bool switchedTo(const unsigned state) const		{ return state < _capacity && test(_transitions, state);	}
+
+		// raw bits, to be dumped and OR-ed across processes
+		inline const Words& stateBits() const					{ return _states;					}
+		inline const Words& transitionBits() const				{ return _transitions;				}
+
+		// false, with nothing merged, for a coverage of a different capacity
+		bool merge(const Coverage& other);
+
+		// ids of the entered states, returns their count
+		unsigned exportStates(unsigned* const states, const unsigned capacity) const;
+
+		void clear();
+
+	private:
+		// ids are checked against the capacity once, on attaching
+		inline void enter(const unsigned state)		HFSM_NOEXCEPT(true)	{ set(_states, state);				}
+		inline void switchTo(const unsigned state)	HFSM_NOEXCEPT(true)	{ set(_transitions, state);			}
+
+		static inline void set (		Words& words, const unsigned bit)	HFSM_NOEXCEPT(true)	{ words[bit / WordBits] |= 1u << bit % WordBits;				}
+		static inline bool test(const Words& words, const unsigned bit)	HFSM_NOEXCEPT(true)	{ return (words[bit / WordBits] & 1u << bit % WordBits) != 0;	}
+
+	private:
+		const unsigned _capacity;
+		Words& _states;
+		Words& _transitions;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// attach to a machine of up to TStateCapacity states
+	template <unsigned TStateCapacity>
+	class CoverageT
+		: public Coverage
+	{
+		enum : unsigned {
+			WordCount = (TStateCapacity + Coverage::WordBits - 1) / Coverage::WordBits,
+		};
+
+		using WordStorage = Array<unsigned, WordCount>;
+
+	public:
+		CoverageT()
+			: Coverage(TStateCapacity, _stateStorage, _transitionStorage)
+		{
+			_stateStorage.resize(WordCount);
+			_transitionStorage.resize(WordCount);
+		}
+
+	private:
+		WordStorage _stateStorage;
+		WordStorage _transitionStorage;
+	};
+
+private:
+#endif
+
+
+	//----------------------------------------------------------------------
+
+
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+public:
+
+	// rounds taken by processTransitions() calls, to size TMaxSubstitutions from data,
+	// with an optional time budget per call
+	class SubstitutionStats {
+		template <typename>
+		friend class _R;
+
+	public:
+		using Clock		= std::chrono::steady_clock;
+		using Duration	= Clock::duration;
+
+		// past the budget, the remaining requests are left for the next update() / react(); zero for none
+		inline void budget(const Duration budget)			{ _budget = budget;							}
+
+		inline unsigned calls() const						{ return _calls;							}
+
+		// calls that took 'count' rounds, 1 .. TMaxSubstitutions
+		inline unsigned rounds(const unsigned count) const	{ assert(count <= MaxSubstitutions); return _rounds[count];	}
+		inline unsigned peak() const						{ return _peak;								}
+
+		inline unsigned cycles() const						{ return _cycles;							}
+		inline unsigned exhausted() const					{ return _exhausted;						}
+		inline unsigned overBudget() const					{ return _overBudget;						}
+
+		// keeps the budget
+		void clear();
+
+	private:
+		inline void record(const unsigned rounds) HFSM_NOEXCEPT(true);
+
+	private:
+		Duration _budget = Duration::zero();
+
+		unsigned _calls = 0;
+		unsigned _rounds[MaxSubstitutions + 1] = {};
+		unsigned _peak = 0;
+
+		unsigned _cycles = 0;
+		unsigned _exhausted = 0;
+		unsigned _overBudget = 0;
+	};
+
+private:
+#endif
+
+
+	//----------------------------------------------------------------------
+
+
+#ifdef HFSM_ENABLE_SCRATCH
+public:
+
+	// memory the states' scratch arenas are carved from, each on the first entry of its state;
+	// an arena is held until its machine is destroyed, then kept on a per-state free list for the next machine;
+	// attach to a single machine, or share one block between machines of the same structure;
+	// also keeps the most each state has used of its arena, to size the arenas from data
+	class Scratch;
+
+	class ScratchBlock {
+		friend class Control;
+		friend class Scratch;
+
+	public:
+		using HighWaters = ArrayView<unsigned>;
+		using FreeLists	 = ArrayView<char*>;
+
+	protected:
+		ScratchBlock(char* const memory,
+					 const unsigned capacity,
+					 HighWaters& highWaters,
+					 FreeLists& freeLists);
+
+	public:
+		inline unsigned capacity() const					{ return _capacity;					}
+
+		// handed out to the arenas so far
+		inline unsigned carved() const						{ return _carved;					}
+
+		// arenas that didn't fit, and were left empty; once per state and machine
+		inline unsigned missed() const						{ return _missed;					}
+
+		// bytes used by the state so far, the most seen
+		inline unsigned highWater(const unsigned state) const	{ return _highWaters[state];	}
+		inline const HighWaters& highWaters() const			{ return _highWaters;				}
+
+		// keeps the carved arenas
+		void clearHighWaters();
+
+	private:
+		char* carve(const unsigned state,
+					const unsigned size) HFSM_NOEXCEPT(true);
+
+		void release(const unsigned state,
+					 char* const arena) HFSM_NOEXCEPT(true);
+
+		inline void record(const unsigned state, const unsigned used) HFSM_NOEXCEPT(true)	{ if (_highWaters[state] < used) _highWaters[state] = used;	}
+
+	private:
+		char* const _memory;
+		const unsigned _capacity;
+		HighWaters& _highWaters;
+		FreeLists& _freeLists;
+
+		unsigned _carved = 0;
+		unsigned _missed = 0;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// TCapacity bytes, for a machine (or a fleet) of up to TStateCapacity states
+	template <unsigned TStateCapacity, unsigned TCapacity>
+	class ScratchBlockT
+		: public ScratchBlock
+	{
+		using HighWaterStorage = Array<unsigned, TStateCapacity>;
+		using FreeListStorage  = Array<char*, TStateCapacity>;
+
+	public:
+		ScratchBlockT()
+			: ScratchBlock(_memory, TCapacity, _highWaterStorage, _freeListStorage)
+		{
+			_highWaterStorage.resize(TStateCapacity);
+			_freeListStorage.resize(TStateCapacity);
+		}
+
+	private:
+		alignas(std::max_align_t) char _memory[TCapacity];
+		HighWaterStorage _highWaterStorage;
+		FreeListStorage _freeListStorage;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// injection giving the state a bump-pointer arena, released in bulk once the state is left,
+	// and returned to the block with the machine;
+	// nothing is destroyed on release, so only trivially destructible objects go in
+	class Scratch
+		: public Bare
+	{
+		friend class Control;
+
+	protected:
+		inline Scratch(const unsigned capacity)				: _capacity(capacity)				{}
+		inline ~Scratch()									{ if (_memory) _block->release(_state, _memory);	}
+
+		// nullptr without a block attached, or once the arena is full
+		inline void* allocate(const unsigned size,
+							  const unsigned alignment = alignof(std::max_align_t)) HFSM_NOEXCEPT(true);
+
+		template <typename T, typename... TArgs>
+		inline T* create(TArgs&&... args);
+
+		inline unsigned scratchCapacity() const				{ return _memory ? _capacity : 0;	}
+		inline unsigned scratchUsed() const					{ return _used;						}
+
+	private:
+		char* _memory = nullptr;
+		const unsigned _capacity;
+		unsigned _used = 0;
+
+		// where the arena came from
+		ScratchBlock* _block = nullptr;
+		unsigned _state = 0;
+		bool _missed = false;
+	};
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	// opt in with BaseT<ScratchT<bytes>, ..>
+	template <unsigned TCapacity>
+	class ScratchT
+		: public Scratch
+	{
+		static_assert(TCapacity > 0, "Empty scratch arenas can't be kept on the free list");
+
+	protected:
+		ScratchT()
+			: Scratch(TCapacity)
+		{}
+	};
+
+private:
+#endif
+
+
+	//----------------------------------------------------------------------
+
+
+	template <typename TApex>
+	class _R final {
+		using Apex = typename WrapState<0, TLogFilter::Everywhere, TApex>::Type;
+
+	public:
+		enum : unsigned {
+			ReverseDepth  = Apex::ReverseDepth,
+			DeepWidth	  = Apex::DeepWidth,
+			StateCount	  = Apex::StateCount,
+			ForkCount	  = Apex::ForkCount,
+			ProngCount	  = Apex::ProngCount,
+			Width		  = Apex::Width,
+		};
+		static_assert(StateCount < std::numeric_limits<Index>::max(), "Too many states in the hierarchy. Change 'Index' type.");
+
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptTransitions = Apex::NoexceptSubstitute && Apex::NoexceptEnter && Apex::NoexceptLeave,
+			NoexceptUpdate		= Apex::NoexceptUpdateAndTransition && NoexceptTransitions,
+		};
+
+		// TEvent is const for the events passed by reference
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Apex::template NoexceptReact<TEvent>::Value && NoexceptTransitions
+			};
+		};
+	#endif
+
+	private:
+		enum : unsigned {
+			StateCapacity = (unsigned) 1.3 * Apex::StateCount,
+		};
+
+		using StateRegistryImpl		 = StateRegistryT<StateCapacity>;
+		using StateParentStorage	 = Array<Parent, StateCount>;
+		using ForkParentStorage		 = Array<Parent, ForkCount>;
+		using ForkPointerStorage	 = Array<Fork*, ForkCount>;
+		using TransitionQueueStorage = Array<Transition, ForkCount>;
+		using SubstitutionHistory	 = SubstitutionHistoryT<ForkCount>;
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		enum : unsigned {
+			NameCount	  = Apex::NameCount,
+		};
+
+		using Prefix				 = detail::StaticArray<wchar_t, ReverseDepth * 2 + 2>;
+		using Prefixes				 = detail::StaticArray<Prefix, StateCount>;
+
+		using StateInfoStorage		 = detail::Array<StateInfo, StateCount>;
+
+		using StructureStorage		 = detail::Array<StructureEntry, NameCount>;
+		using StateActivityStorage	 = detail::Array<StateActivity, StateCount>;
+		using ActivityHistoryStorage = detail::Array<char, NameCount>;
+
+		// identical for all instances of the machine, built once on first use
+		struct StaticStructure {
+			StaticStructure();
+
+			Prefixes prefixes;
+			StateInfoStorage stateInfos;
+			StructureStorage structure;
+		};
+	#endif
+
+	public:
+		_R(Context& context
+		   HFSM_IF_LOGGER(, LoggerInterface* const logger = nullptr)
+		   HFSM_IF_COVERAGE(, Coverage* const coverage = nullptr)
+		   HFSM_IF_SCRATCH(, ScratchBlock* const scratch = nullptr));
+
+		~_R();
+
+		void update() HFSM_NOEXCEPT(NoexceptUpdate);
+
+		template <typename TEvent>
+		inline Reaction react(const TEvent& event) HFSM_NOEXCEPT(NoexceptReact<const TEvent>::Value)	{ return dispatch(event);	}
+
+		// rvalues can be taken over by a state's react(TEvent&&) overload,
+		// which consumes the event, the states before it see it as an lvalue
+		template <typename TEvent, typename = typename std::enable_if<!std::is_reference<TEvent>::value>::type>
+		inline Reaction react(TEvent&& event) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)			{ return dispatch(event);	}
+
+	#ifdef HFSM_VARIANT_EVENTS
+		// a single jump through a table of the per-alternative react() paths,
+		// std::monostate and valueless variants don't reach the states
+		template <typename... TEvents>
+		inline Reaction react(const std::variant<TEvents...>& events) HFSM_NOEXCEPT((NoexceptReact<const TEvents>::Value && ...))	{ return reactVariant(events, std::index_sequence_for<TEvents...>{});	}
+
+		// the alternative is passed on as an rvalue
+		template <typename... TEvents>
+		inline Reaction react(std::variant<TEvents...>&& events) HFSM_NOEXCEPT((NoexceptReact<TEvents>::Value && ...))			{ return reactVariant(events, std::index_sequence_for<TEvents...>{});	}
+	#endif
+
+		// constructs the event in place, and reacts to it as an rvalue
+		template <typename TEvent, typename... TArgs>
+		inline Reaction emplace(TArgs&&... args) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value &&
+															   std::is_nothrow_constructible<TEvent, TArgs&&...>::value);
+
+		inline void propagation(const Propagation order)	HFSM_NOEXCEPT(true)	{ _propagation = order;		}
+		inline Propagation propagation() const				HFSM_NOEXCEPT(true)	{ return _propagation;		}
+
+		template <typename T>
+		inline void changeTo()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void resume()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Resume,   TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void schedule()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline bool isActive();
+
+		template <typename T>
+		inline bool isResumable();
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		const MachineStructure& structure() const								{ return staticStructure().structure; };
+
+		// rebuilt on every call, over the view the previous call returned
+		const MachineActivity&  activity();
+	#endif
+
+	#ifdef _DEBUG
+		// type info derived from indices on demand, for the debugger
+		TypeInfo stateType(const unsigned state) const							{ return _stateRegistry.type(state);	}
+		TypeInfo prongType(const unsigned fork, const unsigned prong) const;
+
+		TypeInfo activeType	  (const unsigned fork) const	{ return prongType(fork, _forkPointers[fork]->active);		}
+		TypeInfo resumableType(const unsigned fork) const	{ return prongType(fork, _forkPointers[fork]->resumable);	}
+		TypeInfo requestedType(const unsigned fork) const	{ return prongType(fork, _forkPointers[fork]->requested);	}
+	#endif
+
+	#ifdef HFSM_ENABLE_LOG_INTERFACE
+		void attachLogger(LoggerInterface* const logger)						{ _logger = logger;			}
+
+		inline void attachSampling(LogSampling* const sampling);
+	#endif
+
+	#ifdef HFSM_ENABLE_WATCHDOG
+		template <unsigned TStateCapacity, unsigned TIncidentCapacity>
+		void attachWatchdog(WatchdogT<TStateCapacity, TIncidentCapacity>* const watchdog) {
+			static_assert(StateCount <= TStateCapacity, "Watchdog too small for the machine, see WatchdogT<>'s TStateCapacity.");
+
+			_watchdog = watchdog;
+		}
+
+		void detachWatchdog()													{ _watchdog = nullptr;		}
+	#endif
+
+		// as reported by Reaction, the watchdog, ..
+		template <typename T>
+		inline unsigned stateId() const							{ return _stateRegistry[TypeInfo::get<T>()];	}
+
+		// compile-time counterparts, for static tables, masks and side arrays keyed by state;
+		// ids are pre-order, so a state's sub-states follow it contiguously
+		using Path		= PathT<ReverseDepth>;
+		using Location	= LocationT<ReverseDepth>;
+
+		template <typename T>
+		static constexpr unsigned stateIndex();
+
+		template <typename T>
+		static constexpr Location locate();
+
+		template <typename T>
+		static constexpr unsigned parentOf()					{ return locate<T>().parent;						}
+
+		// the apex is at depth 0
+		template <typename T>
+		static constexpr unsigned depthOf()						{ return locate<T>().path.count;					}
+
+		template <typename T>
+		static constexpr Path pathOf()							{ return locate<T>().path;							}
+
+		template <typename T>
+		static constexpr StateRange subtreeRange()				{ return StateRange{stateIndex<T>(), locate<T>().end};	}
+
+		template <typename T>
+		static constexpr bool insideOrthogonal()				{ return locate<T>().orthogonal;					}
+
+		// bytes the state and its sub-states take in each machine instance (forks included),
+		// 0 for the states with no data, which aren't stored
+		template <typename T>
+		static constexpr unsigned footprintOf()					{ return stateIndex<T>(), Apex::template deepFootprint<T>();	}
+
+		// of the bookkeeping each composite and orthogonal region adds
+		static constexpr unsigned forkFootprint()				{ return sizeof(Fork);										}
+
+	#ifdef HFSM_ENABLE_EVENT_STATS
+		void attachEventStats(EventStats* const eventStats)					{ _eventStats = eventStats;	}
+	#endif
+
+	#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+		void attachSubstitutionStats(SubstitutionStats* const stats)		{ _substitutionStats = stats;	}
+	#endif
+
+	#ifdef HFSM_ENABLE_COVERAGE
+		// pass to the constructor instead to cover the initial states, too
+		// (checked at run time there, and left detached if too small)
+		template <unsigned TStateCapacity>
+		void attachCoverage(CoverageT<TStateCapacity>* const coverage) {
+			static_assert(StateCount <= TStateCapacity, "Coverage too small for the machine, see CoverageT<>'s TStateCapacity.");
+
+			_coverage = coverage;
+		}
+
+		void detachCoverage()												{ _coverage = &_coverageSink;	}
+
+		// (fork, prong) pairs switched to, as recorded by the attached coverage, returns their count
+		unsigned exportTransitions(typename Coverage::Prong* const prongs, const unsigned capacity) const;
+	#endif
+
+	#ifdef HFSM_ENABLE_SCRATCH
+		// pass to the constructor instead to give the initial states their arenas, too
+		void attachScratch(ScratchBlock* const scratch)						{ _scratch = scratch;		}
+	#endif
+
+		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+		// events constructed in place in fixed buffers of TCapacity bytes per lane,
+		// reacted to later as rvalues, then destroyed;
+		// higher lanes go first, pre-empting the lower ones between any two events,
+		// each lane keeps its own order
+		template <unsigned TCapacity, unsigned TLaneCount = 1>
+		class EventQueueT {
+			struct Entry {
+				void (*react)(_R& machine, void* const event);
+				void (*destroy)(void* const event);
+				unsigned event;		// offsets in the lane's buffer
+				unsigned next;
+			};
+
+		public:
+			enum : unsigned {
+				LaneCount = TLaneCount,
+			};
+			static_assert(LaneCount > 0, "");
+
+			struct Counters {
+				unsigned emplaced;
+				unsigned dispatched;
+				unsigned dropped;		// out of room
+				unsigned preempting;	// dispatched ahead of events pending in the lower lanes
+			};
+
+		private:
+			struct Lane {
+				alignas(std::max_align_t) char buffer[TCapacity];
+
+				unsigned head = 0;
+				unsigned tail = 0;
+				unsigned count = 0;
+
+				Counters counters = {};
+			};
+
+		public:
+			EventQueueT() = default;
+			EventQueueT(const EventQueueT&) = delete;
+			EventQueueT& operator = (const EventQueueT&) = delete;
+
+			~EventQueueT()									{ clear();							}
+
+			// into the lowest lane, false once out of room
+			template <typename TEvent, typename... TArgs>
+			inline bool emplace(TArgs&&... args)			{ return emplaceIn<TEvent>(0, std::forward<TArgs>(args)...);	}
+
+			template <typename TEvent, typename... TArgs>
+			bool emplaceIn(const unsigned lane, TArgs&&... args);
+
+			// including the events emplaced while reacting,
+			// each reaction followed by the transitions it requested
+			void dispatch(_R& machine);
+
+			unsigned count() const;
+			inline unsigned count(const unsigned lane) const			{ assert(lane < LaneCount); return _lanes[lane].count;		}
+
+			inline const Counters& counters(const unsigned lane) const	{ assert(lane < LaneCount); return _lanes[lane].counters;	}
+			void clearCounters();
+
+			// destroys the events without reacting, can be called from the reactions
+			void clear();
+			void clear(const unsigned lane);
+
+		private:
+			template <typename TEvent>
+			static void react(_R& machine, void* const event)	{ machine.react(std::move(*static_cast<TEvent*>(event)));	}
+
+			template <typename TEvent>
+			static void destroy(void* const event)				{ static_cast<TEvent*>(event)->~TEvent();					}
+
+			static constexpr unsigned align(const unsigned offset, const unsigned alignment)	{ return (offset + alignment - 1) & ~(alignment - 1);	}
+
+		private:
+			Lane _lanes[LaneCount];
+			bool _dispatching = false;
+		};
+
+	protected:
+		template <typename TEvent>
+		Reaction dispatch(TEvent& event) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+	#ifdef HFSM_VARIANT_EVENTS
+		// TVariant is const for the variants passed by reference
+		template <typename TVariant, std::size_t... TIndices>
+		Reaction reactVariant(TVariant& events, std::index_sequence<TIndices...>);
+
+		template <typename TVariant, std::size_t TIndex>
+		static Reaction reactAlternative(_R& machine, TVariant& events);
+	#endif
+
+		void processTransitions() HFSM_NOEXCEPT(NoexceptTransitions);
+		void requestImmediate(const Transition request) HFSM_NOEXCEPT(true);
+		void requestScheduled(const Transition request) HFSM_NOEXCEPT(true);
+
+		inline unsigned id(const Transition request) const	{ return _stateRegistry[*request.stateType];	}
+
+		inline Control control() HFSM_NOEXCEPT(true);
+
+		HFSM_IF_LOGGER(inline void sampleLogging() HFSM_NOEXCEPT(true));
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		static const StaticStructure& staticStructure();
+	#endif
+
+	private:
+		// only touched while processing transitions
+		// (constructed ahead of _apex, which fills them in)
+		StateRegistryImpl _stateRegistry;
+
+		StateParentStorage _stateParents;
+		ForkParentStorage  _forkParents;
+		ForkPointerStorage _forkPointers;
+
+		// touched on every update() / react(), starts on its own cache line with HFSM_CACHE_LINE_SIZE defined
+		HFSM_ALIGN_HOT TransitionQueueStorage _requests;
+
+		Context& _context;
+
+		Apex _apex;
+
+		Propagation _propagation = Propagation::RootFirst;
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		StateActivityStorage _activities;
+		unsigned _activityTick = 0;
+		ActivityHistoryStorage _activityHistory;
+
+		struct DebugTransitionInfo {
+			typename Transition::Type type;
+			TypeInfo state;
+
+			enum Source {
+				Update,
+				Substitute,
+				Linger,
+
+				COUNT
+			};
+			Source source;
+
+			inline DebugTransitionInfo() = default;
+
+			inline DebugTransitionInfo(const Transition transition,
+									   const Source source_)
+				: type(transition.type)
+				, state(transition.stateType)
+				, source(source_)
+			{
+				assert(source_ < Source::COUNT);
+			}
+		};
+		// each round's requests, and the substitutions they led to
+		using DebugTransitionInfos = Array<DebugTransitionInfo, 2 * MaxSubstitutions * ForkCount>;
+		DebugTransitionInfos _lastTransitions;
+	#endif
+
+	#ifdef HFSM_ENABLE_LOG_INTERFACE
+		LoggerInterface* _logger;
+
+		LogSampling* _sampling = nullptr;
+		unsigned _samplingIndex = 0;
+		unsigned _samplingTick = 0;
+		bool _sampled = true;
+	#endif
+
+		HFSM_IF_WATCHDOG(Watchdog* _watchdog = nullptr);
+		HFSM_IF_EVENT_STATS(EventStats* _eventStats = nullptr);
+	#ifdef HFSM_ENABLE_COVERAGE
+		// written to while no coverage is attached, so recording a state takes no checks
+		CoverageT<StateCount> _coverageSink;
+		Coverage* _coverage;
+	#endif
+
+		HFSM_IF_SUBSTITUTION_STATS(SubstitutionStats* _substitutionStats = nullptr);
+		HFSM_IF_SCRATCH(ScratchBlock* _scratch = nullptr);
+	};
+
+	//----------------------------------------------------------------------
+
+public:
+
+	class Control final {
+		template <typename>
+		friend class _R;
+
+		template <unsigned, bool, typename>
+		friend struct _S;
+
+		template <unsigned, bool, typename, typename...>
+		friend struct _C;
+
+		template <unsigned, bool, typename, typename...>
+		friend struct _O;
+
+		template <unsigned>
+		friend class LoweredT;
+
+	private:
+		Control(TransitionQueue& requests,
+				const StateRegistry* const stateRegistry
+				HFSM_IF_LOGGER(, LoggerInterface* const logger)
+				HFSM_IF_STRUCTURE(, StateActivities& activities)
+				HFSM_IF_STRUCTURE(, const unsigned tick)
+				HFSM_IF_WATCHDOG(, Watchdog* const watchdog)
+				HFSM_IF_COVERAGE(, Coverage* const coverage)
+				HFSM_IF_SCRATCH(, ScratchBlock* const scratch))
+			: _requests(requests)
+			, _stateRegistry(stateRegistry)
+			HFSM_IF_LOGGER(, _logger(logger))
+			HFSM_IF_STRUCTURE(, _activities(activities))
+			HFSM_IF_STRUCTURE(, _tick(tick))
+			HFSM_IF_WATCHDOG(, _watchdog(watchdog))
+			HFSM_IF_COVERAGE(, _coverage(coverage))
+			HFSM_IF_SCRATCH(, _scratch(scratch))
+		{}
+
+	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+		inline void notifyEnter(const unsigned state)		HFSM_NOEXCEPT(true)	{ _activities[state] = StateActivity { _tick, true  };	}
+		inline void notifyLeave(const unsigned state)		HFSM_NOEXCEPT(true)	{ _activities[state] = StateActivity { _tick, false };	}
+	#endif
+
+	#ifdef HFSM_ENABLE_WATCHDOG
+		using WatchCallback = typename Watchdog::Callback;
+		using WatchTime		= typename Watchdog::TimePoint;
+
+		// the clock is only read with a watchdog attached
+		inline WatchTime watchBegin() const					HFSM_NOEXCEPT(true)	{ return _watchdog ? Watchdog::Clock::now() : WatchTime();	}
+
+		inline void watchEnd(const unsigned state,
+							 const WatchCallback callback,
+							 const WatchTime begin)			HFSM_NOEXCEPT(true)	{ if (_watchdog) _watchdog->check(state, callback, begin);	}
+
+		inline void watchEnter(const unsigned state)		HFSM_NOEXCEPT(true)	{ if (_watchdog) _watchdog->entered(state);				}
+	#endif
+
+	#ifdef HFSM_ENABLE_EVENT_STATS
+		using EventEntry = typename EventStats::Entry;
+
+		inline void countReact(const bool handled)			HFSM_NOEXCEPT(true)	{ if (_eventEntry) { ++_eventEntry->visited; _eventEntry->handled += handled; }	}
+	#endif
+
+	#ifdef HFSM_ENABLE_COVERAGE
+		inline void coverEnter(const unsigned state)		HFSM_NOEXCEPT(true)	{ _coverage->enter(state);				}
+		inline void coverSwitch(const unsigned state)		HFSM_NOEXCEPT(true)	{ _coverage->switchTo(state);			}
+	#endif
+
+		// any of the requests queued since 'from' restarting or resuming a state outside of 'range'
+		template <typename TStateId>
+		inline bool leaves(const unsigned from, const StateRange range, TStateId&& stateId) const HFSM_NOEXCEPT(true) {
+			for (unsigned i = from; i < _requests.count(); ++i) {
+				const Transition& request = _requests[i];
+
+				if ((request.type == Transition::Restart || request.type == Transition::Resume) &&
+					!range.contains(stateId(request.stateType)))
+					return true;
+			}
+
+			return false;
+		}
+
+		inline bool leaves(const unsigned from, const StateRange range) const HFSM_NOEXCEPT(true) {
+			return leaves(from, range, [this](const TypeInfo stateType) { return _stateRegistry->find(stateType); });
+		}
+
+	#ifdef HFSM_ENABLE_SCRATCH
+		inline void scratchEnter(const unsigned state, Scratch& scratch) HFSM_NOEXCEPT(true);
+		inline void scratchLeave(Scratch& scratch)			HFSM_NOEXCEPT(true)	{ scratch._used = 0;	}
+	#endif
+
+	public:
+		template <typename T>
+		inline void changeTo()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Restart,  TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void resume()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Resume,	  TypeInfo::get<T>());	}
+
+		template <typename T>
+		inline void schedule()	HFSM_NOEXCEPT(true)	{ _requests << Transition(Transition::Type::Schedule, TypeInfo::get<T>());	}
+
+		inline unsigned requestCount() const				HFSM_NOEXCEPT(true)	{ return _requests.count();	}
+
+		// in react() only, keeps the event from the states yet to be offered it
+		inline void consume()								HFSM_NOEXCEPT(true)	{ _consumed = true;			}
+		inline bool consumed() const						HFSM_NOEXCEPT(true)	{ return _consumed;			}
+
+	private:
+		inline bool leafFirst() const						HFSM_NOEXCEPT(true)	{ return _propagation == Propagation::LeafFirst;	}
+
+	private:
+		TransitionQueue& _requests;
+		const StateRegistry* const _stateRegistry;		// null in the lowered machines, which look states up themselves
+		HFSM_IF_LOGGER(LoggerInterface* const _logger);
+		HFSM_IF_STRUCTURE(StateActivities& _activities);
+		HFSM_IF_STRUCTURE(const unsigned _tick);
+		HFSM_IF_WATCHDOG(Watchdog* const _watchdog);
+		HFSM_IF_EVENT_STATS(EventEntry* _eventEntry = nullptr);	// set by react() only
+		HFSM_IF_COVERAGE(Coverage* const _coverage);
+		HFSM_IF_SCRATCH(ScratchBlock* const _scratch);
+
+		// set by react() only
+		Propagation _propagation = Propagation::RootFirst;
+		bool _consumed = false;
+		unsigned _consumer = Reaction::NONE;
+	};
+
+
+	//----------------------------------------------------------------------
+
+
+	// base of the standalone machines emitted by tools/lower.py:
+	// owns the request queue, and hands the user states the same Control
+	template <unsigned TRequestCapacity>
+	class LoweredT {
+	public:
+		using Propagation		  = typename M::Propagation;
+		using Reaction			  = typename M::Reaction;
+
+		inline void propagation(const Propagation order)	HFSM_NOEXCEPT(true)	{ _propagation = order;		}
+		inline Propagation propagation() const				HFSM_NOEXCEPT(true)	{ return _propagation;		}
+
+	protected:
+		using Transition		  = typename M::Transition;
+		using TypeInfo			  = typename M::TypeInfo;
+		using SubstitutionHistory = typename M::template SubstitutionHistoryT<TRequestCapacity>;
+		using History			  = typename M::History;
+		using StateRange		  = typename M::StateRange;
+
+		enum : unsigned { MaxSubstitutions = M::MaxSubstitutions };
+
+		template <typename THead>
+		static constexpr bool skipsObsoleteUpdates()		{ return M::template skipsObsoleteUpdates<THead>(nullptr);	}
+
+		template <typename THead>
+		static constexpr History historyOf()				{ return M::template historyOf<THead>(nullptr);				}
+
+		template <typename THead, typename TEvent>
+		static constexpr bool takesOver()					{ return M::template takesOver<THead, TEvent>(nullptr);		}
+
+		template <typename THead, typename TEvent>
+		using PassedEvent = typename M::template PassedEvent<THead, TEvent>;
+
+		inline Control control() HFSM_NOEXCEPT(true) {
+			return Control(_requests,
+						   nullptr
+						   HFSM_IF_LOGGER(, nullptr)
+						   HFSM_IF_STRUCTURE(, _activities)
+						   HFSM_IF_STRUCTURE(, 0)
+						   HFSM_IF_WATCHDOG(, nullptr)
+						   HFSM_IF_COVERAGE(, nullptr)
+						   HFSM_IF_SCRATCH(, nullptr));
+		}
+
+		// for react()
+		inline Control reactControl() HFSM_NOEXCEPT(true) {
+			Control control = this->control();
+			control._propagation = _propagation;
+
+			return control;
+		}
+
+		static inline bool leafFirst(const Control& control)	HFSM_NOEXCEPT(true)	{ return control.leafFirst();	}
+
+		// with the lowered machine's own state lookup, Control has no registry here
+		template <typename TStateId>
+		static inline bool leaves(const Control& control,
+								  const unsigned from,
+								  const StateRange range,
+								  TStateId&& stateId)			HFSM_NOEXCEPT(true)
+		{
+			return control.leaves(from, range, std::forward<TStateId>(stateId));
+		}
+
+		static inline void reacted(Control& control, const unsigned state) HFSM_NOEXCEPT(true) {
+			if (control._consumed && control._consumer == Reaction::NONE)
+				control._consumer = state;
+		}
+
+		static inline Reaction reaction(const Control& control) HFSM_NOEXCEPT(true) {
+			Reaction reaction;
+			reaction.consumer = control._consumer;
+
+			return reaction;
+		}
+
+		Array<Transition, TRequestCapacity> _requests;
+		Propagation _propagation = Propagation::RootFirst;
+
+		// only written by the template engine
+		HFSM_IF_STRUCTURE(Array<StateActivity, 1> _activities);
+	};
+
+
+	//----------------------------------------------------------------------
+
+
+	using Base = _B<Bare>;
+
+	template <typename... TInjections>
+	using BaseT = _B<TInjections...>;
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	template <typename TState, typename... TSubStates>
+	using Composite	= _CI<TState, TSubStates...>;
+
+	template <typename... TSubStates>
+	using CompositePeers = _CI<Base, TSubStates...>;
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	template <typename TState, typename... TSubStates>
+	using Orthogonal = _OI<TState, TSubStates...>;
+
+	template <typename... TSubStates>
+	using OrthogonalPeers = _OI<Base, TSubStates...>;
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-	template <typename TState, typename... TSubStates>
-	using Root = _R<Composite<TState, TSubStates...>>;
+	template <typename TState, typename... TSubStates>
+	using Root = _R<Composite<TState, TSubStates...>>;
+
+	template <typename... TSubStates>
+	using PeerRoot = _R<CompositePeers<TSubStates...>>;
+
+	template <typename TState, typename... TSubStates>
+	using OrthogonalRoot = _R<Orthogonal<TState, TSubStates...>>;
+
+	template <typename... TSubStates>
+	using OrthogonalPeerRoot = _R<OrthogonalPeers<TSubStates...>>;
+
+	//----------------------------------------------------------------------
+
+};
+
+template <typename TContext,
+		  unsigned TMaxSubstitutions = 4,
+		  typename TLogFilter = LogFilter<>>
+using Machine = M<TContext, TMaxSubstitutions, TLogFilter>;
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+
+namespace hfsm {
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::Fork::Fork(const Index index,
+							const TypeInfo HSFM_IF_DEBUG_TYPES(type_))
+	: self(index)
+	HSFM_IF_DEBUG_TYPES(, type(type_))
+{}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TCapacity>
+unsigned
+M<TC, TMS, TLF>::StateRegistryT<TCapacity>::add(const TypeInfo stateType) {
+	const unsigned index = _typeToIndex.count();
+
+	HSFM_CHECKED(_typeToIndex.insert(*stateType, index));
+
+	return index;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TCapacity>
+typename M<TC, TMS, TLF>::TypeInfo
+M<TC, TMS, TLF>::StateRegistryT<TCapacity>::type(const unsigned index) const {
+	TypeInfo stateType;
+	stateType.clear();
+
+	if (const auto* const native = _typeToIndex.findKey(index))
+		stateType = *native;
+
+	return stateType;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TFC>
+bool
+M<TC, TMS, TLF>::SubstitutionHistoryT<TFC>::record() HFSM_NOEXCEPT(true) {
+	assert(_count < MaxSubstitutions);
+
+	const Index* const pending = _configurations[_count];
+
+	// FNV-1a
+	unsigned hash = 2166136261u;
+	for (unsigned f = 0; f < TFC; ++f)
+		hash = (hash ^ pending[f]) * 16777619u;
+
+	for (unsigned r = 0; r < _count; ++r)
+		if (_hashes[r] == hash && memcmp(_configurations[r], pending, TFC) == 0)
+			return false;
+
+	_hashes[_count++] = hash;
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI, typename... TR>
+void
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreSubstitute(Context& context) HFSM_NOEXCEPT(NoexceptPreSubstitute) {
+	TI::preSubstitute(context);
+	_B<TR...>::widePreSubstitute(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI, typename... TR>
+void
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreEnter(Context& context) HFSM_NOEXCEPT(NoexceptPreEnter) {
+	TI::preEnter(context);
+	_B<TR...>::widePreEnter(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI, typename... TR>
+void
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreUpdate(Context& context) HFSM_NOEXCEPT(NoexceptPreUpdate) {
+	TI::preUpdate(context);
+	_B<TR...>::widePreUpdate(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI, typename... TR>
+void
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreTransition(Context& context) HFSM_NOEXCEPT(NoexceptPreTransition) {
+	TI::preTransition(context);
+	_B<TR...>::widePreTransition(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI, typename... TR>
+template <typename TEvent>
+void
+M<TC, TMS, TLF>::_B<TI, TR...>::widePreReact(const TEvent& event,
+											 Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value)
+{
+	TI::preReact(event, context);
+	_B<TR...>::widePreReact(event, context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI, typename... TR>
+void
+M<TC, TMS, TLF>::_B<TI, TR...>::widePostLeave(Context& context) HFSM_NOEXCEPT(NoexceptPostLeave) {
+	TI::postLeave(context);
+	_B<TR...>::widePostLeave(context);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI>
+void
+M<TC, TMS, TLF>::_B<TI>::widePreSubstitute(Context& context) HFSM_NOEXCEPT(NoexceptPreSubstitute) {
+	TI::preSubstitute(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI>
+void
+M<TC, TMS, TLF>::_B<TI>::widePreEnter(Context& context) HFSM_NOEXCEPT(NoexceptPreEnter) {
+	TI::preEnter(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI>
+void
+M<TC, TMS, TLF>::_B<TI>::widePreUpdate(Context& context) HFSM_NOEXCEPT(NoexceptPreUpdate) {
+	TI::preUpdate(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI>
+void
+M<TC, TMS, TLF>::_B<TI>::widePreTransition(Context& context) HFSM_NOEXCEPT(NoexceptPreTransition) {
+	TI::preTransition(context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI>
+template <typename TEvent>
+void
+M<TC, TMS, TLF>::_B<TI>::widePreReact(const TEvent& event,
+									  Context& context) HFSM_NOEXCEPT(NoexceptPreReact<TEvent>::Value)
+{
+	TI::preReact(event, context);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TI>
+void
+M<TC, TMS, TLF>::_B<TI>::widePostLeave(Context& context) HFSM_NOEXCEPT(NoexceptPostLeave) {
+	TI::postLeave(context);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::LogSampling::LogSampling(const Policy policy,
+										  const unsigned rate)
+	: _policy(policy)
+	, _rate(rate)
+{
+	assert(rate > 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+bool
+M<TC, TMS, TLF>::LogSampling::sample(const unsigned machine,
+									 const unsigned tick) const HFSM_NOEXCEPT(true)
+{
+	switch (_policy) {
+	case Policy::All:
+		return true;
+
+	case Policy::Ticks:
+		return tick % _rate == 0;
+
+	case Policy::Machines:
+		return machine % _rate == 0;
+
+	case Policy::Never:
+		return false;
+
+	default:
+		assert(false);
+		return true;
+	}
+}
+
+//------------------------------------------------------------------------------
 
-	template <typename... TSubStates>
-	using PeerRoot = _R<CompositePeers<TSubStates...>>;
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TRC>
+M<TC, TMS, TLF>::LogSamplingT<TRC>::LogSamplingT(const Policy policy,
+												 const unsigned rate,
+												 const unsigned seed)
+	: LogSampling(policy, rate)
+	, _random(seed ? seed : 1)
+{}
 
-	template <typename TState, typename... TSubStates>
-	using OrthogonalRoot = _R<Orthogonal<TState, TSubStates...>>;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-	template <typename... TSubStates>
-	using OrthogonalPeerRoot = _R<OrthogonalPeers<TSubStates...>>;
+// reservoir sampling, 'Algorithm R'
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TRC>
+void
+M<TC, TMS, TLF>::LogSamplingT<TRC>::offer(const Transition& transition) HFSM_NOEXCEPT(true) {
+	++_offered;
 
-	//----------------------------------------------------------------------
+	if (_reservoir.count() < Capacity)
+		_reservoir << transition;
+	else {
+		const unsigned slot = random() % _offered;
 
-};
+		if (slot < Capacity)
+			_reservoir[slot] = transition;
+	}
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// xorshift32
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TRC>
+unsigned
+M<TC, TMS, TLF>::LogSamplingT<TRC>::random() HFSM_NOEXCEPT(true) {
+	_random ^= _random << 13;
+	_random ^= _random >> 17;
+	_random ^= _random << 5;
+
+	return _random;
+}
+
+#endif
 
-template <typename TContext, unsigned TMaxSubstitutions = 4>
-using Machine = M<TContext, TMaxSubstitutions>;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+
+#ifdef HFSM_ENABLE_WATCHDOG
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::Watchdog::Watchdog(StateWatches& states,
+									Incidents& incidents)
+	: _states(states)
+	, _incidents(incidents)
+{}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::check(const unsigned state,
+								 const Callback callback,
+								 const TimePoint begin) HFSM_NOEXCEPT(true)
+{
+	const TimePoint end = Clock::now();
+	const Duration duration = end - begin;
+
+	const Duration threshold = _states[state].threshold != Duration::zero() ?
+		_states[state].threshold : _threshold;
+
+	if (duration > threshold)
+		report(Incident { Incident::Type::SlowCallback, state, callback, duration, _tick, end });
 }
 
-namespace hfsm {
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::entered(const unsigned state) HFSM_NOEXCEPT(true) {
+	auto& watch = _states[state];
+
+	if (_tick - watch.windowStart >= _oscillationWindow) {
+		watch.windowStart = _tick;
+		watch.enters = 0;
+	}
+
+	// once per window
+	if (++watch.enters == _oscillationLimit + 1)
+		report(Incident { Incident::Type::Oscillation, state, Callback::Enter, Duration::zero(), _tick, Clock::now() });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::exhausted(const unsigned state) HFSM_NOEXCEPT(true) {
+	report(Incident { Incident::Type::SubstitutionLimit, state, Callback::Substitute, Duration::zero(), _tick, Clock::now() });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::cycled(const unsigned state) HFSM_NOEXCEPT(true) {
+	report(Incident { Incident::Type::SubstitutionCycle, state, Callback::Substitute, Duration::zero(), _tick, Clock::now() });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::overBudget(const unsigned state,
+									  const Duration duration) HFSM_NOEXCEPT(true)
+{
+	report(Incident { Incident::Type::SubstitutionBudget, state, Callback::Substitute, duration, _tick, Clock::now() });
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Watchdog::report(const Incident& incident) HFSM_NOEXCEPT(true) {
+	if (_incidents.count() < _incidents.capacity())
+		_incidents << incident;
+	else
+		_incidents[_reported % _incidents.capacity()] = incident;
+
+	++_reported;
+}
+
+#endif
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
 
-template <typename TC, unsigned TMS>
-M<TC, TMS>::Fork::Fork(const Index index,
-					   const TypeInfo HSFM_IF_DEBUG(type_))
-	: self(index)
-	HSFM_IF_DEBUG(, type(type_))
+#ifdef HFSM_ENABLE_EVENT_STATS
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::EventStats::EventStats(Entries& entries)
+	: _entries(entries)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <unsigned TCapacity>
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::EventStats::merge(const EventStats& other) {
+	for (unsigned i = 0; i < other._entries.count(); ++i) {
+		const Entry& from = other._entries[i];
+
+		if (Entry* const to = insert(from.event)) {
+			to->dispatched	+= from.dispatched;
+			to->visited		+= from.visited;
+			to->handled		+= from.handled;
+			to->transitions	+= from.transitions;
+		} else
+			_dropped += from.dispatched;
+	}
+
+	_dropped += other._dropped;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+const typename M<TC, TMS, TLF>::EventStats::Entry*
+M<TC, TMS, TLF>::EventStats::find(const TypeInfo event) const HFSM_NOEXCEPT(true) {
+	// a handful of event types per machine, linear search beats hashing
+	for (unsigned i = 0; i < _entries.count(); ++i)
+		if (_entries[i].event == event)
+			return &_entries[i];
+
+	return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+typename M<TC, TMS, TLF>::EventStats::Entry*
+M<TC, TMS, TLF>::EventStats::insert(const TypeInfo event) HFSM_NOEXCEPT(true) {
+	if (const Entry* const entry = find(event))
+		return const_cast<Entry*>(entry);
+	else if (_entries.count() < _entries.capacity())
+		return &_entries[_entries << Entry { event, 0, 0, 0, 0 }];
+	else
+		return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+typename M<TC, TMS, TLF>::EventStats::Entry*
+M<TC, TMS, TLF>::EventStats::dispatched(const TypeInfo event) HFSM_NOEXCEPT(true) {
+	Entry* const entry = insert(event);
+
+	if (entry)
+		++entry->dispatched;
+	else
+		++_dropped;
+
+	return entry;
+}
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef HFSM_ENABLE_COVERAGE
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::Coverage::Coverage(const unsigned capacity,
+									Words& states,
+									Words& transitions)
+	: _capacity(capacity)
+	, _states(states)
+	, _transitions(transitions)
+{}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+bool
+M<TC, TMS, TLF>::Coverage::merge(const Coverage& other) {
+	if (_capacity != other._capacity)
+		return false;
+
+	for (unsigned i = 0; i < _states.count(); ++i) {
+		_states[i]		|= other._states[i];
+		_transitions[i]	|= other._transitions[i];
+	}
+
+	return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
 unsigned
-M<TC, TMS>::StateRegistryT<TCapacity>::add(const TypeInfo stateType) {
-	const unsigned index = _typeToIndex.count();
+M<TC, TMS, TLF>::Coverage::exportStates(unsigned* const states,
+										const unsigned capacity) const
+{
+	unsigned count = 0;
 
-	HSFM_CHECKED(_typeToIndex.insert(*stateType, index));
+	for (unsigned state = 0; state < _capacity && count < capacity; ++state)
+		if (entered(state))
+			states[count++] = state;
 
-	return index;
+	return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Coverage::clear() {
+	for (unsigned i = 0; i < _states.count(); ++i) {
+		_states[i]		= 0;
+		_transitions[i]	= 0;
+	}
 }
 
+#endif
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
 
-template <typename TC, unsigned TMS>
-template <typename TI, typename... TR>
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+
+template <typename TC, unsigned TMS, typename TLF>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreSubstitute(Context& context) {
-	TI::preSubstitute(context);
-	_B<TR...>::widePreSubstitute(context);
+M<TC, TMS, TLF>::SubstitutionStats::record(const unsigned rounds) HFSM_NOEXCEPT(true) {
+	assert(rounds <= MaxSubstitutions);
+
+	++_calls;
+	++_rounds[rounds];
+
+	if (_peak < rounds)
+		_peak = rounds;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreEnter(Context& context) {
-	TI::preEnter(context);
-	_B<TR...>::widePreEnter(context);
+M<TC, TMS, TLF>::SubstitutionStats::clear() {
+	const Duration budget = _budget;
+
+	*this = SubstitutionStats{};
+	_budget = budget;
 }
 
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef HFSM_ENABLE_SCRATCH
+
+template <typename TC, unsigned TMS, typename TLF>
+M<TC, TMS, TLF>::ScratchBlock::ScratchBlock(char* const memory,
+											const unsigned capacity,
+											HighWaters& highWaters,
+											FreeLists& freeLists)
+	: _memory(memory)
+	, _capacity(capacity)
+	, _highWaters(highWaters)
+	, _freeLists(freeLists)
+{}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreUpdate(Context& context) {
-	TI::preUpdate(context);
-	_B<TR...>::widePreUpdate(context);
+M<TC, TMS, TLF>::ScratchBlock::clearHighWaters() {
+	for (unsigned i = 0; i < _highWaters.count(); ++i)
+		_highWaters[i] = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+char*
+M<TC, TMS, TLF>::ScratchBlock::carve(const unsigned state,
+									 const unsigned size) HFSM_NOEXCEPT(true)
+{
+	// one left behind by a destroyed machine, of the same state and size
+	if (char* const arena = _freeLists[state]) {
+		memcpy(&_freeLists[state], arena, sizeof(char*));
+
+		return arena;
+	}
+
+	// keep every arena aligned for any type, and large enough to hold the free list link
+	const unsigned padded = (size + alignof(std::max_align_t) - 1) & ~(unsigned) (alignof(std::max_align_t) - 1);
+
+	if (_capacity - _carved < padded)
+		return nullptr;
+
+	char* const arena = _memory + _carved;
+	_carved += padded;
+
+	return arena;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
 void
-M<TC, TMS>::_B<TI, TR...>::widePreTransition(Context& context) {
-	TI::preTransition(context);
-	_B<TR...>::widePreTransition(context);
+M<TC, TMS, TLF>::ScratchBlock::release(const unsigned state,
+									   char* const arena) HFSM_NOEXCEPT(true)
+{
+	memcpy(arena, &_freeLists[state], sizeof(char*));
+	_freeLists[state] = arena;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void*
+M<TC, TMS, TLF>::Scratch::allocate(const unsigned size,
+								   const unsigned alignment) HFSM_NOEXCEPT(true)
+{
+	assert(alignment && (alignment & (alignment - 1)) == 0 && alignment <= alignof(std::max_align_t));
+
+	const unsigned begin = (_used + alignment - 1) & ~(alignment - 1);
+
+	if (!_memory || begin > _capacity || _capacity - begin < size)
+		return nullptr;
+
+	_used = begin + size;
+	_block->record(_state, _used);
+
+	return _memory + begin;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename T, typename... TArgs>
+T*
+M<TC, TMS, TLF>::Scratch::create(TArgs&&... args) {
+	static_assert(std::is_trivially_destructible<T>::value, "Scratch arenas are released without calling destructors");
+
+	void* const memory = allocate(sizeof(T), alignof(T));
+
+	return memory ? new (memory) T(std::forward<TArgs>(args)...) : nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+void
+M<TC, TMS, TLF>::Control::scratchEnter(const unsigned state,
+									   Scratch& scratch) HFSM_NOEXCEPT(true)
+{
+	if (scratch._memory || !_scratch)
+		return;
+
+	scratch._memory = _scratch->carve(state, scratch._capacity);
+
+	if (scratch._memory) {
+		scratch._block = _scratch;
+		scratch._state = state;
+	} else if (!scratch._missed) {
+		// retried on every entry, in case another machine returns one
+		scratch._missed = true;
+		++_scratch->_missed;
+	}
+}
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+M<TC, TMS, TLF>::_R<TA>::_R(Context& context
+							HFSM_IF_LOGGER(, LoggerInterface* const logger)
+							HFSM_IF_COVERAGE(, Coverage* const coverage)
+							HFSM_IF_SCRATCH(, ScratchBlock* const scratch))
+	: _context(context)
+	, _apex(_stateRegistry, Parent(), _stateParents, _forkParents, _forkPointers)
+	HFSM_IF_LOGGER(, _logger(logger))
+	HFSM_IF_COVERAGE(, _coverage(coverage && coverage->capacity() >= StateCount ? coverage : &_coverageSink))
+	HFSM_IF_SCRATCH(, _scratch(scratch))
+{
+	HFSM_IF_COVERAGE(assert(!coverage || _coverage == coverage));
+	HFSM_IF_STRUCTURE(_activities.resize(StateCount));
+
+	auto control = this->control();
+	_apex.deepEnterInitial(control, _context);
+
+	HFSM_IF_STRUCTURE(++_activityTick);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+M<TC, TMS, TLF>::_R<TA>::~_R() {
+	HFSM_IF_LOGGER(_sampled = true);
+
+	auto control = this->control();
+	_apex.deepLeave(control, _context);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+void
+M<TC, TMS, TLF>::_R<TA>::update() HFSM_NOEXCEPT(NoexceptUpdate) {
+	HFSM_IF_LOGGER(sampleLogging());
+	HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->tick());
+
+	auto control = this->control();
+	_apex.deepUpdateAndTransition(control, _context);
+
+	if (_requests.count())
+		processTransitions();
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename TEvent, typename... TArgs>
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::emplace(TArgs&&... args) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value &&
+																std::is_nothrow_constructible<TEvent, TArgs&&...>::value)
+{
+	TEvent event(std::forward<TArgs>(args)...);
+
+	return dispatch(event);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TI, typename... TR>
-template <typename TEvent>
-void
-M<TC, TMS>::_B<TI, TR...>::widePreReact(const TEvent& event,
-										Context& context)
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename TEvent>
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::dispatch(TEvent& event) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value) {
+	HFSM_IF_LOGGER(sampleLogging());
+	HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->tick());
+
+	auto control = this->control();
+	control._propagation = _propagation;
+	HFSM_IF_EVENT_STATS(if (_eventStats) control._eventEntry = _eventStats->dispatched(TypeInfo::get<typename std::remove_const<TEvent>::type>()));
+
+	_apex.deepReact(event, control, _context);
+	HFSM_IF_EVENT_STATS(if (control._eventEntry) control._eventEntry->transitions += _requests.count());
+
+	if (_requests.count())
+		processTransitions();
+
+	Reaction reaction;
+	reaction.consumer = control._consumer;
+
+	return reaction;
+}
+
+//------------------------------------------------------------------------------
+
+#ifdef HFSM_VARIANT_EVENTS
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename TVariant, std::size_t... TIndices>
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::reactVariant(TVariant& events,
+									  std::index_sequence<TIndices...>)
+{
+	using Alternative = Reaction (*)(_R&, TVariant&);
+
+	// indexed by alternative, instead of std::visit()-ing into react()
+	static constexpr Alternative alternatives[] = { &_R::template reactAlternative<TVariant, TIndices>... };
+
+	return events.valueless_by_exception() ?
+		Reaction{} : alternatives[events.index()](*this, events);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename TVariant, std::size_t TIndex>
+typename M<TC, TMS, TLF>::Reaction
+M<TC, TMS, TLF>::_R<TA>::reactAlternative(_R& machine,
+										  TVariant& events)
+{
+	auto& event = *std::get_if<TIndex>(&events);
+
+	if constexpr (std::is_same<std::decay_t<decltype(event)>, std::monostate>::value)
+		return Reaction{};
+	else
+		return machine.dispatch(event);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+template <typename TEvent, typename... TArgs>
+bool
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::emplaceIn(const unsigned lane,
+																	   TArgs&&... args)
 {
-	TI::preReact(event, context);
-	_B<TR...>::widePreReact(event, context);
-}
+	static_assert(alignof(TEvent) <= alignof(std::max_align_t), "Over-aligned events can't be queued");
+	assert(lane < LaneCount);
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	Lane& target = _lanes[lane];
 
-template <typename TC, unsigned TMS>
-template <typename TI, typename... TR>
-void
-M<TC, TMS>::_B<TI, TR...>::widePostLeave(Context& context) {
-	TI::postLeave(context);
-	_B<TR...>::widePostLeave(context);
-}
+	const unsigned event = align(target.tail + sizeof(Entry), alignof(TEvent));
 
-//------------------------------------------------------------------------------
+	if (event + sizeof(TEvent) > TCapacity) {
+		++target.counters.dropped;
 
-template <typename TC, unsigned TMS>
-template <typename TI>
-void
-M<TC, TMS>::_B<TI>::widePreSubstitute(Context& context) {
-	TI::preSubstitute(context);
-}
+		return false;
+	}
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	new (target.buffer + event) TEvent(std::forward<TArgs>(args)...);
 
-template <typename TC, unsigned TMS>
-template <typename TI>
-void
-M<TC, TMS>::_B<TI>::widePreEnter(Context& context) {
-	TI::preEnter(context);
-}
+	// keep the next entry aligned, too
+	const unsigned next = align(event + sizeof(TEvent), alignof(Entry));
+	new (target.buffer + target.tail) Entry{ &react<TEvent>, &destroy<TEvent>, event, next };
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	target.tail = next;
+	++target.count;
+	++target.counters.emplaced;
 
-template <typename TC, unsigned TMS>
-template <typename TI>
-void
-M<TC, TMS>::_B<TI>::widePreUpdate(Context& context) {
-	TI::preUpdate(context);
+	return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
 void
-M<TC, TMS>::_B<TI>::widePreTransition(Context& context) {
-	TI::preTransition(context);
-}
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::dispatch(_R& machine) {
+	// destroyed / reset even if react() throws
+	struct Guard {
+		~Guard()											{ entry.destroy(event);		}
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		const Entry& entry;
+		void* const event;
+	};
 
-template <typename TC, unsigned TMS>
-template <typename TI>
-template <typename TEvent>
-void
-M<TC, TMS>::_B<TI>::widePreReact(const TEvent& event,
-								 Context& context)
-{
-	TI::preReact(event, context);
-}
+	struct Dispatching {
+		~Dispatching()										{ flag = false;				}
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		bool& flag;
+	};
 
-template <typename TC, unsigned TMS>
-template <typename TI>
-void
-M<TC, TMS>::_B<TI>::widePostLeave(Context& context) {
-	TI::postLeave(context);
-}
+	assert(!_dispatching);
+	_dispatching = true;
+	const Dispatching dispatching{ _dispatching };
 
+	// the highest pending lane is looked up again after every event,
+	// picking up the ones emplaced by the reactions
+	for (unsigned lane = LaneCount; lane > 0; ) {
+		Lane& source = _lanes[lane - 1];
 
-////////////////////////////////////////////////////////////////////////////////
+		if (source.count == 0) {
+			// buffers are reused once their lane is drained
+			source.head = source.tail = 0;
+			--lane;
 
+			continue;
+		}
 
-template <typename TC, unsigned TMS>
-template <typename TA>
-M<TC, TMS>::_R<TA>::_R(Context& context
-					   HFSM_IF_LOGGER(, LoggerInterface* const logger))
-	: _context(context)
-	, _apex(_stateRegistry, Parent(), _stateParents, _forkParents, _forkPointers)
-	HFSM_IF_LOGGER(, _logger(logger))
-{
-	HFSM_IF_STRUCTURE(getStateNames());
+		for (unsigned lower = 0; lower < lane - 1; ++lower)
+			if (_lanes[lower].count) {
+				++source.counters.preempting;
+				break;
+			}
+
+		const Entry& entry = *reinterpret_cast<const Entry*>(source.buffer + source.head);
+		source.head = entry.next;
+		--source.count;
+		++source.counters.dispatched;
 
-	_apex.deepEnterInitial(_context, HFSM_LOGGER_OR(_logger, nullptr));
+		const Guard guard{ entry, source.buffer + entry.event };
+		entry.react(machine, guard.event);
 
-	HFSM_IF_STRUCTURE(udpateActivity());
+		lane = LaneCount;
+	}
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
-M<TC, TMS>::_R<TA>::~_R() {
-	_apex.deepLeave(_context, HFSM_LOGGER_OR(_logger, nullptr));
+template <unsigned TCapacity, unsigned TLaneCount>
+unsigned
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::count() const {
+	unsigned total = 0;
+
+	for (const Lane& lane : _lanes)
+		total += lane.count;
+
+	return total;
 }
 
-//------------------------------------------------------------------------------
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
 void
-M<TC, TMS>::_R<TA>::update() {
-	Control control(_requests);
-	_apex.deepUpdateAndTransition(control, _context, HFSM_LOGGER_OR(_logger, nullptr));
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::clearCounters() {
+	for (Lane& lane : _lanes)
+		lane.counters = Counters{};
+}
 
-	if (_requests.count())
-		processTransitions();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <unsigned TCapacity, unsigned TLaneCount>
+void
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::clear() {
+	for (unsigned lane = 0; lane < LaneCount; ++lane)
+		clear(lane);
 }
 
-//------------------------------------------------------------------------------
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
-template <typename TEvent>
+template <unsigned TCapacity, unsigned TLaneCount>
 void
-M<TC, TMS>::_R<TA>::react(const TEvent& event) {
-	Control control(_requests);
-	_apex.deepReact(event, control, _context, HFSM_LOGGER_OR(_logger, nullptr));
+M<TC, TMS, TLF>::_R<TA>::EventQueueT<TCapacity, TLaneCount>::clear(const unsigned lane) {
+	assert(lane < LaneCount);
 
-	if (_requests.count())
-		processTransitions();
+	Lane& target = _lanes[lane];
+
+	while (target.head < target.tail) {
+		const Entry& entry = *reinterpret_cast<const Entry*>(target.buffer + target.head);
+		target.head = entry.next;
+
+		entry.destroy(target.buffer + entry.event);
+	}
+
+	target.count = 0;
+
+	// the event being reacted to may still live in the buffer
+	if (!_dispatching)
+		target.head = target.tail = 0;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 template <typename T>
 bool
-M<TC, TMS>::_R<TA>::isActive() {
+M<TC, TMS, TLF>::_R<TA>::isActive() {
 	using Type = T;
 
 	const auto stateType = TypeInfo::get<Type>();
@@ -1693,11 +3959,11 @@ M<TC, TMS>::_R<TA>::isActive() {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 template <typename T>
 bool
-M<TC, TMS>::_R<TA>::isResumable() {
+M<TC, TMS, TLF>::_R<TA>::isResumable() {
 	using Type = T;
 
 	const auto stateType = TypeInfo::get<Type>();
@@ -1715,20 +3981,60 @@ M<TC, TMS>::_R<TA>::isResumable() {
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename T>
+constexpr unsigned
+M<TC, TMS, TLF>::_R<TA>::stateIndex() {
+	constexpr unsigned state = Apex::template deepFind<T>();
+	static_assert(state != INVALID_STATE, "T is not a state of the machine");
+
+	return state;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// one walk down the types, from the apex to the state
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+template <typename T>
+constexpr typename M<TC, TMS, TLF>::template _R<TA>::Location
+M<TC, TMS, TLF>::_R<TA>::locate() {
+	Location location{};
+	location.state	= stateIndex<T>();
+	location.parent	= INVALID_STATE;
+
+	Apex::deepLocate(0, location);
+
+	return location;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::processTransitions() {
+M<TC, TMS, TLF>::_R<TA>::processTransitions() HFSM_NOEXCEPT(NoexceptTransitions) {
 	HFSM_IF_STRUCTURE(_lastTransitions.clear());
 
-	for (unsigned i = 0;
-		i < MaxSubstitutions && _requests.count();
-		++i)
-	{
+#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+	using Clock = typename SubstitutionStats::Clock;
+
+	const bool budgeted = _substitutionStats && _substitutionStats->_budget != SubstitutionStats::Duration::zero();
+	const auto begin = budgeted ? Clock::now() : typename Clock::time_point{};
+#endif
+
+	SubstitutionHistory history;
+	unsigned round = 0;
+
+	while (round < MaxSubstitutions && _requests.count()) {
+		++round;
+
 		unsigned changeCount = 0;
 
 		for (const auto& request : _requests) {
 			HFSM_IF_STRUCTURE(_lastTransitions << DebugTransitionInfo(request, DebugTransitionInfo::Update));
+			HFSM_IF_LOGGER(if (_sampling) _sampling->offer(request));
 
 			switch (request.type) {
 			case Transition::Restart:
@@ -1749,33 +4055,64 @@ M<TC, TMS>::_R<TA>::processTransitions() {
 		_requests.clear();
 
 		if (changeCount > 0) {
-			Control substitutionControl(_requests);
-			_apex.deepForwardSubstitute(substitutionControl, _context, HFSM_LOGGER_OR(_logger, nullptr));
+			auto substitutionControl = control();
+			_apex.deepForwardSubstitute(substitutionControl, _context);
 
 		#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 			for (const auto& request : _requests)
 				_lastTransitions << DebugTransitionInfo(request, DebugTransitionInfo::Substitute);
 		#endif
+
+			if (_requests.count()) {
+				Index* const requested = history.pending();
+				for (unsigned f = 0; f < ForkCount; ++f)
+					requested[f] = _forkPointers[f]->requested;
+
+				// configuration requested in an earlier round already, keep it and drop the requests going round again
+				if (!history.record()) {
+					HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->cycled(id(_requests[0])));
+					HFSM_IF_SUBSTITUTION_STATS(if (_substitutionStats) ++_substitutionStats->_cycles);
+
+					_requests.clear();
+				}
+			#ifdef HFSM_ENABLE_SUBSTITUTION_STATS
+				else if (budgeted && round < MaxSubstitutions && Clock::now() - begin > _substitutionStats->_budget) {
+					HFSM_IF_WATCHDOG(if (_watchdog) _watchdog->overBudget(id(_requests[0]), Clock::now() - begin));
+					++_substitutionStats->_overBudget;
+
+					break;
+				}
+			#endif
+			}
 		}
 	}
 
-	_apex.deepChangeToRequested(_context, HFSM_LOGGER_OR(_logger, nullptr));
+	if (_requests.count()) {
+		// still substituting after TMaxSubstitutions rounds
+		HFSM_IF_WATCHDOG(if (_watchdog && round == MaxSubstitutions) _watchdog->exhausted(id(_requests[0])));
+		HFSM_IF_SUBSTITUTION_STATS(if (_substitutionStats && round == MaxSubstitutions) ++_substitutionStats->_exhausted);
+	}
+
+	HFSM_IF_SUBSTITUTION_STATS(if (_substitutionStats) _substitutionStats->record(round));
 
-	HFSM_IF_STRUCTURE(udpateActivity());
+	auto control = this->control();
+	_apex.deepChangeToRequested(control, _context);
+
+	HFSM_IF_STRUCTURE(++_activityTick);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::requestImmediate(const Transition request) {
+M<TC, TMS, TLF>::_R<TA>::requestImmediate(const Transition request) HFSM_NOEXCEPT(true) {
 	const unsigned state = id(request);
 
 	for (auto parent = _stateParents[state]; parent; parent = _forkParents[parent.fork]) {
 		auto& fork = *_forkPointers[parent.fork];
 
-		HSFM_IF_DEBUG(fork.requestedType = parent.prongType);
+		HSFM_IF_DEBUG_TYPES(fork.requestedType = parent.prongType);
 		fork.requested = parent.prong;
 	}
 
@@ -1784,38 +4121,120 @@ M<TC, TMS>::_R<TA>::requestImmediate(const Transition request) {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::requestScheduled(const Transition request) {
+M<TC, TMS, TLF>::_R<TA>::requestScheduled(const Transition request) HFSM_NOEXCEPT(true) {
 	const unsigned state = id(request);
 
 	const auto parent = _stateParents[state];
 	auto& fork = *_forkPointers[parent.fork];
 
-	HSFM_IF_ASSERT(const auto forksParent = _stateParents[fork.self]);
-	HSFM_IF_ASSERT(const auto& forksFork = *_forkPointers[forksParent.fork]);
-	assert(forksFork.active == INVALID_INDEX);
+	// only into inactive regions (fork.self is a fork id, its parent is in _forkParents)
+	HSFM_IF_ASSERT(const auto forksParent = _forkParents[fork.self]);
+	assert(!forksParent || _forkPointers[forksParent.fork]->active != forksParent.prong);
 
-	HSFM_IF_DEBUG(fork.resumableType = parent.prongType);
+	HSFM_IF_DEBUG_TYPES(fork.resumableType = parent.prongType);
 	fork.resumable = parent.prong;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+typename M<TC, TMS, TLF>::Control
+M<TC, TMS, TLF>::_R<TA>::control() HFSM_NOEXCEPT(true) {
+	return Control(_requests,
+				   &_stateRegistry
+				   HFSM_IF_LOGGER(, _sampled ? _logger : nullptr)
+				   HFSM_IF_STRUCTURE(, _activities)
+				   HFSM_IF_STRUCTURE(, _activityTick)
+				   HFSM_IF_WATCHDOG(, _watchdog)
+				   HFSM_IF_COVERAGE(, _coverage)
+				   HFSM_IF_SCRATCH(, _scratch));
+}
+
 //------------------------------------------------------------------------------
 
-#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+#ifdef HFSM_ENABLE_COVERAGE
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+unsigned
+M<TC, TMS, TLF>::_R<TA>::exportTransitions(typename Coverage::Prong* const prongs,
+										   const unsigned capacity) const
+{
+	unsigned count = 0;
+
+	if (_coverage != &_coverageSink)
+		for (unsigned state = 0; state < StateCount && count < capacity; ++state)
+			if (_coverage->switchedTo(state))
+				prongs[count++] = typename Coverage::Prong { _stateParents[state].fork, _stateParents[state].prong };
+
+	return count;
+}
+
+#endif
 
-template <typename TC, unsigned TMS>
+//------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+typename M<TC, TMS, TLF>::TypeInfo
+M<TC, TMS, TLF>::_R<TA>::prongType(const unsigned fork,
+								   const unsigned prong) const
+{
+	for (unsigned s = 0; s < StateCount; ++s)
+		if (_stateParents[s].fork == fork && _stateParents[s].prong == prong)
+			return stateType(s);
+
+	TypeInfo none;
+	none.clear();
+
+	return none;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
 void
-M<TC, TMS>::_R<TA>::getStateNames() {
-	_stateInfos.clear();
-	_apex.deepGetNames((unsigned) -1, StateInfo::Composite, 0, _stateInfos);
+M<TC, TMS, TLF>::_R<TA>::attachSampling(LogSampling* const sampling) {
+	_sampling	   = sampling;
+	_samplingIndex = sampling ? sampling->enroll() : 0;
+	_samplingTick  = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+void
+M<TC, TMS, TLF>::_R<TA>::sampleLogging() HFSM_NOEXCEPT(true) {
+	_sampled = !_sampling || _sampling->sample(_samplingIndex, _samplingTick++);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+M<TC, TMS, TLF>::_R<TA>::StaticStructure::StaticStructure() {
+	Apex::deepGetNames((unsigned) -1, StateInfo::Composite, 0, stateInfos);
 
 	unsigned margin = (unsigned) -1;
-	for (unsigned s = 0; s < _stateInfos.count(); ++s) {
-		const auto& state = _stateInfos[s];
-		auto& prefix      = _prefixes[s];
+	for (unsigned s = 0; s < stateInfos.count(); ++s) {
+		const auto& state = stateInfos[s];
+		auto& prefix      = prefixes[s];
 
 		if (margin > state.depth && state.name[0] != '\0')
 			margin = state.depth;
@@ -1833,7 +4252,7 @@ M<TC, TMS>::_R<TA>::getStateNames() {
 				prefix[d - 1] = L' ';
 
 			for (unsigned r = s; r > state.parent; --r) {
-				auto& prefixAbove = _prefixes[r - 1];
+				auto& prefixAbove = prefixes[r - 1];
 
 				switch (prefixAbove[mark]) {
 				case L' ':
@@ -1852,17 +4271,15 @@ M<TC, TMS>::_R<TA>::getStateNames() {
 	if (margin > 0)
 		margin -= 1;
 
-	_structure.clear();
-	for (unsigned s = 0; s < _stateInfos.count(); ++s) {
-		const auto& state = _stateInfos[s];
-		auto& prefix = _prefixes[s];
+	for (unsigned s = 0; s < stateInfos.count(); ++s) {
+		const auto& state = stateInfos[s];
+		auto& prefix = prefixes[s];
 		const auto space = state.depth * 2;
 
 		if (state.name[0] != L'\0') {
-			_structure << StructureEntry { false, &prefix[margin * 2], state.name };
-			_activityHistory << (char) 0;
-		} else if (s + 1 < _stateInfos.count()) {
-			auto& nextPrefix = _prefixes[s + 1];
+			structure << StructureEntry { &prefix[margin * 2], state.name, state.footprint };
+		} else if (s + 1 < stateInfos.count()) {
+			auto& nextPrefix = prefixes[s + 1];
 
 			if (s > 0)
 				for (unsigned c = 0; c <= space; ++c)
@@ -1884,31 +4301,37 @@ M<TC, TMS>::_R<TA>::getStateNames() {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
+template <typename TC, unsigned TMS, typename TLF>
 template <typename TA>
-void
-M<TC, TMS>::_R<TA>::udpateActivity() {
-	for (auto& item : _structure)
-		item.isActive = false;
+const typename M<TC, TMS, TLF>::template _R<TA>::StaticStructure&
+M<TC, TMS, TLF>::_R<TA>::staticStructure() {
+	static const StaticStructure instance;
 
-	unsigned index = 0;
-	_apex.deepIsActive(true, index, _structure);
+	return instance;
+}
 
-	for (unsigned i = 0; i < _structure.count(); ++i) {
-		auto& activity = _activityHistory[i];
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-		if (_structure[i].isActive) {
-			if (activity > 0)
-				activity = activity < std::numeric_limits<char>::max() ? activity + 1 : activity;
-			else
-				activity = +1;
-		} else {
-			if (activity > 0)
-				activity = -1;
+template <typename TC, unsigned TMS, typename TLF>
+template <typename TA>
+const MachineActivity&
+M<TC, TMS, TLF>::_R<TA>::activity() {
+	const auto& stateInfos = staticStructure().stateInfos;
+
+	_activityHistory.clear();
+
+	for (unsigned s = 0; s < stateInfos.count(); ++s)
+		if (stateInfos[s].name[0] != '\0') {
+			const auto& state = _activities[s];
+			const int age = (int) (_activityTick - state.since);
+
+			if (state.isActive)
+				_activityHistory << (char) (age < +std::numeric_limits<char>::max() ? +age : std::numeric_limits<char>::max());
 			else
-				activity = activity > std::numeric_limits<char>::min() ? activity - 1 : activity;
+				_activityHistory << (char) (age < -std::numeric_limits<char>::min() ? -age : std::numeric_limits<char>::min());
 		}
-	}
+
+	return _activityHistory;
 }
 
 #endif
@@ -1922,12 +4345,17 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContext, unsigned TMaxSubstitutions>
-template <typename TH>
-struct M<TContext, TMaxSubstitutions>::_S {
+template <typename TContext, unsigned TMaxSubstitutions, typename TLogFilter>
+template <unsigned TStateID, bool TLogScope, typename TH>
+struct M<TContext, TMaxSubstitutions, TLogFilter>::_S
+	: HeadT<TStateID, TH>
+{
 	using Head = TH;
+	using HeadT<TStateID, TH>::head;
 
 	enum : unsigned {
+		StateID		 = TStateID,
+
 		ReverseDepth = 1,
 		DeepWidth	 = 0,
 		StateCount	 = 1,
@@ -1936,32 +4364,106 @@ struct M<TContext, TMaxSubstitutions>::_S {
 		Width		 = 1,
 	};
 
+#ifdef HFSM_ENABLE_NOEXCEPT
+	// user callbacks, together with the injections' pre- / post- calls
+	enum : bool {
+	#ifdef HFSM_ENABLE_LOG_INTERFACE
+		NoexceptLog					 = noexcept(std::declval<LoggerInterface&>().record(std::declval<const LoggerInterface::StateType&>(),
+																						nullptr,
+																						LoggerInterface::Method::Enter,
+																						nullptr)),
+	#else
+		NoexceptLog					 = true,
+	#endif
+
+		NoexceptSubstitute			 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().widePreSubstitute(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().substitute(std::declval<Control&>(), std::declval<Context&>())),
+
+		NoexceptEnter				 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().widePreEnter(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().enter(std::declval<Context&>())),
+
+		NoexceptUpdate				 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().widePreUpdate(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().update(std::declval<Context&>())),
+
+		NoexceptUpdateAndTransition	 = NoexceptUpdate &&
+									   noexcept(std::declval<Head&>().widePreTransition(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().transition(std::declval<Control&>(), std::declval<Context&>())),
+
+		NoexceptLeave				 = NoexceptLog &&
+									   noexcept(std::declval<Head&>().leave(std::declval<Context&>())) &&
+									   noexcept(std::declval<Head&>().widePostLeave(std::declval<Context&>())),
+	};
+
+	// TEvent is const, unless the event was passed to react() as an rvalue
+	template <typename TEvent>
+	struct NoexceptReact {
+		enum : bool {
+			Value = NoexceptLog &&
+					noexcept(std::declval<Head&>().widePreReact(std::declval<const TEvent&>(), std::declval<Context&>())) &&
+					noexcept(std::declval<Head&>().react(std::declval<PassedEvent<Head, TEvent>>(), std::declval<Control&>(), std::declval<Context&>()))
+		};
+	};
+#endif
+
 	_S(StateRegistry& stateRegistry,
 	   const Parent parent,
 	   Parents& stateParents,
 	   Parents& forkParents,
 	   ForkPointers& forkPointers);
 
-	inline void deepForwardSubstitute	(Control&,		   Context&,		 LoggerInterface* const)		{}
-	inline bool deepSubstitute			(Control& control, Context& context, LoggerInterface* const logger);
+	inline void deepForwardSubstitute	(Control&,		   Context&) HFSM_NOEXCEPT(true)	{}
+	inline bool deepSubstitute			(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+
+	inline void deepEnterInitial		(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+	inline void deepEnter				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+
+	inline bool deepUpdateAndTransition	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+	inline void deepUpdate				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
+
+	template <typename TEvent>
+	inline void deepReact				(TEvent& event,
+										 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+	inline void deepLeave				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+	inline void deepForwardRequest(const enum Transition::Type) HFSM_NOEXCEPT(true)			{}
+	inline void deepRequestRemain() HFSM_NOEXCEPT(true)										{}
+	inline void deepRequestRestart() HFSM_NOEXCEPT(true)									{}
+	inline void deepRequestResume() HFSM_NOEXCEPT(true)										{}
+	inline void deepChangeToRequested	(Control&,		   Context&) HFSM_NOEXCEPT(true)	{}
 
-	inline void deepEnterInitial		(				   Context& context, LoggerInterface* const logger);
-	inline void deepEnter				(				   Context& context, LoggerInterface* const logger);
+#ifdef HFSM_ENABLE_SCRATCH
+	// opted in with a ScratchT<> injection
+	using UsesScratch = std::is_base_of<Scratch, Head>;
 
-	inline bool deepUpdateAndTransition	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepUpdate				(				   Context& context, LoggerInterface* const logger);
+	inline void scratchEnter(Control& control, std::true_type)	HFSM_NOEXCEPT(true)	{ control.scratchEnter(StateID, head());	}
+	inline void scratchEnter(Control&,		   std::false_type)	HFSM_NOEXCEPT(true)	{}
 
+	inline void scratchLeave(Control& control, std::true_type)	HFSM_NOEXCEPT(true)	{ control.scratchLeave(head());			}
+	inline void scratchLeave(Control&,		   std::false_type)	HFSM_NOEXCEPT(true)	{}
+#endif
+
+#if defined HFSM_ENABLE_EVENT_STATS || defined HFSM_ENABLE_LOG_INTERFACE
+	// the default Base::react() returns Unhandled, overrides are picked ahead of it
 	template <typename TEvent>
-	inline void deepReact				(const TEvent& event,
-										 Control& control, Context& context, LoggerInterface* const logger);
+	struct Handles {
+		enum : bool {
+			Value = !std::is_same<decltype(std::declval<Head&>().react(std::declval<PassedEvent<Head, TEvent>>(),
+																		std::declval<Control&>(),
+																		std::declval<Context&>())),
+								  Unhandled>::value
+		};
+	};
+#endif
 
-	inline void deepLeave				(				   Context& context, LoggerInterface* const logger);
+	template <typename T>
+	static constexpr unsigned deepFind()							{ return std::is_same<T, Head>::value ? (unsigned) StateID : (unsigned) INVALID_STATE;	}
 
-	inline void deepForwardRequest(const enum Transition::Type)												{}
-	inline void deepRequestRemain()																			{}
-	inline void deepRequestRestart()																		{}
-	inline void deepRequestResume()																			{}
-	inline void deepChangeToRequested	(				   Context&,		 LoggerInterface* const)		{}
+	template <typename TLocation>
+	static constexpr void deepLocate(const unsigned, TLocation& location)	{ location.end = StateID + 1;	}
 
 #if defined HFSM_ENABLE_STRUCTURE_REPORT || defined HFSM_ENABLE_LOG_INTERFACE
 	static constexpr bool isBare()		{ return std::is_same<Head, Base>::value; }
@@ -1971,21 +4473,23 @@ struct M<TContext, TMaxSubstitutions>::_S {
 	};
 #endif
 
-#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-	static const char* name();
+	// bytes taken in each machine instance, 0 for the states that aren't stored
+	static constexpr unsigned footprint()	{ return std::is_empty<_S>::value ? 0 : sizeof(_S);				}
+
+	template <typename T>
+	static constexpr unsigned deepFootprint()						{ return std::is_same<T, Head>::value ? footprint() : 0;	}
 
-	void deepGetNames(const unsigned parent,
-					  const enum StateInfo::RegionType region,
-					  const unsigned depth,
-					  StateInfos& stateInfos) const;
+#ifdef HFSM_ENABLE_STRUCTURE_REPORT
+	static constexpr const char* name()		{ return isBare() ? "" : detail::TypeName<Head>::unqualified();	}
 
-	void deepIsActive(const bool isActive,
-					  unsigned& index,
-					  MachineStructure& structure) const;
+	static void deepGetNames(const unsigned parent,
+							 const enum StateInfo::RegionType region,
+							 const unsigned depth,
+							 StateInfos& stateInfos);
 #endif
 
 #ifdef HFSM_ENABLE_LOG_INTERFACE
-	static const char* fullName();
+	static constexpr const char* fullName()	{ return isBare() ? "" : detail::TypeName<Head>::qualified();	}
 
 	template <typename>
 	struct MemberTraits;
@@ -1995,20 +4499,41 @@ struct M<TContext, TMaxSubstitutions>::_S {
 		using State = TState;
 	};
 
-	template <typename TMethodType, LoggerInterface::Method>
-	typename std::enable_if< std::is_same<typename MemberTraits<TMethodType>::State, Base>::value>::type
+#ifdef __cpp_noexcept_function_type
+	template <typename TReturn, typename TState, typename... TArgs>
+	struct MemberTraits<TReturn(TState::*)(TArgs...) noexcept> {
+		using State = TState;
+	};
+#endif
+
+	// not inherited from Base
+	template <typename TMethodType>
+	struct Overridden {
+		enum : bool {
+			Value = !std::is_same<typename MemberTraits<TMethodType>::State, Base>::value
+		};
+	};
+
+	// overridden by the state, and selected by the log filter
+	template <bool TOverridden, LoggerInterface::Method TMethodId>
+	struct Logged {
+		enum : bool {
+			Value = TOverridden && TLogScope && TLogFilter::logs((unsigned) TMethodId)
+		};
+	};
+
+	template <bool TOverridden, LoggerInterface::Method TMethodId>
+	typename std::enable_if<!Logged<TOverridden, TMethodId>::Value>::type
 	log(LoggerInterface&) const {}
 
-	template <typename TMethodType, LoggerInterface::Method TMethodId>
-	typename std::enable_if<!std::is_same<typename MemberTraits<TMethodType>::State, Base>::value>::type
+	template <bool TOverridden, LoggerInterface::Method TMethodId>
+	typename std::enable_if< Logged<TOverridden, TMethodId>::Value>::type
 	log(LoggerInterface& logger) const {
-		logger.record(typeid(Head), fullName(), TMethodId, methodName(TMethodId));
+		logger.record(*TypeInfo::get<Head>(), fullName(), TMethodId, methodName(TMethodId));
 	}
 #endif
 
-	Head _head;
-
-	HSFM_IF_DEBUG(const TypeInfo _type = TypeInfo::get<Head>());
+	HSFM_IF_DEBUG_TYPES(const TypeInfo _type = TypeInfo::get<Head>());
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2019,228 +4544,177 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename TH>
-M<TC, TMS>::_S<TH>::_S(StateRegistry& stateRegistry,
-					   const Parent parent,
-					   Parents& stateParents,
-					   Parents& /*forkParents*/,
-					   ForkPointers& /*forkPointers*/)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::_S(StateRegistry& stateRegistry,
+									  const Parent parent,
+									  Parents& stateParents,
+									  Parents& /*forkParents*/,
+									  ForkPointers& /*forkPointers*/)
 {
 	const auto id = stateRegistry.add(TypeInfo::get<Head>());
+	assert(id == StateID);
+
 	stateParents[id] = parent;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 bool
-M<TC, TMS>::_S<TH>::deepSubstitute(Control& control,
-								   Context& context,
-								   LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepSubstitute(Control& control,
+												  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::substitute), LoggerInterface::Method::Substitute>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::substitute)>::Value, LoggerInterface::Method::Substitute>(*control._logger));
 
 	const unsigned requestCountBefore = control.requestCount();
 
-	_head.widePreSubstitute(context);
-	_head.substitute(control, context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreSubstitute(context);
+	head().substitute(control, context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Substitute, watch));
 
 	return requestCountBefore < control.requestCount();
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepEnterInitial(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepEnterInitial(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	deepEnter(context, logger);
+	deepEnter(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepEnter(Context& context,
-							  LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepEnter(Control& control,
+											 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::enter), LoggerInterface::Method::Enter>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::enter)>::Value, LoggerInterface::Method::Enter>(*control._logger));
+
+	HFSM_IF_STRUCTURE(control.notifyEnter(StateID));
+	HFSM_IF_WATCHDOG(control.watchEnter(StateID));
+	HFSM_IF_COVERAGE(control.coverEnter(StateID));
+	HFSM_IF_SCRATCH(scratchEnter(control, UsesScratch{}));
 
-	_head.widePreEnter(context);
-	_head.enter(context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreEnter(context);
+	head().enter(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Enter, watch));
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 bool
-M<TC, TMS>::_S<TH>::deepUpdateAndTransition(Control& control,
-											Context& context,
-											LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepUpdateAndTransition(Control& control,
+														   Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::update), LoggerInterface::Method::Update>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::update)>::Value, LoggerInterface::Method::Update>(*control._logger));
 
-	_head.widePreUpdate(context);
-	_head.update(context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreUpdate(context);
+	head().update(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Update, watch));
 
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::transition), LoggerInterface::Method::Transition>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::transition)>::Value, LoggerInterface::Method::Transition>(*control._logger));
 
 	const unsigned requestCountBefore = control.requestCount();
 
-	_head.widePreTransition(context);
-	_head.transition(control, context);
+	HFSM_IF_WATCHDOG(const auto transitionWatch = control.watchBegin());
+	head().widePreTransition(context);
+	head().transition(control, context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Transition, transitionWatch));
 
 	return requestCountBefore < control.requestCount();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepUpdate(Context& context,
-							   LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepUpdate(Control& control,
+											  Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::update), LoggerInterface::Method::Update>(*logger));
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::update)>::Value, LoggerInterface::Method::Update>(*control._logger));
 
-	_head.widePreUpdate(context);
-	_head.update(context);
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreUpdate(context);
+	head().update(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Update, watch));
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 template <typename TEvent>
 void
-M<TC, TMS>::_S<TH>::deepReact(const TEvent& event,
-							  Control& control,
-							  Context& context,
-							  LoggerInterface* const HFSM_IF_LOGGER(logger))
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepReact(TEvent& event,
+											 Control& control,
+											 Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::template react<TEvent>), LoggerInterface::Method::React>(*logger));
-
-	_head.widePreReact(event, context);
-	_head.react(event, control, context);
-}
-
-//------------------------------------------------------------------------------
-
-template <typename TC, unsigned TMS>
-template <typename TH>
-void
-M<TC, TMS>::_S<TH>::deepLeave(Context& context,
-							  LoggerInterface* const HFSM_IF_LOGGER(logger))
-{
-	HFSM_IF_LOGGER(if (logger) log<decltype(&Head::leave), LoggerInterface::Method::Leave>(*logger));
-
-	_head.leave(context);
-	_head.widePostLeave(context);
-}
-
-//------------------------------------------------------------------------------
-
-#ifdef HFSM_ENABLE_STRUCTURE_REPORT
-
-template <typename TC, unsigned TMS>
-template <typename TH>
-const char*
-M<TC, TMS>::_S<TH>::name() {
-	if (isBare())
-		return "";
-	else {
-		const char* const raw = TypeInfo::get<Head>()->name();
-
-	#if defined(_MSC_VER)
+	HFSM_IF_LOGGER(if (control._logger) log<Handles<TEvent>::Value, LoggerInterface::Method::React>(*control._logger));
 
-		unsigned first =
-			raw[0] == 's' ? 7 : // Struct
-			raw[0] == 'c' ? 6 : // Class
-							0;
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().widePreReact(event, context);
 
-		for (auto c = first; raw[c]; ++c)
-			if (raw[c] == ':')
-				first = c + 1;
+	// an rvalue for the react(TEvent&&) overloads, which take the event over
+	head().react(static_cast<PassedEvent<Head, TEvent>>(event), control, context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::React, watch));
 
-		return raw + first;
+	if (takesOver<Head, TEvent>(nullptr))
+		control.consume();
 
-	#elif defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
+	if (control._consumed && control._consumer == Reaction::NONE)
+		control._consumer = StateID;
 
-		return raw;
-
-	#else
-
-		return raw;
-
-	#endif
-	}
+	HFSM_IF_EVENT_STATS(control.countReact(Handles<TEvent>::Value));
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
 void
-M<TC, TMS>::_S<TH>::deepGetNames(const unsigned parent,
-								 const enum StateInfo::RegionType region,
-								 const unsigned depth,
-								 StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepLeave(Control& control,
+											 Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	_stateInfos << StateInfo { parent, region, depth, name() };
-}
+	HFSM_IF_LOGGER(if (control._logger) log<Overridden<decltype(&Head::leave)>::Value, LoggerInterface::Method::Leave>(*control._logger));
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	HFSM_IF_WATCHDOG(const auto watch = control.watchBegin());
+	head().leave(context);
+	head().widePostLeave(context);
+	HFSM_IF_WATCHDOG(control.watchEnd(StateID, Control::WatchCallback::Leave, watch));
 
-template <typename TC, unsigned TMS>
-template <typename TH>
-void
-M<TC, TMS>::_S<TH>::deepIsActive(const bool isActive,
-								 unsigned& index,
-								 MachineStructure& structure) const
-{
-	if (!isBare())
-		structure[index++].isActive = isActive;
-}
+	// released in bulk, after the state is done with it
+	HFSM_IF_SCRATCH(scratchLeave(control, UsesScratch{}));
 
-#endif
+	HFSM_IF_STRUCTURE(control.notifyLeave(StateID));
+}
 
 //------------------------------------------------------------------------------
 
-#ifdef HFSM_ENABLE_LOG_INTERFACE
-
-template <typename TC, unsigned TMS>
-template <typename TH>
-const char*
-M<TC, TMS>::_S<TH>::fullName() {
-	if (isBare())
-		return "";
-	else {
-		const char* const raw = TypeInfo::get<Head>()->name();
-
-	#if defined(_MSC_VER)
-
-		unsigned first =
-			raw[0] == 's' ? 7 : // Struct
-			raw[0] == 'c' ? 6 : // Class
-							0;
-		return raw + first;
-
-	#elif defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
-
-		return raw;
-
-	#else
-
-		return raw;
+#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-	#endif
-	}
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH>
+void
+M<TC, TMS, TLF>::_S<TID, TLS, TH>::deepGetNames(const unsigned parent,
+												const enum StateInfo::RegionType region,
+												const unsigned depth,
+												StateInfos& _stateInfos)
+{
+	_stateInfos << StateInfo { parent, region, depth, name(), footprint() };
 }
 
 #endif
@@ -2252,24 +4726,28 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContext, unsigned TMaxSubstitutions>
-template <typename TH, typename... TS>
-struct M<TContext, TMaxSubstitutions>::_C final {
+template <typename TContext, unsigned TMaxSubstitutions, typename TLogFilter>
+template <unsigned TStateID, bool TLogScope, typename TH, typename... TS>
+struct M<TContext, TMaxSubstitutions, TLogFilter>::_C final {
 	using Head	= TH;
 	using Fork	= ForkT<Head>;
-	using State	= _S<Head>;
+	using State	= _S<TStateID, TLogScope, Head>;
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename...>
+	template <unsigned TInitialID, unsigned TN, typename...>
 	struct Sub;
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename TI, typename... TR>
-	struct Sub<TN, TI, TR...> {
-		using Initial = typename WrapState<TI>::Type;
-		using Remaining = Sub<TN + 1, TR...>;
+	// the prongs held as bases, where the empty ones take no room
+	template <unsigned TInitialID, unsigned TN, typename TI, typename... TR>
+	struct HFSM_EMPTY_BASES Sub<TInitialID, TN, TI, TR...>
+		: detail::Compact<typename WrapState<TInitialID, TLogScope, TI>::Type>
+		, detail::Compact<Sub<TInitialID + WrapState<TInitialID, TLogScope, TI>::Type::StateCount, TN + 1, TR...>>
+	{
+		using Initial = typename WrapState<TInitialID, TLogScope, TI>::Type;
+		using Remaining = Sub<TInitialID + Initial::StateCount, TN + 1, TR...>;
 
 		enum : unsigned {
 			ProngIndex	 = TN,
@@ -2280,56 +4758,102 @@ struct M<TContext, TMaxSubstitutions>::_C final {
 			ProngCount	 = Initial::ProngCount + Remaining::ProngCount,
 		};
 
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptSubstitute			 = Initial::NoexceptSubstitute && Remaining::NoexceptSubstitute,
+			NoexceptEnter				 = Initial::NoexceptEnter && Remaining::NoexceptEnter,
+			NoexceptUpdate				 = Initial::NoexceptUpdate && Remaining::NoexceptUpdate,
+			NoexceptUpdateAndTransition	 = Initial::NoexceptUpdateAndTransition && Remaining::NoexceptUpdateAndTransition,
+			NoexceptLeave				 = Initial::NoexceptLeave && Remaining::NoexceptLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Initial::template NoexceptReact<TEvent>::Value &&
+						Remaining::template NoexceptReact<TEvent>::Value
+			};
+		};
+	#endif
+
 		Sub(StateRegistry& stateRegistry,
 			const Index fork,
 			Parents& stateParents,
 			Parents& forkParents,
 			ForkPointers& forkPointers);
 
-		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideEnterInitial		(										 Context& context, LoggerInterface* const logger);
-		inline void wideEnter				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline void wideEnterInitial		(					   Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+		inline void wideEnter				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideUpdate				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+		inline void wideUpdate				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 		template <typename TEvent>
 		inline void wideReact				(const unsigned prong,
-											 const TEvent& event,  Control& control, Context& context, LoggerInterface* const logger);
+											 TEvent& event,  Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+		inline void wideLeave				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+		inline void wideRequestRemain() HFSM_NOEXCEPT(true);
+		inline void wideRequestRestart() HFSM_NOEXCEPT(true);
+		inline void wideRequestResume(const unsigned prong) HFSM_NOEXCEPT(true);
+		inline void wideChangeToRequested	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+		template <typename T>
+		static constexpr unsigned wideFind() {
+			return Initial::template deepFind<T>() != INVALID_STATE ?
+				   Initial::template deepFind<T>() : Remaining::template wideFind<T>();
+		}
+
+		template <typename T>
+		static constexpr unsigned wideFootprint() {
+			return Initial::template deepFind<T>() != INVALID_STATE ?
+				   Initial::template deepFootprint<T>() : Remaining::template wideFootprint<T>();
+		}
 
-		inline void wideLeave				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		// forks: the id the next fork down the hierarchy gets
+		template <typename TLocation>
+		static constexpr void wideLocate(const unsigned fork, const unsigned forks, TLocation& location) {
+			if (location.state < TInitialID + Initial::StateCount) {
+				location.path.steps[location.path.count].fork  = fork;
+				location.path.steps[location.path.count].prong = ProngIndex;
+				++location.path.count;
+
+				Initial::deepLocate(forks, location);
+			} else
+				Remaining::wideLocate(fork, forks + Initial::ForkCount, location);
+		}
 
-		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition);
-		inline void wideRequestRemain();
-		inline void wideRequestRestart();
-		inline void wideRequestResume(const unsigned prong);
-		inline void wideChangeToRequested	(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+	#ifdef HFSM_ENABLE_COVERAGE
+		// the state heading the prong
+		static constexpr unsigned prongState(const unsigned prong)	{ return prong == ProngIndex ? TInitialID : Remaining::prongState(prong);	}
+	#endif
 
 	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 		enum : unsigned {
 			NameCount	 = Initial::NameCount  + Remaining::NameCount,
 		};
 
-		void wideGetNames(const unsigned parent,
-						  const unsigned depth,
-						  StateInfos& stateInfos) const;
-
-		void wideIsActive(const unsigned prong,
-						  unsigned& index,
-						  MachineStructure& structure) const;
+		static void wideGetNames(const unsigned parent,
+								 const unsigned depth,
+								 StateInfos& stateInfos);
 	#endif
 
-		Initial initial;
-		Remaining remaining;
+		inline Initial&	  initial()		HFSM_NOEXCEPT(true)	{ return detail::Compact<Initial  >::get();	}
+		inline Remaining& remaining()	HFSM_NOEXCEPT(true)	{ return detail::Compact<Remaining>::get();	}
 	};
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename TI>
-	struct Sub<TN, TI> {
-		using Initial = typename WrapState<TI>::Type;
+	template <unsigned TInitialID, unsigned TN, typename TI>
+	struct Sub<TInitialID, TN, TI>
+		: detail::Compact<typename WrapState<TInitialID, TLogScope, TI>::Type>
+	{
+		using Initial = typename WrapState<TInitialID, TLogScope, TI>::Type;
 
 		enum : unsigned {
 			ProngIndex	 = TN,
@@ -2340,55 +4864,89 @@ struct M<TContext, TMaxSubstitutions>::_C final {
 			ProngCount	 = Initial::ProngCount,
 		};
 
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptSubstitute			 = Initial::NoexceptSubstitute,
+			NoexceptEnter				 = Initial::NoexceptEnter,
+			NoexceptUpdate				 = Initial::NoexceptUpdate,
+			NoexceptUpdateAndTransition	 = Initial::NoexceptUpdateAndTransition,
+			NoexceptLeave				 = Initial::NoexceptLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Initial::template NoexceptReact<TEvent>::Value
+			};
+		};
+	#endif
+
 		Sub(StateRegistry& stateRegistry,
 			const Index fork,
 			Parents& stateParents,
 			Parents& forkParents,
 			ForkPointers& forkPointers);
 
-		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideForwardSubstitute	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+		inline void wideSubstitute			(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideEnterInitial		(										 Context& context, LoggerInterface* const logger);
-		inline void wideEnter				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline void wideEnterInitial		(					   Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+		inline void wideEnter				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideUpdate				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+		inline bool wideUpdateAndTransition	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+		inline void wideUpdate				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 		template <typename TEvent>
-		inline void wideReact				(const unsigned prong, const TEvent& event,
-																   Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideReact				(const unsigned prong, TEvent& event,
+																   Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+		inline void wideLeave				(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+		inline void wideRequestRemain() HFSM_NOEXCEPT(true);
+		inline void wideRequestRestart() HFSM_NOEXCEPT(true);
+		inline void wideRequestResume(const unsigned prong) HFSM_NOEXCEPT(true);
+		inline void wideChangeToRequested	(const unsigned prong, Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+		template <typename T>
+		static constexpr unsigned wideFind()								{ return Initial::template deepFind<T>();	}
+
+		template <typename T>
+		static constexpr unsigned wideFootprint()							{ return Initial::template deepFootprint<T>();	}
+
+		template <typename TLocation>
+		static constexpr void wideLocate(const unsigned fork, const unsigned forks, TLocation& location) {
+			location.path.steps[location.path.count].fork  = fork;
+			location.path.steps[location.path.count].prong = ProngIndex;
+			++location.path.count;
 
-		inline void wideLeave				(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+			Initial::deepLocate(forks, location);
+		}
 
-		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition);
-		inline void wideRequestRemain();
-		inline void wideRequestRestart();
-		inline void wideRequestResume(const unsigned prong);
-		inline void wideChangeToRequested	(const unsigned prong,					 Context& context, LoggerInterface* const logger);
+	#ifdef HFSM_ENABLE_COVERAGE
+		static constexpr unsigned prongState(const unsigned)			{ return TInitialID;	}
+	#endif
 
 	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 		enum : unsigned {
 			NameCount	 = Initial::NameCount,
 		};
 
-		void wideGetNames(const unsigned parent,
-						  const unsigned depth,
-						  StateInfos& stateInfos) const;
-
-		void wideIsActive(const unsigned prong,
-						  unsigned& index,
-						  MachineStructure& structure) const;
+		static void wideGetNames(const unsigned parent,
+								 const unsigned depth,
+								 StateInfos& stateInfos);
 	#endif
 
-		Initial initial;
+		inline Initial&	  initial()		HFSM_NOEXCEPT(true)	{ return detail::Compact<Initial>::get();	}
 	};
 
-	using SubStates = Sub<0, TS...>;
+	using SubStates = Sub<TStateID + 1, 0, TS...>;
 
 	//----------------------------------------------------------------------
 
 	enum : unsigned {
+		StateID		 = TStateID,
+
 		ReverseDepth = SubStates::ReverseDepth + 1,
 		DeepWidth	 = SubStates::DeepWidth,
 		StateCount	 = State::StateCount + SubStates::StateCount,
@@ -2397,52 +4955,116 @@ struct M<TContext, TMaxSubstitutions>::_C final {
 		Width		 = sizeof...(TS),
 	};
 
+	enum : bool {
+		RecordsHistory = historyOf<Head>(nullptr) != History::None,
+		DeepHistory	   = historyOf<Head>(nullptr) == History::Deep,
+	};
+
+#ifdef HFSM_ENABLE_NOEXCEPT
+	enum : bool {
+		NoexceptSubstitute			 = State::NoexceptSubstitute && SubStates::NoexceptSubstitute,
+		NoexceptEnter				 = State::NoexceptEnter && SubStates::NoexceptEnter,
+		NoexceptUpdate				 = State::NoexceptUpdate && SubStates::NoexceptUpdate,
+		NoexceptUpdateAndTransition	 = State::NoexceptUpdateAndTransition && SubStates::NoexceptUpdateAndTransition,
+		NoexceptLeave				 = State::NoexceptLeave && SubStates::NoexceptLeave,
+	};
+
+	template <typename TEvent>
+	struct NoexceptReact {
+		enum : bool {
+			Value = State::template NoexceptReact<TEvent>::Value &&
+					SubStates::template NoexceptReact<TEvent>::Value
+		};
+	};
+#endif
+
 	_C(StateRegistry& stateRegistry,
 	   const Parent parent,
 	   Parents& stateParents,
 	   Parents& forkParents,
 	   ForkPointers& forkPointers);
 
-	inline void deepForwardSubstitute	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepSubstitute			(Control& control, Context& context, LoggerInterface* const logger);
+	inline void deepForwardSubstitute	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+	inline void deepSubstitute			(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-	inline void deepEnterInitial		(				   Context& context, LoggerInterface* const logger);
-	inline void deepEnter				(				   Context& context, LoggerInterface* const logger);
+	inline void deepEnterInitial		(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+	inline void deepEnter				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-	inline bool deepUpdateAndTransition	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepUpdate				(				   Context& context, LoggerInterface* const logger);
+	inline bool deepUpdateAndTransition	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+	inline void deepUpdate				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 	template <typename TEvent>
-	inline void deepReact				(const TEvent& event,
-										 Control& control, Context& context, LoggerInterface* const logger);
+	inline void deepReact				(TEvent& event,
+										 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+	inline void deepLeave				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+	inline void deepForwardRequest(const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+	inline void deepRequestRemain() HFSM_NOEXCEPT(true);
+	inline void deepRequestRestart() HFSM_NOEXCEPT(true);
+	inline void deepRequestResume() HFSM_NOEXCEPT(true);
+	inline void deepChangeToRequested	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
 
-	inline void deepLeave				(				   Context& context, LoggerInterface* const logger);
+	// compile-time topology, see _R::locate()
+	template <typename T>
+	static constexpr unsigned deepFind() {
+		return std::is_same<T, Head>::value ? (unsigned) StateID : SubStates::template wideFind<T>();
+	}
+
+	// bytes taken in each machine instance, by the fork and the stored states of the subtree
+	static constexpr unsigned footprint()	{ return sizeof(_C);	}
+
+	template <typename T>
+	static constexpr unsigned deepFootprint() {
+		return std::is_same<T, Head>::value ? footprint() : SubStates::template wideFootprint<T>();
+	}
 
-	inline void deepForwardRequest(const enum Transition::Type transition);
-	inline void deepRequestRemain();
-	inline void deepRequestRestart();
-	inline void deepRequestResume();
-	inline void deepChangeToRequested	(				   Context& context, LoggerInterface* const logger);
+	// fork: the id the region's own fork gets, in pre-order
+	template <typename TLocation>
+	static constexpr void deepLocate(const unsigned fork, TLocation& location) {
+		if (location.state == StateID)
+			location.end = StateID + StateCount;
+		else {
+			location.parent = StateID;
+			SubStates::wideLocate(fork, fork + 1, location);
+		}
+	}
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 	enum : unsigned {
 		NameCount	 = State::NameCount  + SubStates::NameCount,
 	};
 
-	void deepGetNames(const unsigned parent,
-					  const enum StateInfo::RegionType region,
-					  const unsigned depth,
-					  StateInfos& stateInfos) const;
-
-	void deepIsActive(const bool isActive,
-					  unsigned& index,
-					  MachineStructure& structure) const;
+	static void deepGetNames(const unsigned parent,
+							 const enum StateInfo::RegionType region,
+							 const unsigned depth,
+							 StateInfos& stateInfos);
 #endif
-	Fork _fork;
-	State _state;
-	SubStates _subStates;
+	// the fork first, constructed (and so registered) ahead of the sub-states' own;
+	// the state and the sub-states held as bases, where the empty ones take no room
+	struct HFSM_EMPTY_BASES Nodes
+		: Fork
+		, detail::Compact<State>
+		, detail::Compact<SubStates>
+	{
+		Nodes(StateRegistry& stateRegistry,
+			  const Parent parent,
+			  Parents& stateParents,
+			  Parents& forkParents,
+			  ForkPointers& forkPointers)
+			: Fork(parent, forkParents, forkPointers)
+			, detail::Compact<State>(stateRegistry, parent, stateParents, forkParents, forkPointers)
+			, detail::Compact<SubStates>(stateRegistry, Fork::self, stateParents, forkParents, forkPointers)
+		{}
+	};
+
+	inline Fork&	  fork()		HFSM_NOEXCEPT(true)	{ return _nodes;												}
+	inline State&	  state()		HFSM_NOEXCEPT(true)	{ return static_cast<detail::Compact<State>&>(_nodes).get();		}
+	inline SubStates& subStates()	HFSM_NOEXCEPT(true)	{ return static_cast<detail::Compact<SubStates>&>(_nodes).get();	}
 
-	HSFM_IF_DEBUG(const TypeInfo _type = TypeInfo::get<Head>());
+	Nodes _nodes;
+
+	HSFM_IF_DEBUG_TYPES(const TypeInfo _type = TypeInfo::get<Head>());
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2453,169 +5075,178 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-M<TC, TMS>::_C<TH, TS...>::_C(StateRegistry& stateRegistry,
-							  const Parent parent,
-							  Parents& stateParents,
-							  Parents& forkParents,
-							  ForkPointers& forkPointers)
-	: _fork(static_cast<Index>(forkPointers << &_fork), parent, forkParents)
-	, _state(stateRegistry, parent, stateParents, forkParents, forkPointers)
-	, _subStates(stateRegistry, _fork.self, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::_C(StateRegistry& stateRegistry,
+											 const Parent parent,
+											 Parents& stateParents,
+											 Parents& forkParents,
+											 ForkPointers& forkPointers)
+	: _nodes(stateRegistry, parent, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepForwardSubstitute(Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepForwardSubstitute(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.requested != INVALID_INDEX);
+	assert(fork().requested != INVALID_INDEX);
 
-	if (_fork.requested == _fork.active)
-		_subStates.wideForwardSubstitute(_fork.requested, control, context, logger);
+	if (fork().requested == fork().active)
+		subStates().wideForwardSubstitute(fork().requested, control, context);
 	else
-		_subStates.wideSubstitute		(_fork.requested, control, context, logger);
+		subStates().wideSubstitute		 (fork().requested, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepSubstitute(Control& control,
-										  Context& context,
-										  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepSubstitute(Control& control,
+														 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.requested != INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().requested != INVALID_INDEX);
 
-	if (!_state	  .deepSubstitute(				   control, context, logger))
-		_subStates.wideSubstitute(_fork.requested, control, context, logger);
+	if (!state()   .deepSubstitute(				   control, context))
+		subStates().wideSubstitute(fork().requested, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepEnterInitial(Context& context,
-											LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepEnterInitial(Control& control,
+														   Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX &&
-		   _fork.requested == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX &&
+		   fork().requested == INVALID_INDEX);
 
-	HSFM_IF_DEBUG(_fork.activeType = TypeInfo::get<typename SubStates::Initial::Head>());
-	_fork.active = 0;
+	HSFM_IF_DEBUG_TYPES(fork().activeType = TypeInfo::get<typename SubStates::Initial::Head>());
+	fork().active = 0;
 
-	_state	  .deepEnter	   (context, logger);
-	_subStates.wideEnterInitial(context, logger);
+	state()	   .deepEnter	   (control, context);
+	subStates().wideEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepEnter(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepEnter(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active	   == INVALID_INDEX &&
-		   _fork.requested != INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().requested != INVALID_INDEX);
 
-	HSFM_IF_DEBUG(_fork.activeType = _fork.requestedType);
-	_fork.active = _fork.requested;
+	HSFM_IF_DEBUG_TYPES(fork().activeType = fork().requestedType);
+	fork().active = fork().requested;
 
-	HSFM_IF_DEBUG(_fork.requestedType.clear());
-	_fork.requested = INVALID_INDEX;
+	HSFM_IF_DEBUG_TYPES(fork().requestedType.clear());
+	fork().requested = INVALID_INDEX;
 
-	_state	  .deepEnter(			   context, logger);
-	_subStates.wideEnter(_fork.active, context, logger);
+	state()	   .deepEnter(			   control, context);
+	subStates().wideEnter(fork().active, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 bool
-M<TC, TMS>::_C<TH, TS...>::deepUpdateAndTransition(Control& control,
-												   Context& context,
-												   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepUpdateAndTransition(Control& control,
+																  Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
+
+	const unsigned requestCountBefore = control.requestCount();
 
-	if (_state.deepUpdateAndTransition(control, context, logger)) {
-		_subStates.wideUpdate(_fork.active, context, logger);
+	if (state().deepUpdateAndTransition(control, context)) {
+		if (!skipsObsoleteUpdates<Head>(nullptr) ||
+			!control.leaves(requestCountBefore, StateRange{StateID, StateID + StateCount}))
+			subStates().wideUpdate(fork().active, control, context);
 
 		return true;
 	} else
-		return _subStates.wideUpdateAndTransition(_fork.active, control, context, logger);
+		return subStates().wideUpdateAndTransition(fork().active, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepUpdate(Context& context,
-									  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepUpdate(Control& control,
+													 Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
 
-	_state	  .deepUpdate(				context, logger);
-	_subStates.wideUpdate(_fork.active, context, logger);
+	state()	   .deepUpdate(				control, context);
+	subStates().wideUpdate(fork().active, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 template <typename TEvent>
 void
-M<TC, TMS>::_C<TH, TS...>::deepReact(const TEvent& event,
-									 Control& control,
-									 Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepReact(TEvent& event,
+													Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
+
+	if (control.leafFirst()) {
+		subStates().wideReact(fork().active, event, control, context);
 
-	_state	  .deepReact(			   event, control, context, logger);
-	_subStates.wideReact(_fork.active, event, control, context, logger);
+		if (!control._consumed)
+			state().deepReact(event, control, context);
+	} else {
+		state().deepReact(event, control, context);
+
+		if (!control._consumed)
+			subStates().wideReact(fork().active, event, control, context);
+	}
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepLeave(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepLeave(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
 
-	_subStates.wideLeave(_fork.active, context, logger);
-	_state	  .deepLeave(			   context, logger);
+	subStates().wideLeave(fork().active, control, context);
+	state()	   .deepLeave(			   control, context);
 
-	HSFM_IF_DEBUG(_fork.resumableType = _fork.activeType);
-	_fork.resumable = _fork.active;
+	if (RecordsHistory) {
+		HSFM_IF_DEBUG_TYPES(fork().resumableType = fork().activeType);
+		fork().resumable = fork().active;
+	}
 
-	HSFM_IF_DEBUG(_fork.activeType.clear());
-	_fork.active = INVALID_INDEX;
+	HSFM_IF_DEBUG_TYPES(fork().activeType.clear());
+	fork().active = INVALID_INDEX;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepForwardRequest(const enum Transition::Type transition) {
-	if (_fork.requested != INVALID_INDEX)
-		_subStates.wideForwardRequest(_fork.requested, transition);
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepForwardRequest(const enum Transition::Type transition) HFSM_NOEXCEPT(true) {
+	if (fork().requested != INVALID_INDEX)
+		subStates().wideForwardRequest(fork().requested, transition);
 	else
 		switch (transition) {
 		case Transition::Remain:
@@ -2637,72 +5268,85 @@ M<TC, TMS>::_C<TH, TS...>::deepForwardRequest(const enum Transition::Type transi
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepRequestRemain() {
-	if (_fork.active == INVALID_INDEX) {
-		HSFM_IF_DEBUG(_fork.requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
-		_fork.requested = 0;
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepRequestRemain() HFSM_NOEXCEPT(true) {
+	if (fork().active == INVALID_INDEX) {
+		HSFM_IF_DEBUG_TYPES(fork().requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
+		fork().requested = 0;
 	}
 
-	_subStates.wideRequestRemain();
+	subStates().wideRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepRequestRestart() {
-	HSFM_IF_DEBUG(_fork.requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
-	_fork.requested = 0;
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepRequestRestart() HFSM_NOEXCEPT(true) {
+	HSFM_IF_DEBUG_TYPES(fork().requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
+	fork().requested = 0;
 
-	_subStates.wideRequestRestart();
+	subStates().wideRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepRequestResume() {
-	if (_fork.resumable != INVALID_INDEX) {
-		HSFM_IF_DEBUG(_fork.requestedType = _fork.resumableType);
-		_fork.requested = _fork.resumable;
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepRequestResume() HFSM_NOEXCEPT(true) {
+	if (fork().resumable != INVALID_INDEX) {
+		HSFM_IF_DEBUG_TYPES(fork().requestedType = fork().resumableType);
+		fork().requested = fork().resumable;
+
+		// without history, a schedule()-d prong is good for a single resume()
+		if (!RecordsHistory) {
+			HSFM_IF_DEBUG_TYPES(fork().resumableType = TypeInfo());
+			fork().resumable = INVALID_INDEX;
+		}
 	} else {
-		HSFM_IF_DEBUG(_fork.requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
-		_fork.requested = 0;
+		HSFM_IF_DEBUG_TYPES(fork().requestedType = TypeInfo::get<typename SubStates::Initial::Head>());
+		fork().requested = 0;
 	}
 
-	_subStates.wideRequestResume(_fork.requested);
+	if (DeepHistory)
+		subStates().wideRequestResume(fork().requested);
+	else
+		subStates().wideForwardRequest(fork().requested, Transition::Restart);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepChangeToRequested(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepChangeToRequested(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	assert(_fork.active != INVALID_INDEX);
+	assert(fork().active != INVALID_INDEX);
 
-	if (_fork.requested == _fork.active)
-		_subStates.wideChangeToRequested(_fork.requested, context, logger);
-	else if (_fork.requested != INVALID_INDEX) {
-		_subStates.wideLeave(_fork.active, context, logger);
+	if (fork().requested == fork().active)
+		subStates().wideChangeToRequested(fork().requested, control, context);
+	else if (fork().requested != INVALID_INDEX) {
+		subStates().wideLeave(fork().active, control, context);
+
+		if (RecordsHistory) {
+			HSFM_IF_DEBUG_TYPES(fork().resumableType = fork().activeType);
+			fork().resumable = fork().active;
+		}
 
-		HSFM_IF_DEBUG(_fork.resumableType = _fork.activeType);
-		_fork.resumable = _fork.active;
+		HSFM_IF_DEBUG_TYPES(fork().activeType = fork().requestedType);
+		fork().active = fork().requested;
 
-		HSFM_IF_DEBUG(_fork.activeType = _fork.requestedType);
-		_fork.active = _fork.requested;
+		HSFM_IF_DEBUG_TYPES(fork().requestedType.clear());
+		fork().requested = INVALID_INDEX;
 
-		HSFM_IF_DEBUG(_fork.requestedType.clear());
-		_fork.requested = INVALID_INDEX;
+		HFSM_IF_COVERAGE(control.coverSwitch(SubStates::prongState(fork().active)));
 
-		_subStates.wideEnter(_fork.active, context, logger);
+		subStates().wideEnter(fork().active, control, context);
 	}
 }
 
@@ -2710,31 +5354,21 @@ M<TC, TMS>::_C<TH, TS...>::deepChangeToRequested(Context& context,
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_C<TH, TS...>::deepGetNames(const unsigned parent,
-										const enum StateInfo::RegionType region,
-										const unsigned depth,
-										StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_C<TID, TLS, TH, TS...>::deepGetNames(const unsigned parent,
+													   const enum StateInfo::RegionType region,
+													   const unsigned depth,
+													   StateInfos& _stateInfos)
 {
-	_state.deepGetNames(parent, region, depth, _stateInfos);
-	_subStates.wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	State::deepGetNames(parent, region, depth, _stateInfos);
+	_stateInfos[_stateInfos.count() - 1].footprint = footprint();
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-void
-M<TC, TMS>::_C<TH, TS...>::deepIsActive(const bool isActive,
-										unsigned& index,
-										MachineStructure& structure) const
-{
-	_state.deepIsActive(isActive, index, structure);
-	_subStates.wideIsActive(isActive ? _fork.active : INVALID_INDEX, index, structure);
+	SubStates::wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
 }
 
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2744,247 +5378,230 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
-												  const Index fork,
-												  Parents& stateParents,
-												  Parents& forkParents,
-												  ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
-	, remaining(stateRegistry, fork, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
+																	   const Index fork,
+																	   Parents& stateParents,
+																	   Parents& forkParents,
+																	   ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
+	, detail::Compact<Remaining>(stateRegistry, fork, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
-																	Control& control,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
+																						 Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	if (prong == ProngIndex)
-		initial  .deepForwardSubstitute(	   control, context, logger);
+		initial()  .deepForwardSubstitute(	   control, context);
 	else
-		remaining.wideForwardSubstitute(prong, control, context, logger);
+		remaining().wideForwardSubstitute(prong, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideSubstitute(const unsigned prong,
-															 Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideSubstitute(const unsigned prong,
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	if (prong == ProngIndex)
-		initial  .deepSubstitute(		control, context, logger);
+		initial()  .deepSubstitute(		control, context);
 	else
-		remaining.wideSubstitute(prong, control, context, logger);
+		remaining().wideSubstitute(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideEnterInitial(Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnterInitial(Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnterInitial(context, logger);
+	initial().deepEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideEnter(const unsigned prong,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnter(const unsigned prong,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
 	if (prong == ProngIndex)
-		initial  .deepEnter(	   context, logger);
+		initial()  .deepEnter(	   control, context);
 	else
-		remaining.wideEnter(prong, context, logger);
+		remaining().wideEnter(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 bool
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideUpdateAndTransition(const unsigned prong,
-																	  Control& control,
-																	  Context& context,
-																	  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdateAndTransition(const unsigned prong,
+																						   Control& control,
+																						   Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
 	return prong == ProngIndex ?
-		initial  .deepUpdateAndTransition(		 control, context, logger) :
-		remaining.wideUpdateAndTransition(prong, control, context, logger);
+		initial()  .deepUpdateAndTransition(		 control, context) :
+		remaining().wideUpdateAndTransition(prong, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideUpdate(const unsigned prong,
-														 Context& context,
-														 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdate(const unsigned prong,
+																			  Control& control,
+																			  Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
 	if (prong == ProngIndex)
-		initial  .deepUpdate(		context, logger);
+		initial()  .deepUpdate(		control, context);
 	else
-		remaining.wideUpdate(prong, context, logger);
+		remaining().wideUpdate(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 template <typename TEvent>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideReact(const unsigned prong,
-														const TEvent& event,
-														Control& control,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideReact(const unsigned prong,
+																			 TEvent& event,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
 	if (prong == ProngIndex)
-		initial  .deepReact(	   event, control, context, logger);
+		initial()  .deepReact(	   event, control, context);
 	else
-		remaining.wideReact(prong, event, control, context, logger);
+		remaining().wideReact(prong, event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideLeave(const unsigned prong,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideLeave(const unsigned prong,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
 	if (prong == ProngIndex)
-		initial  .deepLeave(	   context, logger);
+		initial()  .deepLeave(	   control, context);
 	else
-		remaining.wideLeave(prong, context, logger);
+		remaining().wideLeave(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideForwardRequest(const unsigned prong,
-																 const enum Transition::Type transition)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardRequest(const unsigned prong,
+																					  const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	if (prong == ProngIndex)
-		initial	 .deepForwardRequest(		transition);
+		initial()  .deepForwardRequest(		transition);
 	else
-		remaining.wideForwardRequest(prong, transition);
+		remaining().wideForwardRequest(prong, transition);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideRequestRemain() {
-	initial.deepRequestRemain();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideRequestRestart() {
-	initial.deepRequestRestart();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideRequestResume(const unsigned prong) {
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestResume(const unsigned prong) HFSM_NOEXCEPT(true) {
 	if (prong == ProngIndex)
-		initial.deepRequestResume();
+		initial().deepRequestResume();
 	else
-		remaining.wideRequestResume(prong);
+		remaining().wideRequestResume(prong);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideChangeToRequested(const unsigned prong,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideChangeToRequested(const unsigned prong,
+																						 Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
 	if (prong == ProngIndex)
-		initial	 .deepChangeToRequested(	   context, logger);
+		initial()  .deepChangeToRequested(	   control, context);
 	else
-		remaining.wideChangeToRequested(prong, context, logger);
+		remaining().wideChangeToRequested(prong, control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideGetNames(const unsigned parent,
-														   const unsigned depth,
-														   StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideGetNames(const unsigned parent,
+																				const unsigned depth,
+																				StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
-	remaining.wideGetNames(parent, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
+	Remaining::wideGetNames(parent, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI, TR...>::wideIsActive(const unsigned prong,
-														   unsigned& index,
-														   MachineStructure& structure) const
-{
-	initial.deepIsActive(prong == ProngIndex, index, structure);
-	remaining.wideIsActive(prong, index, structure);
-}
 
 #endif
 
@@ -2995,235 +5612,219 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::Sub(StateRegistry& stateRegistry,
-										   const Index fork,
-										   Parents& stateParents,
-										   Parents& forkParents,
-										   ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::Sub(StateRegistry& stateRegistry,
+																const Index fork,
+																Parents& stateParents,
+																Parents& forkParents,
+																ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
-															 Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepForwardSubstitute(control, context, logger);
+	initial().deepForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideSubstitute(const unsigned HSFM_IF_ASSERT(prong),
-													  Control& control,
-													  Context& context,
-													  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideSubstitute(const unsigned HSFM_IF_ASSERT(prong),
+																		   Control& control,
+																		   Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepSubstitute(control, context, logger);
+	initial().deepSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideEnterInitial(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnterInitial(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnterInitial(context, logger);
+	initial().deepEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideEnter(const unsigned HSFM_IF_ASSERT(prong),
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnter(const unsigned HSFM_IF_ASSERT(prong),
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepEnter(context, logger);
+	initial().deepEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 bool
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideUpdateAndTransition(const unsigned HSFM_IF_ASSERT(prong),
-															   Control& control,
-															   Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdateAndTransition(const unsigned HSFM_IF_ASSERT(prong),
+																					Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
 	assert(prong == ProngIndex);
 
-	return initial.deepUpdateAndTransition(control, context, logger);
+	return initial().deepUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideUpdate(const unsigned HSFM_IF_ASSERT(prong),
-												  Context& context,
-												  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdate(const unsigned HSFM_IF_ASSERT(prong),
+																	   Control& control,
+																	   Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepUpdate(context, logger);
+	initial().deepUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 template <typename TEvent>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideReact(const unsigned HSFM_IF_ASSERT(prong),
-												 const TEvent& event,
-												 Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideReact(const unsigned HSFM_IF_ASSERT(prong),
+																	  TEvent& event,
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepReact(event, control, context, logger);
+	initial().deepReact(event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideLeave(const unsigned HSFM_IF_ASSERT(prong),
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideLeave(const unsigned HSFM_IF_ASSERT(prong),
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepLeave(context, logger);
+	initial().deepLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideForwardRequest(const unsigned HSFM_IF_ASSERT(prong),
-														  const enum Transition::Type transition)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardRequest(const unsigned HSFM_IF_ASSERT(prong),
+																			   const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepForwardRequest(transition);
+	initial().deepForwardRequest(transition);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideRequestRemain() {
-	initial.deepRequestRemain();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideRequestRestart() {
-	initial.deepRequestRestart();
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideRequestResume(const unsigned HSFM_IF_ASSERT(prong)) {
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestResume(const unsigned HSFM_IF_ASSERT(prong)) HFSM_NOEXCEPT(true) {
 	assert(prong == ProngIndex);
 
-	initial.deepRequestResume();
+	initial().deepRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideChangeToRequested(const unsigned HSFM_IF_ASSERT(prong),
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideChangeToRequested(const unsigned HSFM_IF_ASSERT(prong),
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepChangeToRequested(context, logger);
+	initial().deepChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideGetNames(const unsigned parent,
-													const unsigned depth,
-													StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_C<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideGetNames(const unsigned parent,
+																		 const unsigned depth,
+																		 StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Composite, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-void
-M<TC, TMS>::_C<T, TS...>::Sub<TN, TI>::wideIsActive(const unsigned prong,
-													unsigned& index,
-													MachineStructure& structure) const
-{
-	initial.deepIsActive(prong == ProngIndex, index, structure);
-}
 
 #endif
 
@@ -3234,24 +5835,28 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TContext, unsigned TMaxSubstitutions>
-template <typename TH, typename... TS>
-struct M<TContext, TMaxSubstitutions>::_O final {
+template <typename TContext, unsigned TMaxSubstitutions, typename TLogFilter>
+template <unsigned TStateID, bool TLogScope, typename TH, typename... TS>
+struct M<TContext, TMaxSubstitutions, TLogFilter>::_O final {
 	using Head	= TH;
 	using Fork	= ForkT<Head>;
-	using State	= _S<Head>;
+	using State	= _S<TStateID, TLogScope, Head>;
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename...>
+	template <unsigned TInitialID, unsigned TN, typename...>
 	struct Sub;
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename TI, typename... TR>
-	struct Sub<TN, TI, TR...> {
-		using Initial = typename WrapState<TI>::Type;
-		using Remaining = Sub<TN + 1, TR...>;
+	// the prongs held as bases, where the empty ones take no room
+	template <unsigned TInitialID, unsigned TN, typename TI, typename... TR>
+	struct HFSM_EMPTY_BASES Sub<TInitialID, TN, TI, TR...>
+		: detail::Compact<typename WrapState<TInitialID, TLogScope, TI>::Type>
+		, detail::Compact<Sub<TInitialID + WrapState<TInitialID, TLogScope, TI>::Type::StateCount, TN + 1, TR...>>
+	{
+		using Initial = typename WrapState<TInitialID, TLogScope, TI>::Type;
+		using Remaining = Sub<TInitialID + Initial::StateCount, TN + 1, TR...>;
 
 		enum : unsigned {
 			ProngIndex	 = TN,
@@ -3262,6 +5867,24 @@ struct M<TContext, TMaxSubstitutions>::_O final {
 			ProngCount	 = Initial::ProngCount + Remaining::ProngCount,
 		};
 
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptSubstitute			 = Initial::NoexceptSubstitute && Remaining::NoexceptSubstitute,
+			NoexceptEnter				 = Initial::NoexceptEnter && Remaining::NoexceptEnter,
+			NoexceptUpdate				 = Initial::NoexceptUpdate && Remaining::NoexceptUpdate,
+			NoexceptUpdateAndTransition	 = Initial::NoexceptUpdateAndTransition && Remaining::NoexceptUpdateAndTransition,
+			NoexceptLeave				 = Initial::NoexceptLeave && Remaining::NoexceptLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Initial::template NoexceptReact<TEvent>::Value &&
+						Remaining::template NoexceptReact<TEvent>::Value
+			};
+		};
+	#endif
+
 		Sub(StateRegistry& stateRegistry,
 			const Index fork,
 			Parents& stateParents,
@@ -3269,52 +5892,75 @@ struct M<TContext, TMaxSubstitutions>::_O final {
 			ForkPointers& forkPointers);
 
 		inline void wideForwardSubstitute	(const unsigned prong,
-											 Control& control, Context& context, LoggerInterface* const logger);
+											 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideForwardSubstitute	(Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideSubstitute			(Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideForwardSubstitute	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+		inline void wideSubstitute			(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideEnterInitial		(				   Context& context, LoggerInterface* const logger);
-		inline void wideEnter				(				   Context& context, LoggerInterface* const logger);
+		inline void wideEnterInitial		(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+		inline void wideEnter				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-		inline bool wideUpdateAndTransition	(Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideUpdate				(				   Context& context, LoggerInterface* const logger);
+		inline bool wideUpdateAndTransition	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+		inline void wideUpdate				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 		template <typename TEvent>
-		inline void wideReact				(const TEvent& event,
-											 Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideReact				(TEvent& event,
+											 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
 
-		inline void wideLeave				(				   Context& context, LoggerInterface* const logger);
+		inline void wideLeave				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
 
-		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition);
-		inline void wideRequestRemain();
-		inline void wideRequestRestart();
-		inline void wideRequestResume();
-		inline void wideChangeToRequested	(				   Context& context, LoggerInterface* const logger);
+		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+		inline void wideRequestRemain() HFSM_NOEXCEPT(true);
+		inline void wideRequestRestart() HFSM_NOEXCEPT(true);
+		inline void wideRequestResume() HFSM_NOEXCEPT(true);
+		inline void wideChangeToRequested	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+		template <typename T>
+		static constexpr unsigned wideFind() {
+			return Initial::template deepFind<T>() != INVALID_STATE ?
+				   Initial::template deepFind<T>() : Remaining::template wideFind<T>();
+		}
+
+		template <typename T>
+		static constexpr unsigned wideFootprint() {
+			return Initial::template deepFind<T>() != INVALID_STATE ?
+				   Initial::template deepFootprint<T>() : Remaining::template wideFootprint<T>();
+		}
+
+		// forks: the id the next fork down the hierarchy gets
+		template <typename TLocation>
+		static constexpr void wideLocate(const unsigned fork, const unsigned forks, TLocation& location) {
+			if (location.state < TInitialID + Initial::StateCount) {
+				location.path.steps[location.path.count].fork  = fork;
+				location.path.steps[location.path.count].prong = ProngIndex;
+				++location.path.count;
+
+				Initial::deepLocate(forks, location);
+			} else
+				Remaining::wideLocate(fork, forks + Initial::ForkCount, location);
+		}
 
 	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 		enum : unsigned {
 			NameCount	 = Initial::NameCount  + Remaining::NameCount,
 		};
 
-		void wideGetNames(const unsigned parent,
-						  const unsigned depth,
-						  StateInfos& stateInfos) const;
-
-		void wideIsActive(const bool active,
-						  unsigned& index,
-						  MachineStructure& structure) const;
+		static void wideGetNames(const unsigned parent,
+								 const unsigned depth,
+								 StateInfos& stateInfos);
 	#endif
 
-		Initial initial;
-		Remaining remaining;
+		inline Initial&	  initial()		HFSM_NOEXCEPT(true)	{ return detail::Compact<Initial  >::get();	}
+		inline Remaining& remaining()	HFSM_NOEXCEPT(true)	{ return detail::Compact<Remaining>::get();	}
 	};
 
 	//----------------------------------------------------------------------
 
-	template <unsigned TN, typename TI>
-	struct Sub<TN, TI> {
-		using Initial = typename WrapState<TI>::Type;
+	template <unsigned TInitialID, unsigned TN, typename TI>
+	struct Sub<TInitialID, TN, TI>
+		: detail::Compact<typename WrapState<TInitialID, TLogScope, TI>::Type>
+	{
+		using Initial = typename WrapState<TInitialID, TLogScope, TI>::Type;
 
 		enum : unsigned {
 			ProngIndex	 = TN,
@@ -3325,6 +5971,23 @@ struct M<TContext, TMaxSubstitutions>::_O final {
 			ProngCount	 = Initial::ProngCount,
 		};
 
+	#ifdef HFSM_ENABLE_NOEXCEPT
+		enum : bool {
+			NoexceptSubstitute			 = Initial::NoexceptSubstitute,
+			NoexceptEnter				 = Initial::NoexceptEnter,
+			NoexceptUpdate				 = Initial::NoexceptUpdate,
+			NoexceptUpdateAndTransition	 = Initial::NoexceptUpdateAndTransition,
+			NoexceptLeave				 = Initial::NoexceptLeave,
+		};
+
+		template <typename TEvent>
+		struct NoexceptReact {
+			enum : bool {
+				Value = Initial::template NoexceptReact<TEvent>::Value
+			};
+		};
+	#endif
+
 		Sub(StateRegistry& stateRegistry,
 			const Index fork,
 			Parents& stateParents,
@@ -3332,51 +5995,64 @@ struct M<TContext, TMaxSubstitutions>::_O final {
 			ForkPointers& forkPointers);
 
 		inline void wideForwardSubstitute	(const unsigned prong,
-											 Control& control, Context& context, LoggerInterface* const logger);
+											 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideForwardSubstitute	(Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideSubstitute			(Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideForwardSubstitute	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+		inline void wideSubstitute			(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-		inline void wideEnterInitial		(				   Context& context, LoggerInterface* const logger);
-		inline void wideEnter				(				   Context& context, LoggerInterface* const logger);
+		inline void wideEnterInitial		(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+		inline void wideEnter				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-		inline bool wideUpdateAndTransition	(Control& control, Context& context, LoggerInterface* const logger);
-		inline void wideUpdate				(				   Context& context, LoggerInterface* const logger);
+		inline bool wideUpdateAndTransition	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+		inline void wideUpdate				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 		template <typename TEvent>
-		inline void wideReact				(const TEvent& event,
-											 Control& control, Context& context, LoggerInterface* const logger);
+		inline void wideReact				(TEvent& event,
+											 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+		inline void wideLeave				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+		inline void wideRequestRemain() HFSM_NOEXCEPT(true);
+		inline void wideRequestRestart() HFSM_NOEXCEPT(true);
+		inline void wideRequestResume() HFSM_NOEXCEPT(true);
+		inline void wideChangeToRequested	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+		template <typename T>
+		static constexpr unsigned wideFind()								{ return Initial::template deepFind<T>();	}
+
+		template <typename T>
+		static constexpr unsigned wideFootprint()							{ return Initial::template deepFootprint<T>();	}
 
-		inline void wideLeave				(				   Context& context, LoggerInterface* const logger);
+		template <typename TLocation>
+		static constexpr void wideLocate(const unsigned fork, const unsigned forks, TLocation& location) {
+			location.path.steps[location.path.count].fork  = fork;
+			location.path.steps[location.path.count].prong = ProngIndex;
+			++location.path.count;
 
-		inline void wideForwardRequest(const unsigned prong, const enum Transition::Type transition);
-		inline void wideRequestRemain();
-		inline void wideRequestRestart();
-		inline void wideRequestResume();
-		inline void wideChangeToRequested	(				   Context& context, LoggerInterface* const logger);
+			Initial::deepLocate(forks, location);
+		}
 
 	#ifdef HFSM_ENABLE_STRUCTURE_REPORT
 		enum : unsigned {
 			NameCount	 = Initial::NameCount,
 		};
 
-		void wideGetNames(const unsigned parent,
-						  const unsigned depth,
-						  StateInfos& stateInfos) const;
-
-		void wideIsActive(const bool active,
-						  unsigned& index,
-						  MachineStructure& structure) const;
+		static void wideGetNames(const unsigned parent,
+								 const unsigned depth,
+								 StateInfos& stateInfos);
 	#endif
 
-		Initial initial;
+		inline Initial&	  initial()		HFSM_NOEXCEPT(true)	{ return detail::Compact<Initial>::get();	}
 	};
 
-	using SubStates = Sub<0, TS...>;
+	using SubStates = Sub<TStateID + 1, 0, TS...>;
 
 	//----------------------------------------------------------------------
 
 	enum : unsigned {
+		StateID		 = TStateID,
+
 		ReverseDepth = SubStates::ReverseDepth + 1,
 		DeepWidth	 = SubStates::DeepWidth,
 		StateCount	 = State::StateCount + SubStates::StateCount,
@@ -3385,53 +6061,113 @@ struct M<TContext, TMaxSubstitutions>::_O final {
 		Width		 = sizeof...(TS),
 	};
 
+#ifdef HFSM_ENABLE_NOEXCEPT
+	enum : bool {
+		NoexceptSubstitute			 = State::NoexceptSubstitute && SubStates::NoexceptSubstitute,
+		NoexceptEnter				 = State::NoexceptEnter && SubStates::NoexceptEnter,
+		NoexceptUpdate				 = State::NoexceptUpdate && SubStates::NoexceptUpdate,
+		NoexceptUpdateAndTransition	 = State::NoexceptUpdateAndTransition && SubStates::NoexceptUpdateAndTransition,
+		NoexceptLeave				 = State::NoexceptLeave && SubStates::NoexceptLeave,
+	};
+
+	template <typename TEvent>
+	struct NoexceptReact {
+		enum : bool {
+			Value = State::template NoexceptReact<TEvent>::Value &&
+					SubStates::template NoexceptReact<TEvent>::Value
+		};
+	};
+#endif
+
 	_O(StateRegistry& stateRegistry,
 	   const Parent parent,
 	   Parents& stateParents,
 	   Parents& forkParents,
 	   ForkPointers& forkPointers);
 
-	inline void deepForwardSubstitute	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepSubstitute			(Control& control, Context& context, LoggerInterface* const logger);
+	inline void deepForwardSubstitute	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
+	inline void deepSubstitute			(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptSubstitute);
 
-	inline void deepEnterInitial		(				   Context& context, LoggerInterface* const logger);
-	inline void deepEnter				(				   Context& context, LoggerInterface* const logger);
+	inline void deepEnterInitial		(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
+	inline void deepEnter				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter);
 
-	inline bool deepUpdateAndTransition	(Control& control, Context& context, LoggerInterface* const logger);
-	inline void deepUpdate				(				   Context& context, LoggerInterface* const logger);
+	inline bool deepUpdateAndTransition	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition);
+	inline void deepUpdate				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptUpdate);
 
 	template <typename TEvent>
-	inline void deepReact				(const TEvent& event,
-										 Control& control, Context& context, LoggerInterface* const logger);
+	inline void deepReact				(TEvent& event,
+										 Control& control, Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value);
+
+	inline void deepLeave				(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptLeave);
+
+	inline void deepForwardRequest(const enum Transition::Type transition) HFSM_NOEXCEPT(true);
+	inline void deepRequestRemain() HFSM_NOEXCEPT(true);
+	inline void deepRequestRestart() HFSM_NOEXCEPT(true);
+	inline void deepRequestResume() HFSM_NOEXCEPT(true);
+	inline void deepChangeToRequested	(Control& control, Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave);
+
+	// compile-time topology, see _R::locate()
+	template <typename T>
+	static constexpr unsigned deepFind() {
+		return std::is_same<T, Head>::value ? (unsigned) StateID : SubStates::template wideFind<T>();
+	}
 
-	inline void deepLeave				(				   Context& context, LoggerInterface* const logger);
+	// bytes taken in each machine instance, by the fork and the stored states of the subtree
+	static constexpr unsigned footprint()	{ return sizeof(_O);	}
 
-	inline void deepForwardRequest(const enum Transition::Type transition);
-	inline void deepRequestRemain();
-	inline void deepRequestRestart();
-	inline void deepRequestResume();
-	inline void deepChangeToRequested	(				   Context& context, LoggerInterface* const logger);
+	template <typename T>
+	static constexpr unsigned deepFootprint() {
+		return std::is_same<T, Head>::value ? footprint() : SubStates::template wideFootprint<T>();
+	}
+
+	// fork: the id the region's own fork gets, in pre-order
+	template <typename TLocation>
+	static constexpr void deepLocate(const unsigned fork, TLocation& location) {
+		if (location.state == StateID)
+			location.end = StateID + StateCount;
+		else {
+			location.parent = StateID;
+			location.orthogonal = true;
+			SubStates::wideLocate(fork, fork + 1, location);
+		}
+	}
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 	enum : unsigned {
 		NameCount	 = State::NameCount  + SubStates::NameCount,
 	};
 
-	void deepGetNames(const unsigned parent,
-					  const enum StateInfo::RegionType region,
-					  const unsigned depth,
-					  StateInfos& stateInfos) const;
-
-	void deepIsActive(const bool isActive,
-					  unsigned& index,
-					  MachineStructure& structure) const;
+	static void deepGetNames(const unsigned parent,
+							 const enum StateInfo::RegionType region,
+							 const unsigned depth,
+							 StateInfos& stateInfos);
 #endif
 
-	Fork _fork;
-	State _state;
-	SubStates _subStates;
+	// the fork first, constructed (and so registered) ahead of the sub-states' own;
+	// the state and the sub-states held as bases, where the empty ones take no room
+	struct HFSM_EMPTY_BASES Nodes
+		: Fork
+		, detail::Compact<State>
+		, detail::Compact<SubStates>
+	{
+		Nodes(StateRegistry& stateRegistry,
+			  const Parent parent,
+			  Parents& stateParents,
+			  Parents& forkParents,
+			  ForkPointers& forkPointers)
+			: Fork(parent, forkParents, forkPointers)
+			, detail::Compact<State>(stateRegistry, parent, stateParents, forkParents, forkPointers)
+			, detail::Compact<SubStates>(stateRegistry, Fork::self, stateParents, forkParents, forkPointers)
+		{}
+	};
+
+	inline Fork&	  fork()		HFSM_NOEXCEPT(true)	{ return _nodes;												}
+	inline State&	  state()		HFSM_NOEXCEPT(true)	{ return static_cast<detail::Compact<State>&>(_nodes).get();		}
+	inline SubStates& subStates()	HFSM_NOEXCEPT(true)	{ return static_cast<detail::Compact<SubStates>&>(_nodes).get();	}
+
+	Nodes _nodes;
 
-	HSFM_IF_DEBUG(const TypeInfo _type = TypeInfo::get<Head>());
+	HSFM_IF_DEBUG_TYPES(const TypeInfo _type = TypeInfo::get<Head>());
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3442,162 +6178,169 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-M<TC, TMS>::_O<TH, TS...>::_O(StateRegistry& stateRegistry,
-							  const Parent parent,
-							  Parents& stateParents,
-							  Parents& forkParents,
-							  ForkPointers& forkPointers)
-	: _fork(static_cast<Index>(forkPointers << &_fork), parent, forkParents)
-	, _state(stateRegistry, parent, stateParents, forkParents, forkPointers)
-	, _subStates(stateRegistry, _fork.self, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::_O(StateRegistry& stateRegistry,
+											 const Parent parent,
+											 Parents& stateParents,
+											 Parents& forkParents,
+											 ForkPointers& forkPointers)
+	: _nodes(stateRegistry, parent, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepForwardSubstitute(Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepForwardSubstitute(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	if (_fork.requested != INVALID_INDEX)
-		_subStates.wideForwardSubstitute(_fork.requested, control, context, logger);
+	if (fork().requested != INVALID_INDEX)
+		subStates().wideForwardSubstitute(fork().requested, control, context);
 	else
-		_subStates.wideForwardSubstitute(				  control, context, logger);
+		subStates().wideForwardSubstitute(				  control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepSubstitute(Control& control,
-										  Context& context,
-										  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepSubstitute(Control& control,
+														 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	if (!_state	  .deepSubstitute(control, context, logger))
-		_subStates.wideSubstitute(control, context, logger);
+	if (!state()   .deepSubstitute(control, context))
+		subStates().wideSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepEnterInitial(Context& context,
-											LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepEnterInitial(Control& control,
+														   Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX &&
-		   _fork.requested == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX &&
+		   fork().requested == INVALID_INDEX);
 
-	_state	  .deepEnter	   (context, logger);
-	_subStates.wideEnterInitial(context, logger);
+	state()	   .deepEnter	   (control, context);
+	subStates().wideEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepEnter(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepEnter(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_state	  .deepEnter(context, logger);
-	_subStates.wideEnter(context, logger);
+	state()	   .deepEnter(control, context);
+	subStates().wideEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 bool
-M<TC, TMS>::_O<TH, TS...>::deepUpdateAndTransition(Control& control,
-												   Context& context,
-												   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepUpdateAndTransition(Control& control,
+																  Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
+
+	const unsigned requestCountBefore = control.requestCount();
 
-	if (_state.deepUpdateAndTransition(control, context, logger)) {
-		_subStates.wideUpdate(context, logger);
+	if (state().deepUpdateAndTransition(control, context)) {
+		if (!skipsObsoleteUpdates<Head>(nullptr) ||
+			!control.leaves(requestCountBefore, StateRange{StateID, StateID + StateCount}))
+			subStates().wideUpdate(control, context);
 
 		return true;
 	} else
-		return _subStates.wideUpdateAndTransition(control, context, logger);
+		return subStates().wideUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepUpdate(Context& context,
-									  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepUpdate(Control& control,
+													 Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_state	  .deepUpdate(context, logger);
-	_subStates.wideUpdate(context, logger);
+	state()	   .deepUpdate(control, context);
+	subStates().wideUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 template <typename TEvent>
 void
-M<TC, TMS>::_O<TH, TS...>::deepReact(const TEvent& event,
-									 Control& control,
-									 Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepReact(TEvent& event,
+													Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_state	  .deepReact(event, control, context, logger);
-	_subStates.wideReact(event, control, context, logger);
+	if (control.leafFirst()) {
+		subStates().wideReact(event, control, context);
+
+		if (!control._consumed)
+			state().deepReact(event, control, context);
+	} else {
+		state().deepReact(event, control, context);
+
+		if (!control._consumed)
+			subStates().wideReact(event, control, context);
+	}
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepLeave(Context& context,
-									 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepLeave(Control& control,
+													Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideLeave(context, logger);
-	_state	  .deepLeave(context, logger);
+	subStates().wideLeave(control, context);
+	state()	   .deepLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepForwardRequest(const enum Transition::Type transition) {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepForwardRequest(const enum Transition::Type transition) HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	if (_fork.requested != INVALID_INDEX)
-		_subStates.wideForwardRequest(_fork.requested, transition);
+	if (fork().requested != INVALID_INDEX)
+		subStates().wideForwardRequest(fork().requested, transition);
 	else
 		switch (transition) {
 		case Transition::Remain:
@@ -3619,83 +6362,73 @@ M<TC, TMS>::_O<TH, TS...>::deepForwardRequest(const enum Transition::Type transi
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepRequestRemain() {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepRequestRemain() HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideRequestRemain();
+	subStates().wideRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepRequestRestart() {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepRequestRestart() HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideRequestRestart();
+	subStates().wideRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepRequestResume() {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepRequestResume() HFSM_NOEXCEPT(true) {
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideRequestResume();
+	subStates().wideRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepChangeToRequested(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepChangeToRequested(Control& control,
+																Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	assert(_fork.active    == INVALID_INDEX &&
-		   _fork.resumable == INVALID_INDEX);
+	assert(fork().active    == INVALID_INDEX &&
+		   fork().resumable == INVALID_INDEX);
 
-	_subStates.wideChangeToRequested(context, logger);
+	subStates().wideChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename TH, typename... TS>
 void
-M<TC, TMS>::_O<TH, TS...>::deepGetNames(const unsigned parent,
-										const enum StateInfo::RegionType region,
-										const unsigned depth,
-										StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_O<TID, TLS, TH, TS...>::deepGetNames(const unsigned parent,
+													   const enum StateInfo::RegionType region,
+													   const unsigned depth,
+													   StateInfos& _stateInfos)
 {
-	_state.deepGetNames(parent, region, depth, _stateInfos);
-	_subStates.wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	State::deepGetNames(parent, region, depth, _stateInfos);
+	_stateInfos[_stateInfos.count() - 1].footprint = footprint();
 
-template <typename TC, unsigned TMS>
-template <typename TH, typename... TS>
-void
-M<TC, TMS>::_O<TH, TS...>::deepIsActive(const bool isActive,
-										unsigned& index,
-										MachineStructure& structure) const
-{
-	_state.deepIsActive(isActive, index, structure);
-	_subStates.wideIsActive(isActive, index, structure);
+	SubStates::wideGetNames(_stateInfos.count() - 1, depth + 1, _stateInfos);
 }
 
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3705,245 +6438,230 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
-											  const Index fork,
-											  Parents& stateParents,
-											  Parents& forkParents,
-											  ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
-	, remaining(stateRegistry, fork, stateParents, forkParents, forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::Sub(StateRegistry& stateRegistry,
+																	   const Index fork,
+																	   Parents& stateParents,
+																	   Parents& forkParents,
+																	   ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
+	, detail::Compact<Remaining>(stateRegistry, fork, stateParents, forkParents, forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
-																	Control& control,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardSubstitute(const unsigned prong,
+																						 Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	if (prong == ProngIndex)
-		initial  .deepForwardSubstitute(	   control, context, logger);
+		initial()  .deepForwardSubstitute(	   control, context);
 	else
-		remaining.wideForwardSubstitute(prong, control, context, logger);
+		remaining().wideForwardSubstitute(prong, control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideForwardSubstitute(Control& control,
-																	Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardSubstitute(Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial	 .deepForwardSubstitute(control, context, logger);
-	remaining.wideForwardSubstitute(control, context, logger);
+	initial()  .deepForwardSubstitute(control, context);
+	remaining().wideForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideSubstitute(Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideSubstitute(Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial	 .deepSubstitute(control, context, logger);
-	remaining.wideSubstitute(control, context, logger);
+	initial()  .deepSubstitute(control, context);
+	remaining().wideSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideEnterInitial(Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnterInitial(Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial  .deepEnterInitial(context, logger);
-	remaining.wideEnterInitial(context, logger);
+	initial()  .deepEnterInitial(control, context);
+	remaining().wideEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideEnter(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideEnter(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial  .deepEnter(context, logger);
-	remaining.wideEnter(context, logger);
+	initial()  .deepEnter(control, context);
+	remaining().wideEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 bool
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideUpdateAndTransition(Control& control,
-																	  Context& context,
-																	  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdateAndTransition(Control& control,
+																						   Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	return initial  .deepUpdateAndTransition(control, context, logger)
-		|| remaining.wideUpdateAndTransition(control, context, logger);
+	return initial()  .deepUpdateAndTransition(control, context)
+		|| remaining().wideUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideUpdate(Context& context,
-														 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideUpdate(Control& control,
+																			  Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	initial  .deepUpdate(context, logger);
-	remaining.wideUpdate(context, logger);
+	initial()  .deepUpdate(control, context);
+	remaining().wideUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 template <typename TEvent>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideReact(const TEvent& event,
-														Control& control,
-														Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideReact(TEvent& event,
+																			 Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	initial  .deepReact(event, control, context, logger);
-	remaining.wideReact(event, control, context, logger);
+	initial().deepReact(event, control, context);
+
+	// the regions past the consumer are skipped
+	if (!control._consumed)
+		remaining().wideReact(event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideLeave(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideLeave(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	initial	 .deepLeave(context, logger);
-	remaining.wideLeave(context, logger);
+	initial()  .deepLeave(control, context);
+	remaining().wideLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideForwardRequest(const unsigned prong,
-																 const enum Transition::Type transition)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideForwardRequest(const unsigned prong,
+																					  const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	if (prong == ProngIndex) {
-		initial.deepForwardRequest(transition);
-		remaining.wideForwardRequest(prong, Transition::Remain);
+		initial().deepForwardRequest(transition);
+		remaining().wideForwardRequest(prong, Transition::Remain);
 	} else {
-		initial.deepForwardRequest(Transition::Remain);
-		remaining.wideForwardRequest(prong, transition);
+		initial().deepForwardRequest(Transition::Remain);
+		remaining().wideForwardRequest(prong, transition);
 	}
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideRequestRemain() {
-	initial.deepRequestRemain();
-	remaining.wideRequestRemain();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
+	remaining().wideRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideRequestRestart() {
-	initial.deepRequestRestart();
-	remaining.wideRequestRestart();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
+	remaining().wideRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideRequestResume() {
-	initial.deepRequestResume();
-	remaining.wideRequestResume();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideRequestResume() HFSM_NOEXCEPT(true) {
+	initial().deepRequestResume();
+	remaining().wideRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideChangeToRequested(Context& context,
-																	LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideChangeToRequested(Control& control,
+																						 Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	initial	 .deepChangeToRequested(context, logger);
-	remaining.wideChangeToRequested(context, logger);
+	initial()  .deepChangeToRequested(control, context);
+	remaining().wideChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI, typename... TR>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideGetNames(const unsigned parent,
-														   const unsigned depth,
-														   StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI, TR...>::wideGetNames(const unsigned parent,
+																				const unsigned depth,
+																				StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
-	remaining.wideGetNames(parent, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
+	Remaining::wideGetNames(parent, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI, typename... TR>
-void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI, TR...>::wideIsActive(const bool isActive,
-														   unsigned& index,
-														   MachineStructure& structure) const
-{
-	initial.deepIsActive(isActive, index, structure);
-	remaining.wideIsActive(isActive, index, structure);
-}
 
 #endif
 
@@ -3954,228 +6672,211 @@ namespace hfsm {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::Sub(StateRegistry& stateRegistry,
-										   const Index fork,
-										   Parents& stateParents,
-										   Parents& forkParents,
-										   ForkPointers& forkPointers)
-	: initial(stateRegistry,
-			  Parent(fork,
-					 ProngIndex
-					 HSFM_IF_DEBUG(, TypeInfo::get<T>())
-					 HSFM_IF_DEBUG(, TypeInfo::get<typename Initial::Head>())),
-			  stateParents,
-			  forkParents,
-			  forkPointers)
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::Sub(StateRegistry& stateRegistry,
+																const Index fork,
+																Parents& stateParents,
+																Parents& forkParents,
+																ForkPointers& forkPointers)
+	: detail::Compact<Initial>(stateRegistry,
+							   Parent(fork,
+									  ProngIndex
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<T>())
+									  HSFM_IF_DEBUG_TYPES(, TypeInfo::get<typename Initial::Head>())),
+							   stateParents,
+							   forkParents,
+							   forkPointers)
 {}
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
-															 Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardSubstitute(const unsigned HSFM_IF_ASSERT(prong),
+																				  Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
 	assert(prong == ProngIndex);
 
-	initial.deepForwardSubstitute(control, context, logger);
+	initial().deepForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideForwardSubstitute(Control& control,
-															 Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardSubstitute(Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial.deepForwardSubstitute(control, context, logger);
+	initial().deepForwardSubstitute(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideSubstitute(Control& control,
-													  Context& context,
-													  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideSubstitute(Control& control,
+																		   Context& context) HFSM_NOEXCEPT(NoexceptSubstitute)
 {
-	initial.deepSubstitute(control, context, logger);
+	initial().deepSubstitute(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideEnterInitial(Context& context,
-														LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnterInitial(Control& control,
+																			 Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnterInitial(context, logger);
+	initial().deepEnterInitial(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideEnter(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideEnter(Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptEnter)
 {
-	initial.deepEnter(context, logger);
+	initial().deepEnter(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 bool
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideUpdateAndTransition(Control& control,
-															   Context& context,
-															   LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdateAndTransition(Control& control,
+																					Context& context) HFSM_NOEXCEPT(NoexceptUpdateAndTransition)
 {
-	return initial.deepUpdateAndTransition(control, context, logger);
+	return initial().deepUpdateAndTransition(control, context);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideUpdate(Context& context,
-												  LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideUpdate(Control& control,
+																	   Context& context) HFSM_NOEXCEPT(NoexceptUpdate)
 {
-	initial.deepUpdate(context, logger);
+	initial().deepUpdate(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 template <typename TEvent>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideReact(const TEvent& event,
-												 Control& control,
-												 Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideReact(TEvent& event,
+																	  Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptReact<TEvent>::Value)
 {
-	initial.deepReact(event, control, context, logger);
+	initial().deepReact(event, control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideLeave(Context& context,
-												 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideLeave(Control& control,
+																	  Context& context) HFSM_NOEXCEPT(NoexceptLeave)
 {
-	initial.deepLeave(context, logger);
+	initial().deepLeave(control, context);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideForwardRequest(const unsigned prong,
-														  const enum Transition::Type transition)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideForwardRequest(const unsigned prong,
+																			   const enum Transition::Type transition) HFSM_NOEXCEPT(true)
 {
 	assert(prong <= ProngIndex);
 
 	if (prong == ProngIndex)
-		initial.deepForwardRequest(transition);
+		initial().deepForwardRequest(transition);
 	else
-		initial.deepForwardRequest(Transition::Remain);
+		initial().deepForwardRequest(Transition::Remain);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideRequestRemain() {
-	initial.deepRequestRemain();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRemain() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRemain();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideRequestRestart() {
-	initial.deepRequestRestart();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestRestart() HFSM_NOEXCEPT(true) {
+	initial().deepRequestRestart();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideRequestResume() {
-	initial.deepRequestResume();
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideRequestResume() HFSM_NOEXCEPT(true) {
+	initial().deepRequestResume();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideChangeToRequested(Context& context,
-															 LoggerInterface* const logger)
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideChangeToRequested(Control& control,
+																				  Context& context) HFSM_NOEXCEPT(NoexceptEnter && NoexceptLeave)
 {
-	initial.deepChangeToRequested(context, logger);
+	initial().deepChangeToRequested(control, context);
 }
 
 //------------------------------------------------------------------------------
 
 #ifdef HFSM_ENABLE_STRUCTURE_REPORT
 
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
+template <typename TC, unsigned TMS, typename TLF>
+template <unsigned TID, bool TLS, typename T, typename... TS>
+template <unsigned TIID, unsigned TN, typename TI>
 void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideGetNames(const unsigned parent,
-													const unsigned depth,
-													StateInfos& _stateInfos) const
+M<TC, TMS, TLF>::_O<TID, TLS, T, TS...>::Sub<TIID, TN, TI>::wideGetNames(const unsigned parent,
+																		 const unsigned depth,
+																		 StateInfos& _stateInfos)
 {
-	initial.deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
+	Initial::deepGetNames(parent, StateInfo::Orthogonal, depth, _stateInfos);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-template <typename TC, unsigned TMS>
-template <typename T, typename... TS>
-template <unsigned TN, typename TI>
-void
-M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideIsActive(const bool isActive,
-													unsigned& index,
-													MachineStructure& structure) const
-{
-	initial.deepIsActive(isActive, index, structure);
-}
 
 #endif
 
@@ -4185,4 +6886,8 @@ M<TC, TMS>::_O<T, TS...>::Sub<TN, TI>::wideIsActive(const bool isActive,
 
 #undef HFSM_IF_STRUCTURE
 #undef HFSM_IF_LOGGER
-#undef HFSM_LOGGER_OR
+#undef HFSM_IF_WATCHDOG
+#undef HFSM_IF_EVENT_STATS
+#undef HFSM_IF_COVERAGE
+#undef HFSM_IF_SUBSTITUTION_STATS
+#undef HFSM_IF_SCRATCH
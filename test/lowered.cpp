@@ -0,0 +1,248 @@
+﻿// differential test: the same states, driven through the template engine
+// and through the switch-based machine emitted by tools/lower.py from lowered.hfsm,
+// must leave identical callback traces
+
+#define HFSM_ENABLE_STRUCTURE_REPORT
+#include <hfsm/machine_single.hpp>
+
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Trace {
+	enum Method {
+		Substitute,
+		Enter,
+		Update,
+		Transition,
+		React,
+		Leave,
+	};
+
+	Method method;
+	unsigned state;
+
+	bool operator == (const Trace& other) const { return method == other.method && state == other.state; }
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+enum : unsigned { STATE_COUNT = 19 };
+
+struct Context {
+	std::vector<Trace> trace;
+	unsigned random;
+
+	// states whose composite region is inactive, refreshed between the steps
+	bool schedulable[STATE_COUNT];
+	unsigned scheduled;
+
+	// xorshift32, both machines draw the same numbers as long as their callbacks run in the same order
+	unsigned next() {
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+
+		return random;
+	}
+};
+
+using M = hfsm::Machine<Context>;
+
+//------------------------------------------------------------------------------
+
+struct Poke {};
+
+template <unsigned N>
+struct S;
+
+// requests a transition to a random state, once in 'odds' calls;
+// schedules only into inactive composite regions, as the template engine expects
+template <std::size_t... TI>
+void
+request(M::Control& control, Context& context, const unsigned odds, std::index_sequence<TI...>) {
+	using Request = void (*)(M::Control&);
+
+	static const Request changeTo[] = { [](M::Control& c) { c.changeTo<S<TI>>(); }... };
+	static const Request resume[]	= { [](M::Control& c) { c.resume  <S<TI>>(); }... };
+	static const Request schedule[] = { [](M::Control& c) { c.schedule<S<TI>>(); }... };
+
+	if (context.next() % odds == 0) {
+		const unsigned target = context.next() % STATE_COUNT;
+
+		switch (context.next() % 3) {
+		case 0:
+			changeTo[target](control);
+			break;
+
+		case 1:
+			resume[target](control);
+			break;
+
+		default:
+			if (context.schedulable[target]) {
+				schedule[target](control);
+				++context.scheduled;
+			}
+		}
+	}
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <unsigned N>
+struct S
+	: M::Base
+{
+	// composites S<2> and S<9> keep shallow and no history, the rest deep
+	static constexpr History HistoryPolicy = N == 2 ? History::Shallow :
+											 N == 9 ? History::None	   : History::Deep;
+
+	// and S<2> and S<14> skip updating the sub-states they're about to leave
+	enum : bool { SkipObsoleteUpdates = N == 2 || N == 14 };
+
+	void substitute(Control& control, Context& _) {
+		_.trace.push_back(Trace{ Trace::Substitute, N });
+		request(control, _, 8, std::make_index_sequence<STATE_COUNT>{});
+	}
+
+	void enter(Context& _)							{ _.trace.push_back(Trace{ Trace::Enter,  N });	}
+	void update(Context& _)							{ _.trace.push_back(Trace{ Trace::Update, N });	}
+
+	void transition(Control& control, Context& _) {
+		_.trace.push_back(Trace{ Trace::Transition, N });
+		request(control, _, 6, std::make_index_sequence<STATE_COUNT>{});
+	}
+
+	void react(const Poke&, Control& control, Context& _) {
+		_.trace.push_back(Trace{ Trace::React, N });
+		request(control, _, 5, std::make_index_sequence<STATE_COUNT>{});
+
+		if (_.next() % 4 == 0)
+			control.consume();
+	}
+
+	void leave(Context& _)							{ _.trace.push_back(Trace{ Trace::Leave,  N });	}
+
+	using M::Base::react;
+};
+
+//------------------------------------------------------------------------------
+
+// mirrors lowered.hfsm
+using Engine = M::Root<S<0>,
+				   S<1>,
+				   M::Composite<S<2>,
+					   S<3>,
+					   S<4>,
+					   M::Orthogonal<S<5>,
+						   M::Composite<S<6>,
+							   S<7>,
+							   S<8>
+						   >,
+						   M::Composite<S<9>,
+							   S<10>,
+							   M::Orthogonal<S<11>,
+								   S<12>,
+								   S<13>
+							   >
+						   >
+					   >
+				   >,
+				   M::Orthogonal<S<14>,
+					   S<15>,
+					   M::Composite<S<16>,
+						   S<17>,
+						   S<18>
+					   >
+				   >
+			   >;
+
+// checks its state ids and fork paths against Engine
+#include "lowered.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <std::size_t... TI>
+bool
+sameActivity(Engine& engine, Lowered& lowered, std::index_sequence<TI...>) {
+	const bool same[] = { engine.isActive<S<TI>>() == lowered.isActive<S<TI>>()... };
+
+	for (const bool s : same)
+		if (!s)
+			return false;
+
+	return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename TMachine, std::size_t... TI>
+void
+refresh(TMachine& machine, Context& context, std::index_sequence<TI...>) {
+	const unsigned parents[] = { Engine::parentOf<S<TI>>()... };
+	const bool active[]		 = { machine.template isActive<S<TI>>()... };
+
+	for (unsigned i = 0; i < STATE_COUNT; ++i) {
+		const unsigned parent = parents[i];
+
+		// S<5>, S<11> and S<14> head the orthogonal regions
+		context.schedulable[i] = parent != M::INVALID_STATE &&
+								 parent != 5 && parent != 11 && parent != 14 &&
+								 !active[parent];
+	}
+}
+
+//------------------------------------------------------------------------------
+
+int
+main() {
+	Context engineContext{ {}, 1 };
+	Context loweredContext{ {}, 1 };
+
+	{
+		Engine engine(engineContext);
+		Lowered lowered(loweredContext);
+		assert(engineContext.trace == loweredContext.trace);
+
+		refresh(engine,	 engineContext,	 std::make_index_sequence<STATE_COUNT>{});
+		refresh(lowered, loweredContext, std::make_index_sequence<STATE_COUNT>{});
+
+		unsigned driver = 7;
+		for (unsigned step = 0; step < 4096; ++step) {
+			driver = driver * 1103515245u + 12345u;
+
+			if ((driver >> 16) % 3) {
+				engine.update();
+				lowered.update();
+			} else {
+				HSFM_IF_ASSERT(const auto engineReaction  = engine .react(Poke{}));
+				HSFM_IF_ASSERT(const auto loweredReaction = lowered.react(Poke{}));
+				assert(engineReaction.consumer == loweredReaction.consumer);
+			}
+
+			if ((driver >> 16) % 64 == 0) {
+				const auto order = engine.propagation() == M::Propagation::RootFirst ?
+					M::Propagation::LeafFirst : M::Propagation::RootFirst;
+
+				engine.propagation(order);
+				lowered.propagation(order);
+			}
+
+			assert(engineContext.trace == loweredContext.trace);
+			assert(sameActivity(engine, lowered, std::make_index_sequence<STATE_COUNT>{}));
+
+			refresh(engine,	 engineContext,	 std::make_index_sequence<STATE_COUNT>{});
+			refresh(lowered, loweredContext, std::make_index_sequence<STATE_COUNT>{});
+		}
+	}
+
+	assert(engineContext.trace == loweredContext.trace);
+	assert(engineContext.scheduled > 0);
+	assert(engineContext.scheduled == loweredContext.scheduled);
+
+	return engineContext.trace == loweredContext.trace ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
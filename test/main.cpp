@@ -1,8 +1,14 @@
-#define HFSM_ENABLE_STRUCTURE_REPORT
+﻿#define HFSM_ENABLE_STRUCTURE_REPORT
+#define HFSM_ENABLE_WATCHDOG
+#define HFSM_ENABLE_EVENT_STATS
+#define HFSM_ENABLE_COVERAGE
+#define HFSM_ENABLE_SUBSTITUTION_STATS
+#define HFSM_ENABLE_SCRATCH
 //#include <hfsm/machine.hpp>
 #include <hfsm/machine_single.hpp>
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -42,7 +48,7 @@ template <typename T>
 Status status(Event::Enum event) {
 	using Type = T;
 
-	return Status{ event, std::type_index(typeid(Type)) };
+	return Status{ event, hfsm::detail::TypeInfo::get<Type>() };
 }
 
 //------------------------------------------------------------------------------
@@ -68,6 +74,9 @@ struct Context {
 	float deltaTime = 0.0f;
 
 	History history;
+
+	std::vector<int> parcel;
+	std::vector<int> signals;
 };
 using M = hfsm::Machine<Context>;
 
@@ -188,6 +197,18 @@ struct Reacting
 	}
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <typename T>
+struct Consuming
+	: Base<T>
+{
+	void react(const Action&, M::Control& control, Context& _) {
+		_.history.push_back(Status{ Event::Reaction, hfsm::detail::TypeInfo::get<T>() });
+		control.consume();
+	}
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 struct A : Reacting<A> {};
@@ -278,12 +299,259 @@ struct B_2_2
 	}
 };
 
+// substitute each other forever
+
+struct Pong;
+
+struct Idle : M::Base {};
+
+struct Ping
+	: M::Base
+{
+	void substitute(Control& control, Context&) { control.changeTo<Pong>(); }
+};
+
+struct Pong
+	: M::Base
+{
+	void substitute(Control& control, Context&) { control.changeTo<Ping>(); }
+};
+
+// hands the substitution on, down a chain longer than TMaxSubstitutions
+template <unsigned TN>
+struct Relay
+	: M::Base
+{
+	void substitute(Control& control, Context&) { control.changeTo<Relay<TN + 1>>(); }
+};
+
+template <>
+struct Relay<5> : M::Base {};
+
+// takes its time substituting
+struct Drowsy
+	: M::Base
+{
+	void substitute(Control& control, Context&) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+		control.changeTo<Relay<1>>();
+	}
+};
+
+// takes its time updating
+struct Sluggish
+	: M::Base
+{
+	void update(Context&) { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+};
+
+//------------------------------------------------------------------------------
+// doesn't update its sub-states on the tick it transitions away
+
+struct Hasty
+	: Base<Hasty>
+{
+	enum : bool { SkipObsoleteUpdates = true };
+
+	void transition(Control& control, Context& _) { changeTo<Idle>(control, _.history); }
+};
+
+struct Hasty_1 : Base<Hasty_1> {};
+
+// still updates them when it only schedules, or transitions within its own sub-tree
+
+struct Patient_2;
+
+struct Patient
+	: Base<Patient>
+{
+	enum : bool { SkipObsoleteUpdates = true };
+
+	void transition(Control& control, Context& _) {
+		switch (currentUpdateCount()) {
+		case 1:
+			schedule<Hasty_1>(control, _.history);
+			break;
+
+		case 2:
+			changeTo<Patient_2>(control, _.history);
+			break;
+
+		default:
+			break;
+		}
+	}
+};
+
+struct Patient_1 : Base<Patient_1> {};
+struct Patient_2 : Base<Patient_2> {};
+
+//------------------------------------------------------------------------------
+// resumed with fewer of their sub-states
+
+struct Shallow
+	: M::Base
+{
+	static constexpr History HistoryPolicy = History::Shallow;
+};
+
+struct Shallow_1 : M::Base {};
+struct Shallow_2 : M::Base {};
+struct Shallow_2_1 : M::Base {};
+struct Shallow_2_2 : M::Base {};
+
+struct Forgetful
+	: M::Base
+{
+	static constexpr History HistoryPolicy = History::None;
+};
+
+struct Forgetful_1 : M::Base {};
+struct Forgetful_2 : M::Base {};
+
+//------------------------------------------------------------------------------
+// no data, so not stored
+
+struct Blank	 : M::Base {};
+struct Blank_1	 : M::Base {};
+struct Blank_1_1 : M::Base {};
+struct Blank_1_2 : M::Base {};
+struct Blank_2	 : M::Base {};
+
+//------------------------------------------------------------------------------
+// keeps per-visit data in a scratch arena
+
+struct Scribbler
+	: M::BaseT<M::ScratchT<64>>
+{
+	void enter(Context&) {
+		// released by the last leave()
+		assert(scratchUsed() == 0);
+
+		_value = create<unsigned>(7u);
+	}
+
+	void update(Context&) {
+		assert(!scratchCapacity() || *_value == 7u);
+
+		allocate(32, 8);
+	}
+
+	unsigned* _value = nullptr;
+};
+
+//------------------------------------------------------------------------------
+// takes over the payload of the parcels passed as rvalues
+
+struct Parcel {
+	std::vector<int> payload;
+};
+
+// negative values send the keeper away
+struct Signal {
+	int value;
+};
+
+struct Keeper
+	: M::Base
+{
+	void react(const Parcel& parcel, Control&, Context& _)	{ _.parcel = parcel.payload;			}
+	void react(Parcel&& parcel, Control&, Context& _)		{ _.parcel = std::move(parcel.payload);	}
+
+	void react(const Signal& signal, Control& control, Context& _) {
+		_.signals.push_back(signal.value);
+
+		if (signal.value < 0)
+			control.changeTo<Idle>();
+	}
+
+	using M::Base::react;
+};
+
+//------------------------------------------------------------------------------
+// consumes the action in one of its regions
+
+struct Gate : Reacting<Gate> {};
+struct Gate_1 : Reacting<Gate_1> {};
+struct Gate_2 : Consuming<Gate_2> {};
+struct Gate_3 : Reacting<Gate_3> {};
+
+//------------------------------------------------------------------------------
+// records what passes the log filter
+
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+
+struct Recorder
+	: hfsm::LoggerInterface
+{
+	struct Entry {
+		StateType state;
+		Method method;
+
+		inline bool operator == (const Entry& other) const { return state == other.state && method == other.method; }
+	};
+
+	template <typename T>
+	static Entry entry(const Method method)			{ return Entry{ *hfsm::detail::TypeInfo::get<T>(), method };	}
+
+	void record(const StateType& state,
+				const char* const,
+				const Method method,
+				const char* const) override
+	{
+		entries.push_back(Entry{ state, method });
+	}
+
+	template <unsigned TCapacity>
+	void assertEntries(const Entry (&reference)[TCapacity]) {
+		assert(entries.size() == TCapacity);
+		assert(std::equal(entries.begin(), entries.end(), reference));
+
+		entries.clear();
+	}
+
+	std::vector<Entry> entries;
+};
+
+// overrides every method, for any filter
+template <typename TM, unsigned TN>
+struct Chatty
+	: TM::Base
+{
+	void enter(Context&)													{}
+	void update(Context&)													{}
+
+	template <typename TEvent>
+	void react(const TEvent&, typename TM::Control&, Context&)				{}
+
+	void leave(Context&)													{}
+};
+
+// updates and reactions, within the nested Loud subtree only
+struct Loud;
+
+using Filtered = hfsm::Machine<Context, 4, hfsm::LogFilter<Recorder::mask(Recorder::Method::Update) |
+														   Recorder::mask(Recorder::Method::React),
+														   Loud>>;
+
+struct Quiet   : Chatty<Filtered, 0> {};
+struct Quiet_1 : Chatty<Filtered, 1> {};
+struct Loud    : Chatty<Filtered, 2> {};
+struct Loud_1  : Chatty<Filtered, 3> {};
+struct Loud_2  : Chatty<Filtered, 4> {};
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 int
 main(int, char*[]) {
 	Context _;
 
+	// the items follow the count inline, no pointer to them
+	static_assert(sizeof(hfsm::detail::Array<void*, 8>) == 2 * sizeof(unsigned) + 8 * sizeof(void*), "");
+
 	{
 		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -312,12 +580,50 @@ main(int, char*[]) {
 		static_assert(machine.ForkCount  ==  6, "");
 		static_assert(machine.ProngCount == 10, "");
 
+		using Machine = decltype(machine);
+
+		static_assert(Machine::stateIndex<A_2_1>() == 4, "");
+		static_assert(Machine::parentOf<A_2_1>() == 3, "");
+		static_assert(Machine::parentOf<A>() == 0, "");
+		static_assert(Machine::parentOf<M::Base>() == M::INVALID_STATE, "");
+		static_assert(Machine::depthOf<A_2_1>() == 3, "");
+		static_assert(Machine::depthOf<B_2>() == 2, "");
+
+		static_assert(Machine::pathOf<B_2_2>()[0].fork == 0 && Machine::pathOf<B_2_2>()[0].prong == 1, "");
+		static_assert(Machine::pathOf<B_2_2>()[1].fork == 3 && Machine::pathOf<B_2_2>()[1].prong == 1, "");
+		static_assert(Machine::pathOf<B_2_2>()[2].fork == 5 && Machine::pathOf<B_2_2>()[2].prong == 1, "");
+
+		static_assert(Machine::subtreeRange<B>().begin == 6 && Machine::subtreeRange<B>().end == 13, "");
+		static_assert(Machine::subtreeRange<B>().contains(Machine::stateIndex<B_1_2>()), "");
+		static_assert(!Machine::subtreeRange<A_2>().contains(Machine::stateIndex<A_1>()), "");
+
+		static_assert( Machine::insideOrthogonal<B_1_1>(), "");
+		static_assert(!Machine::insideOrthogonal<B>(), "");
+		static_assert(!Machine::insideOrthogonal<A_2_2>(), "");
+
+		assert(machine.stateId<A_2_2>() == Machine::stateIndex<A_2_2>());
+		assert(machine.stateId<B_1_2>() == Machine::stateIndex<B_1_2>());
+
 		const Status created[] = {
 			status<A>(Event::Enter),
 			status<A_1>(Event::Enter),
 		};
 		_.assertHistory(created);
 
+		M::WatchdogT<machine.StateCount> watchdog;
+		watchdog.threshold(std::chrono::hours(1));
+		watchdog.oscillation(1, 60);
+		machine.attachWatchdog(&watchdog);
+
+		M::EventStatsT<> eventStats;
+		machine.attachEventStats(&eventStats);
+
+		M::CoverageT<machine.StateCount> coverage;
+		machine.attachCoverage(&coverage);
+
+		M::SubstitutionStats substitutionStats;
+		machine.attachSubstitutionStats(&substitutionStats);
+
 		assert( machine.isActive<A>());
 		assert( machine.isActive<A_1>());
 		assert(!machine.isActive<A_2>());
@@ -331,6 +637,28 @@ main(int, char*[]) {
 		assert(!machine.isActive<B_2_1>());
 		assert(!machine.isActive<B_2_2>());
 
+		assert(machine.structure().count() == 12);
+		assert(strcmp(machine.structure()[ 0].name, "A")	  == 0);
+		assert(strcmp(machine.structure()[11].name, "B_2_2") == 0);
+		assert(machine.structure()[0].footprint >= machine.structure()[1].footprint +	// A >= A_1 + A_2
+												   machine.structure()[2].footprint);
+		assert(machine.structure()[2].footprint >= machine.structure()[3].footprint +	// A_2 >= A_2_1 + A_2_2
+												   machine.structure()[4].footprint);
+		assert(machine.structure()[5].footprint >= machine.structure()[6].footprint +	// B >= B_1 + B_2
+												   machine.structure()[9].footprint);
+		assert(machine.activity()[0] == +1);	// A
+		assert(machine.activity()[1] == +1);	// A_1
+		assert(machine.activity()[2] == -1);	// A_2
+
+	#ifdef _DEBUG
+		using TypeInfo = hfsm::detail::TypeInfo;
+
+		assert(*machine.stateType(1)	 == *TypeInfo::get<A>());
+		assert(*machine.activeType(0)	 == *TypeInfo::get<A>());
+		assert(*machine.activeType(1)	 == *TypeInfo::get<A_1>());
+		assert(!machine.requestedType(1));
+	#endif
+
 		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 		machine.react(Action{});
@@ -376,6 +704,12 @@ main(int, char*[]) {
 		assert(!machine.isResumable<B_2_1>());
 		assert(!machine.isResumable<B_2_2>());
 
+		assert(machine.activity()[0] == +2);	// A
+		assert(machine.activity()[1] == -1);	// A_1
+		assert(machine.activity()[2] == +1);	// A_2
+		assert(machine.activity()[3] == +1);	// A_2_1
+		assert(machine.activity()[4] == -2);	// A_2_2
+
 		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 		machine.react(Action{});
@@ -565,6 +899,48 @@ main(int, char*[]) {
 		_.assertHistory(update6);
 
 		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+		// every state entered twice since the watchdog was attached
+		assert(watchdog.incidents().count() == 8);
+		assert(watchdog.incidents()[0].type  == M::Watchdog::Incident::Type::Oscillation);
+		assert(watchdog.incidents()[0].state == machine.stateId<A_2>());
+		assert(watchdog.incidents()[2].state == machine.stateId<B>());
+		assert(watchdog.incidents()[7].state == machine.stateId<A>());
+		assert(watchdog.incidents()[7].type  == M::Watchdog::Incident::Type::Oscillation);
+
+		assert(eventStats.entries().count() == 1);
+		assert(eventStats.get<Action>()->dispatched  ==  3);
+		assert(eventStats.get<Action>()->visited	 == 13);
+		assert(eventStats.get<Action>()->handled	 ==  4);	// Reacting<> states only
+		assert(eventStats.get<Action>()->transitions ==  0);
+
+		assert( coverage.entered(machine.stateId<A_2_2>()));
+		assert(!coverage.entered(machine.stateId<A_1>()));		// entered before the coverage was attached
+		assert(!coverage.entered(machine.stateId<B_1_2>()));
+
+		std::vector<unsigned> covered(16);
+		assert(coverage.exportStates(covered.data(), 16) == 9);
+
+		// ids out of range, and coverages of other machines
+		assert(!coverage.entered(coverage.capacity()));
+
+		M::CoverageT<machine.StateCount + M::Coverage::WordBits> wider;
+		assert(!wider.merge(coverage));
+		assert(!wider.entered(machine.stateId<A_2_2>()));
+
+		std::vector<M::Coverage::Prong> prongs(16);
+		assert(machine.exportTransitions(prongs.data(), 16) == 3);	// A, A_2, B
+		assert(coverage.switchedTo(machine.stateId<A_2>()));
+		assert(!coverage.switchedTo(machine.stateId<A_2_1>()));	// entered as the initial prong only
+
+		machine.detachCoverage();
+		assert(machine.exportTransitions(prongs.data(), 16) == 0);	// recording into the sink
+
+		assert(substitutionStats.calls()	 == 6);
+		assert(substitutionStats.rounds(1) == 5);
+		assert(substitutionStats.rounds(2) == 1);		// B_2_1 -> B_2_2
+		assert(substitutionStats.peak()	 == 2);
+		assert(substitutionStats.cycles()	 == 0);
 	}
 
 	const Status destroyed[] = {
@@ -574,6 +950,617 @@ main(int, char*[]) {
 	};
 	_.assertHistory(destroyed);
 
+	{
+		M::PeerRoot<
+			Idle,
+			Ping,
+			Pong
+		> machine(_);
+
+		M::WatchdogT<machine.StateCount> watchdog;
+		machine.attachWatchdog(&watchdog);
+
+		M::SubstitutionStats substitutionStats;
+		machine.attachSubstitutionStats(&substitutionStats);
+
+		// Ping, Pong, then Ping requested again: stopped a round short of TMaxSubstitutions
+		machine.changeTo<Ping>();
+		machine.update();
+
+		assert(machine.isActive<Ping>());
+
+		assert(substitutionStats.calls()	 == 1);
+		assert(substitutionStats.rounds(3) == 1);
+		assert(substitutionStats.cycles()	 == 1);
+		assert(substitutionStats.exhausted() == 0);
+
+		assert(watchdog.incidents().count() == 1);
+		assert(watchdog.incidents()[0].type  == M::Watchdog::Incident::Type::SubstitutionCycle);
+		assert(watchdog.incidents()[0].state == machine.stateId<Pong>());
+
+		// nothing left over for the next update
+		machine.update();
+		assert(machine.isActive<Ping>());
+		assert(substitutionStats.calls() == 1);
+	}
+
+	{
+		M::PeerRoot<
+			Idle,
+			Relay<0>,
+			Relay<1>,
+			Relay<2>,
+			Relay<3>,
+			Relay<4>,
+			Relay<5>
+		> machine(_);
+
+		M::WatchdogT<machine.StateCount> watchdog;
+		watchdog.threshold(std::chrono::hours(1));
+		machine.attachWatchdog(&watchdog);
+
+		// no cycle, still requesting Relay<4> after the last round
+		machine.changeTo<Relay<0>>();
+		machine.update();
+
+		assert(machine.isActive<Relay<3>>());
+
+		assert(watchdog.incidents().count() == 1);
+		assert(watchdog.incidents()[0].type  == M::Watchdog::Incident::Type::SubstitutionLimit);
+		assert(watchdog.incidents()[0].state == machine.stateId<Relay<4>>());
+	}
+
+	{
+		M::PeerRoot<
+			Idle,
+			Drowsy,
+			Relay<1>,
+			Relay<2>,
+			Relay<3>,
+			Relay<4>,
+			Relay<5>
+		> machine(_);
+
+		M::WatchdogT<machine.StateCount> watchdog;
+		watchdog.threshold(std::chrono::hours(1));
+		machine.attachWatchdog(&watchdog);
+
+		M::SubstitutionStats substitutionStats;
+		substitutionStats.budget(std::chrono::milliseconds(1));
+		machine.attachSubstitutionStats(&substitutionStats);
+
+		// out of time after the first round, Relay<1> is left for the next update
+		machine.changeTo<Drowsy>();
+		machine.update();
+
+		assert(machine.isActive<Drowsy>());
+		assert(substitutionStats.overBudget() == 1);
+
+		assert(watchdog.incidents().count() == 1);
+		assert(watchdog.incidents()[0].type  == M::Watchdog::Incident::Type::SubstitutionBudget);
+		assert(watchdog.incidents()[0].state == machine.stateId<Relay<1>>());
+		assert(watchdog.incidents()[0].duration >= std::chrono::milliseconds(1));
+	}
+
+	{
+		M::PeerRoot<
+			Sluggish,
+			Idle
+		> machine(_);
+
+		M::WatchdogT<machine.StateCount> watchdog;
+		watchdog.threshold(std::chrono::hours(1));
+		watchdog.threshold(machine.stateId<Sluggish>(), std::chrono::milliseconds(1));
+		machine.attachWatchdog(&watchdog);
+
+		machine.update();
+
+		assert(watchdog.incidents().count() == 1);
+		assert(watchdog.incidents()[0].type		== M::Watchdog::Incident::Type::SlowCallback);
+		assert(watchdog.incidents()[0].state	== machine.stateId<Sluggish>());
+		assert(watchdog.incidents()[0].callback == M::Watchdog::Callback::Update);
+		assert(watchdog.incidents()[0].duration >= std::chrono::milliseconds(2));
+
+		// back to the global threshold
+		watchdog.threshold(machine.stateId<Sluggish>(), std::chrono::hours(0));
+		machine.update();
+		assert(watchdog.incidents().count() == 1);
+
+		machine.detachWatchdog();
+	}
+
+	{
+		M::PeerRoot<
+			M::Composite<Hasty,
+				Hasty_1
+			>,
+			Idle
+		> machine(_);
+
+		const Status created[] = {
+			status<Hasty>(Event::Enter),
+			status<Hasty_1>(Event::Enter),
+		};
+		_.assertHistory(created);
+
+		machine.update();
+
+		const Status update[] = {
+			status<Hasty>(Event::Update),
+			status<Hasty>(Event::Transition),
+			status<Idle>(Event::Restart),
+
+			status<Hasty_1>(Event::Leave),
+			status<Hasty>(Event::Leave),
+		};
+		_.assertHistory(update);
+
+		assert(machine.isActive<Idle>());
+	}
+
+	{
+		M::PeerRoot<
+			M::Composite<Patient,
+				Patient_1,
+				Patient_2
+			>,
+			M::Composite<Hasty,
+				Hasty_1
+			>
+		> machine(_);
+
+		const Status created[] = {
+			status<Patient>(Event::Enter),
+			status<Patient_1>(Event::Enter),
+		};
+		_.assertHistory(created);
+
+		machine.update();
+
+		const Status scheduled[] = {
+			status<Patient>(Event::Update),
+			status<Patient>(Event::Transition),
+			status<Hasty_1>(Event::Schedule),
+			status<Patient_1>(Event::Update),
+		};
+		_.assertHistory(scheduled);
+
+		machine.update();
+
+		const Status changed[] = {
+			status<Patient>(Event::Update),
+			status<Patient>(Event::Transition),
+			status<Patient_2>(Event::Restart),
+			status<Patient_1>(Event::Update),
+
+			status<Patient_2>(Event::Substitute),
+
+			status<Patient_1>(Event::Leave),
+			status<Patient_2>(Event::Enter),
+		};
+		_.assertHistory(changed);
+
+		assert(machine.isActive<Patient_2>());
+	}
+
+	const Status patientDestroyed[] = {
+		status<Patient_2>(Event::Leave),
+		status<Patient>(Event::Leave),
+	};
+	_.assertHistory(patientDestroyed);
+
+	{
+		M::PeerRoot<
+			Idle,
+			M::Composite<Shallow,
+				Shallow_1,
+				M::Composite<Shallow_2,
+					Shallow_2_1,
+					Shallow_2_2
+				>
+			>,
+			M::Composite<Forgetful,
+				Forgetful_1,
+				Forgetful_2
+			>
+		> machine(_);
+
+		machine.changeTo<Shallow_2_2>();
+		machine.update();
+		machine.changeTo<Idle>();
+		machine.update();
+
+		// Shallow_2 comes back, Shallow_2_2 doesn't
+		machine.resume<Shallow>();
+		machine.update();
+		assert(machine.isActive<Shallow_2>());
+		assert(machine.isActive<Shallow_2_1>());
+
+		machine.changeTo<Forgetful_2>();
+		machine.update();
+		machine.changeTo<Idle>();
+		machine.update();
+
+		machine.resume<Forgetful>();
+		machine.update();
+		assert(machine.isActive<Forgetful_1>());
+
+		// schedule() still sets the prong to resume
+		machine.changeTo<Idle>();
+		machine.update();
+		machine.schedule<Forgetful_2>();
+		machine.resume<Forgetful>();
+		machine.update();
+		assert(machine.isActive<Forgetful_2>());
+
+		// .. for the one resume() only
+		machine.changeTo<Idle>();
+		machine.update();
+		machine.resume<Forgetful>();
+		machine.update();
+		assert(machine.isActive<Forgetful_1>());
+	}
+
+	{
+		using Machine = M::Root<Blank,
+							M::Composite<Blank_1,
+								Blank_1_1,
+								Blank_1_2
+							>,
+							Blank_2
+						>;
+
+		// only the forks take room (the debug types add a copy to every node)
+	#if !defined _DEBUG || defined HFSM_ENABLE_FAST_DEBUG
+		static_assert(Machine::footprintOf<Blank_1_1>() == 0, "");
+		static_assert(Machine::footprintOf<Blank_1>()	== Machine::forkFootprint(), "");
+		static_assert(Machine::footprintOf<Blank>()		== Machine::forkFootprint() * 2, "");
+	#endif
+
+		Machine machine(_);
+		assert(machine.structure()[1].footprint == Machine::footprintOf<Blank_1>());
+
+		machine.changeTo<Blank_1_2>();
+		machine.update();
+		assert(machine.isActive<Blank_1_2>());
+	}
+
+	{
+		using Machine = M::PeerRoot<
+							Idle,
+							Scribbler
+						>;
+
+		// room for one arena only
+		M::ScratchBlockT<Machine::StateCount, 100> block;
+
+		Machine other(_);
+		other.attachScratch(&block);
+
+		{
+			Machine machine(_);
+			machine.attachScratch(&block);
+
+			machine.changeTo<Scribbler>();
+			machine.update();
+			assert(block.carved() == 64);
+
+			// 4 bytes, then 32 more at 8 .. 40, then no room for another 32, seen while still active
+			machine.update();
+			machine.update();
+			assert(block.highWater(other.stateId<Scribbler>()) == 40);
+
+			// the arena is reused
+			machine.changeTo<Idle>();
+			machine.update();
+			machine.changeTo<Scribbler>();
+			machine.update();
+			assert(block.carved() == 64);
+
+			// no room left, counted once however often the state is entered
+			other.changeTo<Scribbler>();
+			other.update();
+			other.update();
+			other.changeTo<Idle>();
+			other.update();
+			other.changeTo<Scribbler>();
+			other.update();
+			assert(block.carved() == 64);
+			assert(block.missed() == 1);
+		}
+
+		block.clearHighWaters();
+		assert(block.highWater(other.stateId<Scribbler>()) == 0);
+
+		// returned by the destroyed machine, and picked up on the next entry
+		other.changeTo<Idle>();
+		other.update();
+		other.changeTo<Scribbler>();
+		other.update();
+		other.update();
+		assert(block.carved() == 64);
+		assert(block.missed() == 1);
+		assert(block.highWater(other.stateId<Scribbler>()) == 40);
+	}
+
+	{
+		using Machine = M::PeerRoot<
+							Keeper,
+							Idle
+						>;
+
+		Machine machine(_);
+
+		// copied
+		const Parcel shared{ { 1, 2, 3 } };
+		assert(!machine.react(shared));
+		assert(_.parcel.size() == 3 && _.parcel.data() != shared.payload.data());
+
+		// taken over, and consumed
+		Parcel owned{ { 4, 5 } };
+		HSFM_IF_ASSERT(const int* const buffer = owned.payload.data());
+		assert(machine.react(std::move(owned)).consumer == machine.stateId<Keeper>());
+		assert(_.parcel.data() == buffer);
+
+		std::vector<int> payload{ 6, 7, 8, 9 };
+		HSFM_IF_ASSERT(const int* const emplaced = payload.data());
+		machine.emplace<Parcel>(Parcel{ std::move(payload) });
+		assert(_.parcel.data() == emplaced);
+
+		Machine::EventQueueT<256> queue;
+
+		std::vector<int> first { 10 };
+		std::vector<int> second{ 11, 12 };
+		HSFM_IF_ASSERT(const int* const queued = second.data());
+		assert(queue.emplace<Parcel>(Parcel{ std::move(first) }));
+		assert(queue.emplace<Parcel>(Parcel{ std::move(second) }));
+		assert(queue.count() == 2);
+
+		queue.dispatch(machine);
+		assert(queue.count() == 0);
+		assert(_.parcel.data() == queued);
+
+		// out of room
+		Machine::EventQueueT<32> small;
+		assert(!small.emplace<Parcel>());
+		assert(small.counters(0).dropped == 1);
+
+		// the higher lane jumps the line
+		Machine::EventQueueT<256, 2> lanes;
+		lanes.emplace<Signal>(Signal{ 1 });
+		lanes.emplace<Signal>(Signal{ 2 });
+		lanes.emplaceIn<Signal>(1, Signal{ 3 });
+		assert(lanes.count() == 3);
+
+		lanes.dispatch(machine);
+		assert((_.signals == std::vector<int>{ 3, 1, 2 }));
+		assert(lanes.counters(1).preempting == 1);
+		assert(lanes.counters(0).dispatched == 2);
+		assert(lanes.count() == 0);
+
+		// ..and transitions before the lower lane gets its turn
+		_.signals.clear();
+		lanes.emplace<Signal>(Signal{ 4 });
+		lanes.emplaceIn<Signal>(1, Signal{ -1 });
+
+		lanes.dispatch(machine);
+		assert((_.signals == std::vector<int>{ -1 }));
+		assert(machine.isActive<Idle>());
+		assert(lanes.counters(0).dispatched == 3);
+	}
+
+#ifdef HFSM_VARIANT_EVENTS
+	{
+		using Machine = M::PeerRoot<
+							Keeper,
+							Idle
+						>;
+		using Events = M::Events<std::monostate, Signal, Parcel>;
+
+		Machine machine(_);
+		_.signals.clear();
+
+		const Events signal{ Signal{ 5 } };
+		machine.react(signal);
+		assert((_.signals == std::vector<int>{ 5 }));
+
+		// taken over
+		Events parcel{ Parcel{ { 1, 2 } } };
+		HSFM_IF_ASSERT(const int* const buffer = std::get<Parcel>(parcel).payload.data());
+		machine.react(std::move(parcel));
+		assert(_.parcel.data() == buffer);
+
+		// nothing to react to
+		machine.react(Events{});
+		assert(_.signals.size() == 1);
+	}
+#endif
+
+#ifdef HFSM_ENABLE_LOG_INTERFACE
+	{
+		using Method = Recorder::Method;
+
+		Recorder recorder;
+
+		Filtered::PeerRoot<
+			Filtered::Composite<Quiet,
+				Quiet_1,
+				Filtered::Composite<Loud,
+					Loud_1,
+					Loud_2
+				>
+			>
+		> machine(_, &recorder);
+
+		// enter() is masked out
+		assert(recorder.entries.empty());
+
+		// Quiet_1 is outside the subtree
+		machine.update();
+		assert(recorder.entries.empty());
+
+		machine.changeTo<Loud_2>();
+		machine.update();
+		assert(recorder.entries.empty());
+
+		machine.update();
+		machine.react(Action{});
+
+		const Recorder::Entry filtered[] = {
+			Recorder::entry<Loud  >(Method::Update),
+			Recorder::entry<Loud_2>(Method::Update),
+			Recorder::entry<Loud  >(Method::React),
+			Recorder::entry<Loud_2>(Method::React),
+		};
+		recorder.assertEntries(filtered);
+	}
+
+	{
+		using Method = Recorder::Method;
+
+		Recorder recorder;
+
+		{
+			// everything, everywhere
+			M::PeerRoot<
+				M::Composite<Chatty<M, 0>,
+					Chatty<M, 1>,
+					Chatty<M, 2>
+				>
+			> machine(_, &recorder);
+
+			machine.changeTo<Chatty<M, 2>>();
+			machine.update();
+			machine.react(Action{});
+		}
+
+		const Recorder::Entry everywhere[] = {
+			Recorder::entry<Chatty<M, 0>>(Method::Enter),
+			Recorder::entry<Chatty<M, 1>>(Method::Enter),
+
+			Recorder::entry<Chatty<M, 0>>(Method::Update),
+			Recorder::entry<Chatty<M, 1>>(Method::Update),
+			Recorder::entry<Chatty<M, 1>>(Method::Leave),
+			Recorder::entry<Chatty<M, 2>>(Method::Enter),
+
+			Recorder::entry<Chatty<M, 0>>(Method::React),
+			Recorder::entry<Chatty<M, 2>>(Method::React),
+
+			Recorder::entry<Chatty<M, 2>>(Method::Leave),
+			Recorder::entry<Chatty<M, 0>>(Method::Leave),
+		};
+		recorder.assertEntries(everywhere);
+	}
+
+	{
+		using Policy = M::LogSampling::Policy;
+
+		// by machine enrollment index and tick
+		const M::LogSampling all;
+		const M::LogSampling ticks(Policy::Ticks, 2);
+		const M::LogSampling machines(Policy::Machines, 2);
+		const M::LogSampling never(Policy::Never);
+
+		assert( all.sample(1, 1));
+		assert( ticks.sample(1, 0) && !ticks.sample(1, 1) && ticks.sample(3, 2));
+		assert( machines.sample(0, 1) && !machines.sample(1, 0) && machines.sample(2, 3));
+		assert(!never.sample(0, 0));
+	}
+
+	{
+		using Method  = Recorder::Method;
+		using Policy  = M::LogSampling::Policy;
+		using Machine = M::PeerRoot<
+							Chatty<M, 0>,
+							Chatty<M, 1>
+						>;
+
+		Recorder recorder;
+
+		Machine first (_, &recorder);
+		Machine second(_, &recorder);
+		recorder.entries.clear();
+
+		// every other machine
+		M::LogSampling sampling(Policy::Machines, 2);
+		first .attachSampling(&sampling);
+		second.attachSampling(&sampling);
+
+		second.update();
+		assert(recorder.entries.empty());
+
+		first.update();
+
+		const Recorder::Entry sampled[] = {
+			Recorder::entry<Chatty<M, 0>>(Method::Update),
+		};
+		recorder.assertEntries(sampled);
+
+		// nothing logged, every transition offered to the reservoir
+		M::LogSamplingT<2> reservoir(Policy::Never);
+		first.attachSampling(&reservoir);
+
+		for (unsigned i = 0; i < 3; ++i) {
+			first.changeTo<Chatty<M, 1>>();
+			first.update();
+			first.changeTo<Chatty<M, 0>>();
+			first.update();
+		}
+		assert(recorder.entries.empty());
+
+		assert(reservoir.offered() == 6);
+		assert(reservoir.reservoir().count() == 2);
+
+		for (unsigned i = 0; i < reservoir.reservoir().count(); ++i)
+			assert((reservoir.reservoir()[i].stateType == hfsm::detail::TypeInfo::get<Chatty<M, 0>>() ||
+					reservoir.reservoir()[i].stateType == hfsm::detail::TypeInfo::get<Chatty<M, 1>>()));
+	}
+#endif
+
+	{
+		M::PeerRoot<
+			M::Orthogonal<Gate,
+				Gate_1,
+				Gate_2,
+				Gate_3
+			>
+		> machine(_);
+
+		const Status created[] = {
+			status<Gate>(Event::Enter),
+			status<Gate_1>(Event::Enter),
+			status<Gate_2>(Event::Enter),
+			status<Gate_3>(Event::Enter),
+		};
+		_.assertHistory(created);
+
+		// Gate_3 doesn't get to see it
+		HSFM_IF_ASSERT(const auto rootFirst = machine.react(Action{}));
+		assert(rootFirst && rootFirst.consumer == machine.stateId<Gate_2>());
+
+		const Status reactedRootFirst[] = {
+			status<Gate>(Event::ReactionRequest),
+			status<Gate>(Event::Reaction),
+			status<Gate_1>(Event::ReactionRequest),
+			status<Gate_1>(Event::Reaction),
+			status<Gate_2>(Event::ReactionRequest),
+			status<Gate_2>(Event::Reaction),
+		};
+		_.assertHistory(reactedRootFirst);
+
+		// ..neither does the head
+		machine.propagation(M::Propagation::LeafFirst);
+		machine.react(Action{});
+
+		const Status reactedLeafFirst[] = {
+			status<Gate_1>(Event::ReactionRequest),
+			status<Gate_1>(Event::Reaction),
+			status<Gate_2>(Event::ReactionRequest),
+			status<Gate_2>(Event::Reaction),
+		};
+		_.assertHistory(reactedLeafFirst);
+	}
+
 	return 0;
 }
 
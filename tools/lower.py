@@ -0,0 +1,638 @@
+################################################################################
+#
+# lowers an HFSM hierarchy to a standalone, switch-based machine
+#
+# usage: python3 lower.py <hierarchy> <output header>
+#
+# the hierarchy lists the state types, one per line, nested with tabs,
+# in the same order as in the M::Root<> / M::Composite<> / M::Orthogonal<> declaration
+# (and as listed by the structure report):
+#
+#	machine Lowered M Engine			# the generated class, the hfsm::Machine<> alias,
+#										# and optionally the M::Root<> the hierarchy is checked against
+#	composite M::Base					# root region, 'M::Base' for peer regions
+#		Idle
+#		orthogonal Active
+#			Left
+#			Right
+#
+# the generated class calls into the same user state classes,
+# in the same order as the template engine does
+#
+################################################################################
+
+import sys
+
+################################################################################
+
+class Node:
+	def __init__(self, kind, head):
+		self.kind = kind			# 'state', 'composite' or 'orthogonal'
+		self.head = head
+		self.children = []
+		self.state = None			# pre-order id, as in the template engine
+		self.fork = None			# pre-order fork id, regions only
+		self.end = None				# one past the last of the sub-states' ids
+		self.parent = None			# (fork, prong)
+
+	def isRegion(self):
+		return self.kind != 'state'
+
+#-------------------------------------------------------------------------------
+
+def parse(path):
+	name, machine, engine, root = None, None, None, None
+	stack = []
+
+	with open(path, 'r', encoding='utf-8') as input:
+		for number, line in enumerate(input, 1):
+			text = line.split('#')[0].rstrip()
+			if not text.strip():
+				continue
+
+			tokens = text.split()
+			if tokens[0] == 'machine':
+				if len(tokens) not in (3, 4):
+					sys.exit("%s:%d: expected 'machine <class> <alias> [<engine>]'" % (path, number))
+				name, machine = tokens[1], tokens[2]
+				engine = tokens[3] if len(tokens) == 4 else None
+				continue
+
+			depth = len(text) - len(text.lstrip('\t'))
+			node = Node(tokens[0], tokens[1]) if tokens[0] in ('composite', 'orthogonal') else Node('state', tokens[0])
+
+			del stack[depth:]
+			if depth == 0:
+				if root:
+					sys.exit("%s:%d: a second root" % (path, number))
+				root = node
+			elif depth == len(stack) and stack[-1].isRegion():
+				stack[-1].children.append(node)
+			else:
+				sys.exit("%s:%d: unexpected indentation" % (path, number))
+
+			stack.append(node)
+
+	if not name or not root or not root.isRegion():
+		sys.exit("%s: needs a 'machine' line and a composite / orthogonal root" % path)
+
+	return name, machine, engine, root
+
+#-------------------------------------------------------------------------------
+
+def number(root):
+	states, forks = [], []
+
+	def visit(node):
+		node.state = len(states)
+		states.append(node)
+
+		if node.isRegion():
+			node.fork = len(forks)
+			forks.append(node)
+
+			for prong, child in enumerate(node.children):
+				child.parent = (node.fork, prong)
+				visit(child)
+
+		node.end = len(states)
+
+	visit(root)
+	return states, forks
+
+################################################################################
+
+class Writer:
+	def __init__(self):
+		self.lines = []
+
+	def __call__(self, indent, text = ''):
+		self.lines.append('\t' * indent + text if text else '')
+
+#-------------------------------------------------------------------------------
+
+# node methods, mirroring _S / _C / _O and their Sub<>s
+
+def emitState(w, n):
+	s, h = n.state, '_s%d' % n.state
+
+	w(1, '// %s' % n.head)
+	w(1, 'bool substituteHead%d(Control& control) {' % s)
+	w(2, 'const unsigned requestCountBefore = control.requestCount();')
+	w(2, '%s.widePreSubstitute(_context);' % h)
+	w(2, '%s.substitute(control, _context);' % h)
+	w(2, 'return requestCountBefore < control.requestCount();')
+	w(1, '}')
+	w(1, 'void enterHead%d() {' % s)
+	w(2, '%s.widePreEnter(_context);' % h)
+	w(2, '%s.enter(_context);' % h)
+	w(1, '}')
+	w(1, 'bool updateAndTransitionHead%d(Control& control) {' % s)
+	w(2, '%s.widePreUpdate(_context);' % h)
+	w(2, '%s.update(_context);' % h)
+	w(2, 'const unsigned requestCountBefore = control.requestCount();')
+	w(2, '%s.widePreTransition(_context);' % h)
+	w(2, '%s.transition(control, _context);' % h)
+	w(2, 'return requestCountBefore < control.requestCount();')
+	w(1, '}')
+	w(1, 'void updateHead%d() {' % s)
+	w(2, '%s.widePreUpdate(_context);' % h)
+	w(2, '%s.update(_context);' % h)
+	w(1, '}')
+	w(1, 'template <typename TEvent>')
+	w(1, 'void reactHead%d(TEvent& event, Control& control) {' % s)
+	w(2, '%s.widePreReact(event, _context);' % h)
+	w(2, '%s.react(static_cast<PassedEvent<%s, TEvent>>(event), control, _context);' % (h, n.head))
+	w(2, 'if (takesOver<%s, TEvent>())' % n.head)
+	w(3, 'control.consume();')
+	w(2, 'reacted(control, %d);' % s)
+	w(1, '}')
+	w(1, 'void leaveHead%d() {' % s)
+	w(2, '%s.leave(_context);' % h)
+	w(2, '%s.widePostLeave(_context);' % h)
+	w(1, '}')
+	w(1)
+
+# - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+def prongSwitch(w, indent, n, selector, call):
+	w(indent, 'switch (%s) {' % selector)
+	for prong, child in enumerate(n.children):
+		w(indent, 'case %d: %s; break;' % (prong, call(child)))
+	w(indent, 'default: assert(false);')
+	w(indent, '}')
+
+def everyProng(w, indent, n, call):
+	for child in n.children:
+		w(indent, '%s;' % call(child))
+
+# skips the regions past the one consuming the event, as the template engine does
+def reactChildren(w, indent, n, composite, f):
+	if composite:
+		prongSwitch(w, indent, n, f + '.active', lambda c: 'react%d(event, control)' % c.state)
+	else:
+		for i, child in enumerate(n.children):
+			if i:
+				w(indent, 'if (!control.consumed())')
+				w(indent + 1, 'react%d(event, control);' % child.state)
+			else:
+				w(indent, 'react%d(event, control);' % child.state)
+
+# - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+def emitNode(w, n):
+	s = n.state
+	emitState(w, n)
+
+	if not n.isRegion():
+		w(1, 'bool substitute%d(Control& control)				{ return substituteHead%d(control);			}' % (s, s))
+		w(1, 'void enterInitial%d(Control&)					{ enterHead%d();							}' % (s, s))
+		w(1, 'void enter%d(Control&)						{ enterHead%d();							}' % (s, s))
+		w(1, 'bool updateAndTransition%d(Control& control)	{ return updateAndTransitionHead%d(control);	}' % (s, s))
+		w(1, 'void update%d(Control&)						{ updateHead%d();							}' % (s, s))
+		w(1, 'template <typename TEvent>')
+		w(1, 'void react%d(TEvent& event, Control& control)	{ reactHead%d(event, control);		}' % (s, s))
+		w(1, 'void leave%d(Control&)						{ leaveHead%d();							}' % (s, s))
+		w(1, 'void forwardSubstitute%d(Control&)			{}' % s)
+		w(1, 'void forwardRequest%d(const TransitionType)	{}' % s)
+		w(1, 'void requestRemain%d()						{}' % s)
+		w(1, 'void requestRestart%d()						{}' % s)
+		w(1, 'void requestResume%d()						{}' % s)
+		w(1, 'void changeToRequested%d(Control&)			{}' % s)
+		w(1)
+		return
+
+	f = '_forks[%d]' % n.fork
+	composite = n.kind == 'composite'
+
+	w(1, 'void forwardSubstitute%d(Control& control) {' % s)
+	if composite:
+		w(2, 'assert(%s.requested != INVALID);' % f)
+		w(2, 'if (%s.requested == %s.active) {' % (f, f))
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'forwardSubstitute%d(control)' % c.state)
+		w(2, '} else {')
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'substitute%d(control)' % c.state)
+		w(2, '}')
+	else:
+		w(2, 'if (%s.requested != INVALID) {' % f)
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'forwardSubstitute%d(control)' % c.state)
+		w(2, '} else {')
+		everyProng(w, 3, n, lambda c: 'forwardSubstitute%d(control)' % c.state)
+		w(2, '}')
+	w(1, '}')
+
+	w(1, 'void substitute%d(Control& control) {' % s)
+	w(2, 'if (!substituteHead%d(control)) {' % s)
+	if composite:
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'substitute%d(control)' % c.state)
+	else:
+		everyProng(w, 3, n, lambda c: 'substitute%d(control)' % c.state)
+	w(2, '}')
+	w(1, '}')
+
+	w(1, 'void enterInitial%d(Control& control) {' % s)
+	if composite:
+		w(2, '%s.active = 0;' % f)
+		w(2, 'enterHead%d();' % s)
+		w(2, 'enterInitial%d(control);' % n.children[0].state)
+	else:
+		w(2, 'enterHead%d();' % s)
+		everyProng(w, 2, n, lambda c: 'enterInitial%d(control)' % c.state)
+	w(1, '}')
+
+	w(1, 'void enter%d(Control& control) {' % s)
+	if composite:
+		w(2, '%s.active = %s.requested;' % (f, f))
+		w(2, '%s.requested = INVALID;' % f)
+		w(2, 'enterHead%d();' % s)
+		prongSwitch(w, 2, n, f + '.active', lambda c: 'enter%d(control)' % c.state)
+	else:
+		w(2, 'enterHead%d();' % s)
+		everyProng(w, 2, n, lambda c: 'enter%d(control)' % c.state)
+	w(1, '}')
+
+	w(1, 'bool updateAndTransition%d(Control& control) {' % s)
+	w(2, 'const unsigned requestCountBefore = control.requestCount();')
+	w(2, 'if (updateAndTransitionHead%d(control)) {' % s)
+	w(3, 'if (!skipsObsoleteUpdates<%s>() ||' % n.head)
+	w(4, '!leaves(control, requestCountBefore, StateRange{%d, %d}, &stateId))' % (s, n.end))
+	w(3, '{')
+	if composite:
+		prongSwitch(w, 4, n, f + '.active', lambda c: 'update%d(control)' % c.state)
+	else:
+		everyProng(w, 4, n, lambda c: 'update%d(control)' % c.state)
+	w(3, '}')
+	w(3, 'return true;')
+	w(2, '}')
+	if composite:
+		w(2, 'switch (%s.active) {' % f)
+		for prong, child in enumerate(n.children):
+			w(2, 'case %d: return updateAndTransition%d(control);' % (prong, child.state))
+		w(2, 'default: assert(false); return false;')
+		w(2, '}')
+	else:
+		# short-circuits, as in the template engine
+		w(2, 'return %s;' % '\n\t\t\t|| '.join('updateAndTransition%d(control)' % c.state for c in n.children))
+	w(1, '}')
+
+	w(1, 'void update%d(Control& control) {' % s)
+	w(2, 'updateHead%d();' % s)
+	if composite:
+		prongSwitch(w, 2, n, f + '.active', lambda c: 'update%d(control)' % c.state)
+	else:
+		everyProng(w, 2, n, lambda c: 'update%d(control)' % c.state)
+	w(1, '}')
+
+	w(1, 'template <typename TEvent>')
+	w(1, 'void react%d(TEvent& event, Control& control) {' % s)
+	w(2, 'if (leafFirst(control)) {')
+	reactChildren(w, 3, n, composite, f)
+	w(3, 'if (!control.consumed())')
+	w(4, 'reactHead%d(event, control);' % s)
+	w(2, '} else {')
+	w(3, 'reactHead%d(event, control);' % s)
+	w(3, 'if (!control.consumed()) {')
+	reactChildren(w, 4, n, composite, f)
+	w(3, '}')
+	w(2, '}')
+	w(1, '}')
+
+	w(1, 'void leave%d(Control& control) {' % s)
+	if composite:
+		prongSwitch(w, 2, n, f + '.active', lambda c: 'leave%d(control)' % c.state)
+		w(2, 'leaveHead%d();' % s)
+		w(2, 'if (historyOf<%s>() != History::None)' % n.head)
+		w(3, '%s.resumable = %s.active;' % (f, f))
+		w(2, '%s.active = INVALID;' % f)
+	else:
+		everyProng(w, 2, n, lambda c: 'leave%d(control)' % c.state)
+		w(2, 'leaveHead%d();' % s)
+	w(1, '}')
+
+	w(1, 'void forwardRequest%d(const TransitionType transition) {' % s)
+	w(2, 'if (%s.requested != INVALID) {' % f)
+	if composite:
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'forwardRequest%d(transition)' % c.state)
+	else:
+		w(3, 'const unsigned requested = %s.requested;' % f)
+		for prong, child in enumerate(n.children):
+			w(3, 'forwardRequest%d(requested == %d ? transition : Transition::Remain);' % (child.state, prong))
+	w(2, '} else')
+	w(3, 'switch (transition) {')
+	w(3, 'case Transition::Remain:  requestRemain%d();  break;' % s)
+	w(3, 'case Transition::Restart: requestRestart%d(); break;' % s)
+	w(3, 'case Transition::Resume:  requestResume%d();  break;' % s)
+	w(3, 'default: assert(false);')
+	w(3, '}')
+	w(1, '}')
+
+	w(1, 'void requestRemain%d() {' % s)
+	if composite:
+		w(2, 'if (%s.active == INVALID)' % f)
+		w(3, '%s.requested = 0;' % f)
+		w(2, 'requestRemain%d();' % n.children[0].state)
+	else:
+		everyProng(w, 2, n, lambda c: 'requestRemain%d()' % c.state)
+	w(1, '}')
+
+	w(1, 'void requestRestart%d() {' % s)
+	if composite:
+		w(2, '%s.requested = 0;' % f)
+		w(2, 'requestRestart%d();' % n.children[0].state)
+	else:
+		everyProng(w, 2, n, lambda c: 'requestRestart%d()' % c.state)
+	w(1, '}')
+
+	w(1, 'void requestResume%d() {' % s)
+	if composite:
+		w(2, '%s.requested = %s.resumable != INVALID ? %s.resumable : 0;' % (f, f, f))
+		w(2, 'if (historyOf<%s>() == History::None)' % n.head)
+		w(3, '%s.resumable = INVALID;' % f)
+		w(2, 'if (historyOf<%s>() == History::Deep) {' % n.head)
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'requestResume%d()' % c.state)
+		w(2, '} else {')
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'forwardRequest%d(Transition::Restart)' % c.state)
+		w(2, '}')
+	else:
+		everyProng(w, 2, n, lambda c: 'requestResume%d()' % c.state)
+	w(1, '}')
+
+	w(1, 'void changeToRequested%d(Control& control) {' % s)
+	if composite:
+		w(2, 'if (%s.requested == %s.active) {' % (f, f))
+		prongSwitch(w, 3, n, f + '.requested', lambda c: 'changeToRequested%d(control)' % c.state)
+		w(2, '} else if (%s.requested != INVALID) {' % f)
+		prongSwitch(w, 3, n, f + '.active', lambda c: 'leave%d(control)' % c.state)
+		w(3, 'if (historyOf<%s>() != History::None)' % n.head)
+		w(4, '%s.resumable = %s.active;' % (f, f))
+		w(3, '%s.active = %s.requested;' % (f, f))
+		w(3, '%s.requested = INVALID;' % f)
+		prongSwitch(w, 3, n, f + '.active', lambda c: 'enter%d(control)' % c.state)
+		w(2, '}')
+	else:
+		everyProng(w, 2, n, lambda c: 'changeToRequested%d(control)' % c.state)
+	w(1, '}')
+	w(1)
+
+	for child in n.children:
+		emitNode(w, child)
+
+################################################################################
+
+# from the apex down to the state, as (fork, prong) pairs
+def pathOf(node, forks):
+	path = []
+	parent = node.parent
+	while parent:
+		path.append(parent)
+		parent = forks[parent[0]].parent
+
+	return path[::-1]
+
+#-------------------------------------------------------------------------------
+
+# the state ids and fork paths have to match the template engine's,
+# otherwise the hierarchy file has drifted from the M::Root<> declaration
+def emitChecks(w, engine, machine, states, forks, source):
+	message = '"%s is out of sync with %s"' % (source, engine)
+
+	w(0, 'static_assert(%s::StateCount == %d, %s);' % (engine, len(states), message))
+	w(0, 'static_assert(%s::ForkCount  == %d, %s);' % (engine, len(forks), message))
+	w(0)
+
+	for n in states:
+		# peer regions share M::Base, which doesn't identify a state
+		if n.head == machine + '::Base':
+			continue
+
+		path = pathOf(n, forks)
+		checks = ['%s::stateIndex<%s>() == %d' % (engine, n.head, n.state),
+				  '%s::pathOf<%s>().count == %d' % (engine, n.head, len(path))]
+		for i, (fork, prong) in enumerate(path):
+			checks.append('%s::pathOf<%s>()[%d].fork == %d' % (engine, n.head, i, fork))
+			checks.append('%s::pathOf<%s>()[%d].prong == %d' % (engine, n.head, i, prong))
+
+		w(0, 'static_assert(%s,' % '\n\t\t\t  && '.join(checks))
+		w(3, '  %s);' % message)
+	w(0)
+	w(0, '////////////////////////////////////////////////////////////////////////////////')
+	w(0)
+
+#-------------------------------------------------------------------------------
+
+def emit(name, machine, engine, root, source):
+	states, forks = number(root)
+	w = Writer()
+
+	w(0, '// generated by tools/lower.py from %s, do not edit' % source)
+	w(0)
+	w(0, '#pragma once')
+	w(0)
+	w(0, '#include <assert.h>')
+	w(0, '#include <stdint.h>')
+	w(0)
+	w(0, '#include <type_traits>')
+	w(0, '#include <utility>')
+	w(0)
+	w(0, '////////////////////////////////////////////////////////////////////////////////')
+	w(0)
+	if engine:
+		emitChecks(w, engine, machine, states, forks, source)
+	w(0, 'class %s final' % name)
+	w(1, ': public %s::LoweredT<%d>' % (machine, len(forks)))
+	w(0, '{')
+	w(1, 'using Context = %s::Context;' % machine)
+	w(1, 'using Control = %s::Control;' % machine)
+	w(1, 'using TransitionType = typename Transition::Type;')
+	w(1)
+	w(1, 'enum : uint8_t { INVALID = 0xFF };')
+	w(1)
+	w(1, 'struct Fork {')
+	w(2, 'uint8_t active	= INVALID;')
+	w(2, 'uint8_t resumable = INVALID;')
+	w(2, 'uint8_t requested = INVALID;')
+	w(1, '};')
+	w(1)
+	w(0, 'public:')
+	w(1, 'enum : unsigned {')
+	w(2, 'StateCount = %d,' % len(states))
+	w(2, 'ForkCount  = %d,' % len(forks))
+	w(1, '};')
+	w(1)
+	w(1, '%s(Context& context)' % name)
+	w(2, ': _context(context)')
+	w(1, '{')
+	w(2, 'auto control = this->control();')
+	w(2, 'enterInitial0(control);')
+	w(1, '}')
+	w(1)
+	w(1, '~%s() {' % name)
+	w(2, 'auto control = this->control();')
+	w(2, 'leave0(control);')
+	w(1, '}')
+	w(1)
+	w(1, 'void update() {')
+	w(2, 'auto control = this->control();')
+	w(2, 'updateAndTransition0(control);')
+	w(1)
+	w(2, 'if (_requests.count())')
+	w(3, 'processTransitions();')
+	w(1, '}')
+	w(1)
+	w(1, 'template <typename TEvent>')
+	w(1, 'Reaction react(const TEvent& event)	{ return dispatch(event);	}')
+	w(1)
+	w(1, 'template <typename TEvent, typename = typename std::enable_if<!std::is_reference<TEvent>::value>::type>')
+	w(1, 'Reaction react(TEvent&& event)		{ return dispatch(event);	}')
+	w(1)
+	w(1, 'template <typename TEvent, typename... TArgs>')
+	w(1, 'Reaction emplace(TArgs&&... args) {')
+	w(2, 'TEvent event(std::forward<TArgs>(args)...);')
+	w(2, 'return dispatch(event);')
+	w(1, '}')
+	w(1)
+	w(1, 'template <typename T>')
+	w(1, 'void changeTo()	{ _requests << Transition(Transition::Restart,  TypeInfo::get<T>());	}')
+	w(1)
+	w(1, 'template <typename T>')
+	w(1, 'void resume()		{ _requests << Transition(Transition::Resume,   TypeInfo::get<T>());	}')
+	w(1)
+	w(1, 'template <typename T>')
+	w(1, 'void schedule()	{ _requests << Transition(Transition::Schedule, TypeInfo::get<T>());	}')
+	w(1)
+	w(1, 'template <typename T>')
+	w(1, 'bool isActive() const {')
+	w(2, 'switch (stateId(TypeInfo::get<T>())) {')
+	for n in states:
+		# the closest composite ancestor decides, as in the template engine
+		checks = []
+		node, parent = n, n.parent
+		while parent:
+			fork, prong = parent
+			if forks[fork].kind == 'composite':
+				checks.append('_forks[%d].active == %d' % (fork, prong))
+				break
+			parent = forks[fork].parent
+		w(2, 'case %d: return %s;' % (n.state, checks[0] if checks else 'false'))
+	w(2, 'default: assert(false); return false;')
+	w(2, '}')
+	w(1, '}')
+	w(1)
+	w(0, 'private:')
+	w(1, '// TEvent is const, unless the event was passed as an rvalue')
+	w(1, 'template <typename TEvent>')
+	w(1, 'Reaction dispatch(TEvent& event) {')
+	w(2, 'auto control = reactControl();')
+	w(2, 'react0(event, control);')
+	w(1)
+	w(2, 'if (_requests.count())')
+	w(3, 'processTransitions();')
+	w(1)
+	w(2, 'return reaction(control);')
+	w(1, '}')
+	w(1)
+	w(1, 'static unsigned stateId(const TypeInfo type) {')
+	for n in states:
+		if n.head != machine + '::Base':
+			w(2, 'if (type == TypeInfo::get<%s>()) return %d;' % (n.head, n.state))
+	w(1)
+	w(2, 'assert(false);')
+	w(2, 'return 0;')
+	w(1, '}')
+	w(1)
+	w(1, 'void processTransitions() {')
+	w(2, 'SubstitutionHistory history;')
+	w(1)
+	w(2, 'for (unsigned i = 0;')
+	w(3, 'i < MaxSubstitutions && _requests.count();')
+	w(3, '++i)')
+	w(2, '{')
+	w(3, 'unsigned changeCount = 0;')
+	w(1)
+	w(3, 'for (const auto& request : _requests) {')
+	w(4, 'switch (request.type) {')
+	w(4, 'case Transition::Restart:')
+	w(4, 'case Transition::Resume:')
+	w(5, 'requestImmediate(request);')
+	w(1)
+	w(5, '++changeCount;')
+	w(5, 'break;')
+	w(1)
+	w(4, 'case Transition::Schedule:')
+	w(5, 'requestScheduled(request);')
+	w(5, 'break;')
+	w(1)
+	w(4, 'default:')
+	w(5, 'assert(false);')
+	w(4, '}')
+	w(3, '}')
+	w(3, '_requests.clear();')
+	w(1)
+	w(3, 'if (changeCount > 0) {')
+	w(4, 'auto substitutionControl = control();')
+	w(4, 'forwardSubstitute0(substitutionControl);')
+	w(1)
+	# same cycle rule as the template engine
+	w(4, 'if (_requests.count()) {')
+	w(5, 'auto* const requested = history.pending();')
+	w(5, 'for (unsigned f = 0; f < ForkCount; ++f)')
+	w(6, 'requested[f] = _forks[f].requested;')
+	w(1)
+	w(5, 'if (!history.record())')
+	w(6, '_requests.clear();')
+	w(4, '}')
+	w(3, '}')
+	w(2, '}')
+	w(1)
+	w(2, 'auto control = this->control();')
+	w(2, 'changeToRequested0(control);')
+	w(1, '}')
+	w(1)
+	w(1, '// marks the path down to the state, then forwards the request from the top')
+	w(1, 'void requestImmediate(const Transition& request) {')
+	w(2, 'switch (stateId(request.stateType)) {')
+	for n in states:
+		path = ['_forks[%d].requested = %d;' % step for step in pathOf(n, forks)[::-1]]
+		w(2, 'case %d: %sbreak;' % (n.state, ' '.join(path) + ' ' if path else ''))
+	w(2, 'default: assert(false);')
+	w(2, '}')
+	w(1)
+	w(2, 'forwardRequest0(request.type);')
+	w(1, '}')
+	w(1)
+	w(1, 'void requestScheduled(const Transition& request) {')
+	w(2, 'switch (stateId(request.stateType)) {')
+	for n in states:
+		if n.parent:
+			w(2, 'case %d: _forks[%d].resumable = %d; break;' % (n.state, n.parent[0], n.parent[1]))
+	w(2, 'default: assert(false);')
+	w(2, '}')
+	w(1, '}')
+	w(1)
+	w(1, '//----------------------------------------------------------------------')
+	w(1)
+	emitNode(w, root)
+	w(1, '//----------------------------------------------------------------------')
+	w(1)
+	w(1, 'Context& _context;')
+	w(1, 'Fork _forks[ForkCount];')
+	w(1)
+	for n in states:
+		w(1, '%s _s%d;' % (n.head, n.state))
+	w(0, '};')
+	w(0)
+	w(0, '////////////////////////////////////////////////////////////////////////////////')
+
+	return '\n'.join(w.lines) + '\n'
+
+################################################################################
+
+if len(sys.argv) != 3:
+	sys.exit("usage: lower.py <hierarchy> <output header>")
+
+name, machine, engine, root = parse(sys.argv[1])
+
+with open(sys.argv[2], 'w', encoding='utf-8') as output:
+	output.write(emit(name, machine, engine, root, sys.argv[1].replace('\\', '/').split('/')[-1]))
+
+################################################################################